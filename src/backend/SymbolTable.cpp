@@ -147,13 +147,12 @@ void SymbolTable::leaveBlock() {
     variables.pop_front();
 
     // Restore next variable address
-    unsigned int maxLocalVariableAddress = 0u;
+    nextLocalVariableAddress = 0u;
     for (const auto& block : variables) {
         for (const auto& symbol : block) {
-            maxLocalVariableAddress = std::max(maxLocalVariableAddress, symbol.second->address); // TODO: Improve by saving last addresses in separate list?
+            nextLocalVariableAddress = std::max(nextLocalVariableAddress, symbol.second->address + VARIABLE_SIZE_IN_BYTES); // TODO: Improve by saving last addresses in separate list?
         }
     }
-    nextLocalVariableAddress = maxLocalVariableAddress + VARIABLE_SIZE_IN_BYTES;
 }
 
 static inline char* copyName(const char* name) {
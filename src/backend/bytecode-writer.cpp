@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @brief Implementation of writer of IR in the binary format of the stack machine
+ */
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include "bytecode-writer.h"
+#include "ir.h"
+#include "../stack-machine/src/stack-machine-utils.h"
+
+static unsigned char getMachineOpcode(IROpcode opcode) {
+    switch (opcode) {
+        case IR_PUSH:            return PUSH_OPCODE;
+        case IR_PUSH_REG:        return PUSHR_OPCODE;
+        case IR_PUSH_RAM:        return PUSHM_OPCODE;
+        case IR_PUSH_RAM_BY_REG: return PUSHRM_OPCODE;
+        case IR_POP:             return POP_OPCODE;
+        case IR_POP_REG:         return POPR_OPCODE;
+        case IR_POP_RAM:         return POPM_OPCODE;
+        case IR_POP_RAM_BY_REG:  return POPRM_OPCODE;
+        case IR_DUP:             return DUP_OPCODE;
+        case IR_ADD:             return ADD_OPCODE;
+        case IR_SUB:             return SUB_OPCODE;
+        case IR_MUL:             return MUL_OPCODE;
+        case IR_DIV:             return DIV_OPCODE;
+        case IR_IN:              return IN_OPCODE;
+        case IR_OUT:             return OUT_OPCODE;
+        case IR_SQRT:            return SQRT_OPCODE;
+        case IR_POW:             return POW_OPCODE;
+        case IR_JMP:             return JMP_OPCODE;
+        case IR_JMPL:            return JMPL_OPCODE;
+        case IR_JMPLE:           return JMPLE_OPCODE;
+        case IR_JMPG:            return JMPG_OPCODE;
+        case IR_JMPGE:           return JMPGE_OPCODE;
+        case IR_JMPE:            return JMPE_OPCODE;
+        case IR_JMPNE:           return JMPNE_OPCODE;
+        case IR_CALL:            return CALL_OPCODE;
+        case IR_RET:             return RET_OPCODE;
+        case IR_HLT:             return HLT_OPCODE;
+        default:                 throw std::logic_error("Instruction can't be encoded");
+    }
+}
+
+static inline bool hasLabelOperand(const Instruction& instruction) {
+    return instruction.isJump() || instruction.opcode == IR_CALL;
+}
+
+static inline bool hasRegisterOperand(const Instruction& instruction) {
+    return instruction.opcode == IR_PUSH_REG || instruction.opcode == IR_PUSH_RAM_BY_REG ||
+           instruction.opcode == IR_POP_REG  || instruction.opcode == IR_POP_RAM_BY_REG;
+}
+
+static inline bool hasImmediateOperand(const Instruction& instruction) {
+    return instruction.opcode == IR_PUSH || instruction.opcode == IR_PUSH_RAM || instruction.opcode == IR_POP_RAM;
+}
+
+static int getEncodedSize(const Instruction& instruction) {
+    if (instruction.opcode == IR_LABEL) return 0;
+    if (hasLabelOperand(instruction)) return sizeof(unsigned char) + sizeof(int);
+    if (hasRegisterOperand(instruction)) return sizeof(unsigned char) + sizeof(unsigned char);
+    if (hasImmediateOperand(instruction)) return sizeof(unsigned char) + sizeof(double);
+    return sizeof(unsigned char);
+}
+
+int writeBytecode(const IRProgram& program, const char* fileName) {
+    const std::vector<Instruction>& code = program.getInstructions();
+
+    // Labels are resolved before writing, because jumps forward need offsets of the following code
+    std::map<unsigned int, int> labelOffsets;
+    int offset = 0;
+    for (const Instruction& instruction : code) {
+        if (instruction.opcode == IR_LABEL) labelOffsets[instruction.labelId] = offset;
+        offset += getEncodedSize(instruction);
+    }
+
+    FILE* file = fopen(fileName, "wb");
+    if (file == nullptr) return ERR_INVALID_FILE;
+
+    int currentByteOffset = 0;
+    for (const Instruction& instruction : code) {
+        if (instruction.opcode == IR_LABEL) continue;
+
+        asmWrite(file, getMachineOpcode(instruction.opcode), currentByteOffset);
+        if (hasLabelOperand(instruction)) {
+            const auto target = labelOffsets.find(instruction.labelId);
+            if (target == labelOffsets.end()) {
+                fclose(file);
+                return ERR_INVALID_LABEL;
+            }
+            // Offset is relative to the position of the offset itself
+            asmWrite(file, target->second - currentByteOffset, currentByteOffset);
+        } else if (hasRegisterOperand(instruction)) {
+            asmWrite(file, getRegisterNumberByName(RegisterStrings[instruction.reg]), currentByteOffset);
+        } else if (hasImmediateOperand(instruction)) {
+            asmWrite(file, instruction.immediate, currentByteOffset);
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
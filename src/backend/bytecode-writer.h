@@ -0,0 +1,19 @@
+/**
+ * @file
+ * @brief Definition of writer of IR in the binary format of the stack machine
+ */
+#ifndef COMPILER_BYTECODE_WRITER_H
+#define COMPILER_BYTECODE_WRITER_H
+
+#include "ir.h"
+
+/**
+ * Writes the program in the binary format of the stack machine, so it can be run without assembling the text IR.
+ * Instructions are encoded the same way as the stack machine assembler does: opcode, then register number, immediate
+ * or relative offset of the jump target. Immediates are written without loss of precision.
+ * @param fileName name of the file to write binary code to
+ * @return 0 on success or error code of the stack machine (see printErrorMessageForExitCode)
+ */
+int writeBytecode(const IRProgram& program, const char* fileName);
+
+#endif // COMPILER_BYTECODE_WRITER_H
@@ -2,10 +2,16 @@
  * @file
  * @brief Implementation of IR code generation functions
  */
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
 #include "codegen.h"
+#include "ir.h"
 #include "Label.h"
 #include "SymbolTable.h"
+#include "../util/comparison.h"
 #include "../util/constants.h"
 #include "../util/CoercionError.h"
 #include "../util/SyntaxError.h"
@@ -26,12 +32,95 @@ static inline bool returnsNonVoid(const std::shared_ptr<ASTNode>& node, const Sy
         !symbolTable.getFunctionByName(dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName())->isVoid()
     );
 }
+/**
+ * Returns the first node, whose value is pushed onto the stack during the statement evaluation, or nullptr, if it's unknown.
+ */
+static const ASTNode* getFirstEvaluatedNode(const std::shared_ptr<ASTNode>& node) {
+    switch (node->getType()) {
+        case NodeType::VALUE_NODE:
+            return node.get();
+        case NodeType::OPERATOR_NODE:
+        case NodeType::COMPARISON_OPERATOR_NODE:
+        case NodeType::RETURN_STATEMENT_NODE:
+        case NodeType::IF_NODE:
+        case NodeType::IF_ELSE_NODE:
+            return getFirstEvaluatedNode(node->getChildren()[0]);
+        case NodeType::ASSIGNMENT_OPERATOR_NODE:
+        case NodeType::VALUE_DECLARATION_NODE:
+            return getFirstEvaluatedNode(node->getChildren()[1]);
+        case NodeType::VARIABLE_DECLARATION_NODE:
+            return node->getChildrenNumber() == 2 ? getFirstEvaluatedNode(node->getChildren()[1]) : nullptr;
+        case NodeType::FUNCTION_CALL_NODE: {
+            // Arguments are evaluated in the reverse order
+            const auto& arguments = node->getChildren()[0];
+            const size_t argumentsNumber = arguments->getChildrenNumber();
+            return argumentsNumber == 0 ? nullptr : getFirstEvaluatedNode(arguments->getChildren()[argumentsNumber - 1]);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Checks if the statement stores the value, that is read first by the next statement.
+ */
+static inline bool isForwardable(const std::shared_ptr<ASTNode>& statement, const std::shared_ptr<ASTNode>& nextStatement) {
+    const NodeType nodeType = statement->getType();
+    const bool isStore = (
+        nodeType == NodeType::ASSIGNMENT_OPERATOR_NODE ||
+        nodeType == NodeType::VARIABLE_DECLARATION_NODE ||
+        nodeType == NodeType::VALUE_DECLARATION_NODE
+    );
+    if (!isStore) return false;
+
+    const ASTNode* variable = statement->getChildren()[0].get();
+    const char* variableName = (variable->getType() == NodeType::VARIABLE_NODE) ?
+        dynamic_cast<const VariableNode*>(variable)->getName() :
+        dynamic_cast<const ValueNode*>(variable)->getName();
+
+    const ASTNode* read = getFirstEvaluatedNode(nextStatement);
+    return read != nullptr && strcmp(dynamic_cast<const ValueNode*>(read)->getName(), variableName) == 0;
+}
+
+/**
+ * Returns size of the variables, that are declared in the statement and its nested blocks and are alive at the same time.
+ * Variables of the block are alive until the block is left, so sibling blocks reuse the same space.
+ */
+static unsigned int getFrameSize(const std::shared_ptr<ASTNode>& statement) {
+    const auto& children = statement->getChildren();
+    switch (statement->getType()) {
+        case NodeType::STATEMENTS_NODE: {
+            unsigned int declaredSize = 0;
+            unsigned int frameSize = 0;
+            for (size_t i = 0; i < statement->getChildrenNumber(); ++i) {
+                const auto& child = children[i];
+                const NodeType childType = child->getType();
+                if (childType == NodeType::VARIABLE_DECLARATION_NODE || childType == NodeType::VALUE_DECLARATION_NODE) {
+                    declaredSize += VARIABLE_SIZE_IN_BYTES;
+                }
+                frameSize = std::max(frameSize, declaredSize + getFrameSize(child));
+            }
+            return frameSize;
+        }
+        case NodeType::BLOCK_NODE:
+            return getFrameSize(children[0]);
+        case NodeType::IF_NODE:
+        case NodeType::WHILE_NODE:
+            return getFrameSize(children[1]);
+        case NodeType::IF_ELSE_NODE:
+            return std::max(getFrameSize(children[1]), getFrameSize(children[2]));
+        default:
+            return 0;
+    }
+}
 
 void CodegenVisitor::codegen(const std::shared_ptr<ASTNode>& root) {
     const TokenOrigin fakeOrigin = { INT64_MAX, INT64_MAX };
     auto mainFunction = std::make_shared<FunctionSymbol>("main", Type::VOID, 0, fakeOrigin);
-    push(0);
-    popReg("AX");
+    const unsigned int tablesSize = allocateMemoizationTables(root);
+    push((double) tablesSize - VARIABLE_SIZE_IN_BYTES); // There is no frame yet, so the frame of 'main' starts right after the tables
+    popReg(AX);
+    const size_t mainCallPosition = program.getInstructions().size();
     call(mainFunction);
     halt();
 
@@ -42,6 +131,8 @@ void CodegenVisitor::codegen(const std::shared_ptr<ASTNode>& root) {
     ) {
         throw SyntaxError("Expected no-arg 'main' function declaration");
     }
+    // Label of the defined 'main' is created only when it's visited, so the call is pointed to it now
+    program.getInstructions()[mainCallPosition].labelId = symbolTable.getFunctionByName(mainFunction->getName())->label->id;
 }
 
 void CodegenVisitor::visitConstantValueNode(const ConstantValueNode* node) {
@@ -59,6 +150,11 @@ void CodegenVisitor::visitValueNode(const ValueNode* node) {
     char* valueName = node->getName();
     if (!symbolTable.hasVariable(valueName)) throw SyntaxError(node->getOriginPos(), "Undeclared value");
 
+    if (node == forwardedRead) { // Value is already on the stack
+        forwardedRead = nullptr;
+        return;
+    }
+
     getVarByAddress(symbolTable.getVariableByName(valueName)->address);
 }
 
@@ -67,7 +163,18 @@ void CodegenVisitor::visitOperatorNode(const OperatorNode* node) {
     if (arity != 1 && arity != 2) throw std::logic_error("Unsupported arity of operator. Only unary and binary are supported yet");
 
     auto children = node->getChildren();
+    const bool isSameOperands = (
+        forwardStores &&
+        arity == 2 &&
+        children[0]->getType() == NodeType::VALUE_NODE &&
+        children[1]->getType() == NodeType::VALUE_NODE &&
+        strcmp(dynamic_cast<ValueNode*>(children[0].get())->getName(), dynamic_cast<ValueNode*>(children[1].get())->getName()) == 0
+    );
     for (size_t i = 0; i < arity; ++i) {
+        if (i == 1 && isSameOperands) {
+            dup();
+            break;
+        }
         children[i]->accept(this);
         coerceTo(children[i], Type::DOUBLE);
     }
@@ -87,6 +194,7 @@ void CodegenVisitor::visitAssignmentOperatorNode(const AssignmentOperatorNode* n
     if (!symbolTable.hasVariable(variableName)) throw SyntaxError(variable->getOriginPos(), "Undeclared variable");
     auto variableSymbol = symbolTable.getVariableByName(variableName);
     if (variableSymbol->isFinal) throw ValueReassignmentError(variableSymbol->originPos, node->getOriginPos());
+    if (node == forwardingStore) dup();
     setVarByAddress(variableSymbol->address);
 }
 
@@ -107,6 +215,11 @@ void CodegenVisitor::visitStatementsNode(const StatementsNode* node) {
     size_t childrenNumber = node->getChildrenNumber();
     auto children = node->getChildren();
     for (size_t i = 0; i < childrenNumber; ++i) {
+        // Forwarded value is consumed by the first read of the statement, so the next forward starts only after it
+        if (forwardStores && forwardedRead == nullptr && i + 1 < childrenNumber && isForwardable(children[i], children[i + 1])) {
+            forwardingStore = children[i].get();
+            forwardedRead = getFirstEvaluatedNode(children[i + 1]);
+        }
         children[i]->accept(this);
         coerceTo(children[i], Type::VOID); // If variable is left on stack, it should be removed
     }
@@ -177,20 +290,17 @@ void CodegenVisitor::visitParametersListNode(const ParametersListNode* node) {
     size_t childrenNumber = node->getChildrenNumber();
     if (childrenNumber == 0) return;
 
-    popReg("CX"); // Temporarily save AX to CX
+    popReg(CX); // Temporarily save old AX to CX
 
     auto children = node->getChildren();
     for (size_t i = 0; i < childrenNumber; ++i) {
         assert(children[i]->getType() == NodeType::VARIABLE_NODE);
 
-        // Parameter value put in RAM before adding new variable to SymbolTable, because it's more optimal
-        setVarByAddress(symbolTable.getNextLocalVariableAddress());
-
         auto variableNode = dynamic_cast<VariableNode*>(children[i].get());
-        addVariable(variableNode->getName(), variableNode->getOriginPos(), false);
+        setVarByAddress(addVariable(variableNode->getName(), variableNode->getOriginPos(), false)->address);
     }
 
-    pushReg("CX"); // Put saved AX value on stack
+    pushReg(CX); // Put saved old AX value on stack
 }
 
 void CodegenVisitor::visitArgumentsListNode(const ArgumentsListNode* node) {
@@ -210,27 +320,49 @@ void CodegenVisitor::visitFunctionDefinitionNode(const FunctionDefinitionNode* n
 
     auto functionSymbol = symbolTable.addFunction(functionName->getName(), Type::DOUBLE, parameters->getChildrenNumber(), functionName->getOriginPos());
     visitLabel(functionSymbol->label.get());
+    program.addFunction(functionSymbol->label.get());
 
+    assert(body->getType() == NodeType::BLOCK_NODE);
+    assert(body->getChildrenNumber() == 1);
+    frameSize = parameters->getChildrenNumber() * VARIABLE_SIZE_IN_BYTES + getFrameSize(body->getChildren()[0]);
     functionProlog();
 
     symbolTable.enterFunction();
 
     parameters->accept(this);
 
+    currentMemoizationTable = findMemoizationTable(functionName->getName());
+    if (currentMemoizationTable != nullptr) {
+        for (size_t i = 0; i < parameters->getChildrenNumber(); ++i) {
+            auto parameter = dynamic_cast<VariableNode*>(parameters->getChildren()[i].get());
+            currentMemoizationTable->parametersAddresses.push_back(symbolTable.getVariableByName(parameter->getName())->address);
+        }
+        lookupMemoizedResult();
+    }
+
     // Block node is visited manually, because only one wrapping block should be created for parameters and body blocks
-    assert(body->getType() == NodeType::BLOCK_NODE);
-    assert(body->getChildrenNumber() == 1);
     body->getChildren()[0]->accept(this);
 
+    if (currentMemoizationTable != nullptr) {
+        // Implicit 'return 0' is memoized too, so it's generated while parameters are still accessible
+        push(0);
+        memoizeResult();
+        popReg(BX);
+    }
+
     symbolTable.leaveFunction();
 
     functionEpilog();
 
-    if (!functionSymbol->isVoid()) {
+    if (currentMemoizationTable != nullptr) {
+        pushReg(BX);
+        ret();
+    } else if (!functionSymbol->isVoid()) {
         // Implicit 'return 0' to be sure function is terminated in each case
         push(0);
         ret();
     }
+    currentMemoizationTable = nullptr;
 }
 
 void CodegenVisitor::visitFunctionCallNode(const FunctionCallNode* node) {
@@ -264,6 +396,7 @@ void CodegenVisitor::visitVariableDeclarationNode(const VariableDeclarationNode*
         pushDefaultValueForType(Type::DOUBLE);
     }
 
+    if (node == forwardingStore) dup();
     setVarByAddress(addVariable(variable->getName(), variable->getOriginPos(), false)->address);
 }
 
@@ -276,6 +409,7 @@ void CodegenVisitor::visitValueDeclarationNode(const ValueDeclarationNode* node)
     initialValue->accept(this);
     coerceTo(initialValue, Type::DOUBLE);
 
+    if (node == forwardingStore) dup();
     setVarByAddress(addVariable(variable->getName(), variable->getOriginPos(), true)->address);
 }
 
@@ -284,120 +418,126 @@ void CodegenVisitor::visitReturnStatementNode(const ReturnStatementNode* node) {
 
     bool nonVoidReturn = returnsNonVoid(node->getChildren()[0], symbolTable);
     node->getChildren()[0]->accept(this);
-    if (nonVoidReturn) popReg("BX"); // Save returned value temporarily to BX
+    if (nonVoidReturn && currentMemoizationTable != nullptr) memoizeResult();
+    if (nonVoidReturn) popReg(BX); // Save returned value temporarily to BX
     functionEpilog();
-    if (nonVoidReturn) pushReg("BX");
+    if (nonVoidReturn) pushReg(BX);
     ret();
 }
 
 void CodegenVisitor::visitLabel(const Label* label) {
-    fprintf(assemblyFile, "%s:\n", label->getName());
+    program.addLabel(label);
+    program.append(Instruction(IR_LABEL, AX, 0, label->id));
 }
 
 void CodegenVisitor::functionProlog() {
-    pushReg("AX");
+    pushReg(AX);
+
+    // Frame is allocated once for all variables of the function, so declarations cost nothing
+    if (frameSize > 0) {
+        pushReg(AX);
+        push(frameSize);
+        arithmeticOperation(ADDITION);
+        popReg(AX);
+    }
 }
 
 void CodegenVisitor::functionEpilog() {
-    popReg("AX");
+    popReg(AX);
 }
 
 void CodegenVisitor::push(double value) {
-    fprintf(assemblyFile, "PUSH %lg\n", value);
+    program.append(Instruction(IR_PUSH, AX, value));
 }
 
 void CodegenVisitor::pushRam(size_t address) {
-    fprintf(assemblyFile, "PUSH [%zu]\n", address);
+    program.append(Instruction(IR_PUSH_RAM, AX, address));
 }
 
-void CodegenVisitor::pushRamByReg(const char* regName) {
-    assert(strcmp(regName, "AX") == 0 || strcmp(regName, "BX") == 0 || strcmp(regName, "CX") == 0 || strcmp(regName, "DX") == 0);
-
-    fprintf(assemblyFile, "PUSH [%s]\n", regName);
+void CodegenVisitor::pushRamByReg(Register reg) {
+    program.append(Instruction(IR_PUSH_RAM_BY_REG, reg));
 }
 
-void CodegenVisitor::pushReg(const char* regName) {
-    assert(strcmp(regName, "AX") == 0 || strcmp(regName, "BX") == 0 || strcmp(regName, "CX") == 0 || strcmp(regName, "DX") == 0);
+void CodegenVisitor::pushReg(Register reg) {
+    program.append(Instruction(IR_PUSH_REG, reg));
+}
 
-    fprintf(assemblyFile, "PUSH %s\n", regName);
+void CodegenVisitor::dup() {
+    program.append(Instruction(IR_DUP));
 }
 
 void CodegenVisitor::pop() {
-    fprintf(assemblyFile, "POP\n");
+    program.append(Instruction(IR_POP));
 }
 
 void CodegenVisitor::popRam(size_t address) {
-    fprintf(assemblyFile, "POP [%zu]\n", address);
+    program.append(Instruction(IR_POP_RAM, AX, address));
 }
 
-void CodegenVisitor::popRamByReg(const char* regName) {
-    assert(strcmp(regName, "AX") == 0 || strcmp(regName, "BX") == 0 || strcmp(regName, "CX") == 0 || strcmp(regName, "DX") == 0);
-
-    fprintf(assemblyFile, "POP [%s]\n", regName);
+void CodegenVisitor::popRamByReg(Register reg) {
+    program.append(Instruction(IR_POP_RAM_BY_REG, reg));
 }
 
-void CodegenVisitor::popReg(const char* regName) {
-    assert(strcmp(regName, "AX") == 0 || strcmp(regName, "BX") == 0 || strcmp(regName, "CX") == 0 || strcmp(regName, "DX") == 0);
-
-    fprintf(assemblyFile, "POP %s\n", regName);
+void CodegenVisitor::popReg(Register reg) {
+    program.append(Instruction(IR_POP_REG, reg));
 }
 
 void CodegenVisitor::condJump(ComparisonOperatorType compOp, const Label* label, bool isNegated) {
-    if (isNegated) compOp = negateCompOp(compOp);
+    if (isNegated) compOp = negateComparison(compOp);
 
+    IROpcode opcode;
     switch (compOp) {
-        case LESS:             fprintf(assemblyFile, "JMPL %s\n",  label->getName()); return;
-        case LESS_OR_EQUAL:    fprintf(assemblyFile, "JMPLE %s\n", label->getName()); return;
-        case GREATER:          fprintf(assemblyFile, "JMPG %s\n",  label->getName()); return;
-        case GREATER_OR_EQUAL: fprintf(assemblyFile, "JMPGE %s\n", label->getName()); return;
-        case EQUAL:            fprintf(assemblyFile, "JMPE %s\n",  label->getName()); return;
-        case NOT_EQUAL:        fprintf(assemblyFile, "JMPNE %s\n", label->getName()); return;
+        case LESS:             opcode = IR_JMPL;  break;
+        case LESS_OR_EQUAL:    opcode = IR_JMPLE; break;
+        case GREATER:          opcode = IR_JMPG;  break;
+        case GREATER_OR_EQUAL: opcode = IR_JMPGE; break;
+        case EQUAL:            opcode = IR_JMPE;  break;
+        case NOT_EQUAL:        opcode = IR_JMPNE; break;
         default:               throw std::logic_error("Unsupported comparison operator type");
     }
+    program.addLabel(label);
+    program.append(Instruction(opcode, AX, 0, label->id));
 }
 
 void CodegenVisitor::uncondJump(const Label* label) {
-    fprintf(assemblyFile, "JMP %s\n", label->getName());
+    program.addLabel(label);
+    program.append(Instruction(IR_JMP, AX, 0, label->id));
 }
 
 void CodegenVisitor::arithmeticOperation(OperatorType op) {
     switch (op) {
-        case ADDITION:            fprintf(assemblyFile, "ADD\n"); return;
-        case SUBTRACTION:         fprintf(assemblyFile, "SUB\n"); return;
+        case ADDITION:            program.append(Instruction(IR_ADD)); return;
+        case SUBTRACTION:         program.append(Instruction(IR_SUB)); return;
         case ARITHMETIC_NEGATION: push(-1); /* Fall through */
-        case MULTIPLICATION:      fprintf(assemblyFile, "MUL\n"); return;
-        case DIVISION:            fprintf(assemblyFile, "DIV\n"); return;
+        case MULTIPLICATION:      program.append(Instruction(IR_MUL)); return;
+        case DIVISION:            program.append(Instruction(IR_DIV)); return;
         case UNARY_ADDITION:      /* Do nothing */ return;
         default:                  throw std::logic_error("Unsupported arithmetic operation");
     }
 }
 
 void CodegenVisitor::ret() {
-    fprintf(assemblyFile, "RET\n");
+    program.append(Instruction(IR_RET));
 }
 
 void CodegenVisitor::call(const std::shared_ptr<FunctionSymbol>& functionSymbol) {
     if (functionSymbol->isInternal()) {
-        fprintf(assemblyFile, "%s\n", functionSymbol->internalName);
+        // Internal functions are the instructions of the stack machine
+        for (IROpcode opcode : { IR_IN, IR_OUT, IR_SQRT, IR_POW }) {
+            if (strcmp(functionSymbol->internalName, IROpcodeStrings[opcode]) == 0) {
+                program.append(Instruction(opcode));
+                return;
+            }
+        }
+        throw std::logic_error("Unsupported internal function");
     } else {
-        fprintf(assemblyFile, "CALL %s\n", functionSymbol->label->getName());
+        program.addLabel(functionSymbol->label.get());
+        program.append(Instruction(IR_CALL, AX, 0, functionSymbol->label->id));
     }
 }
 
 void CodegenVisitor::halt() {
-    fprintf(assemblyFile, "HLT\n");
-}
-
-ComparisonOperatorType CodegenVisitor::negateCompOp(ComparisonOperatorType compOp) {
-    switch (compOp) {
-        case LESS:             return GREATER_OR_EQUAL;
-        case LESS_OR_EQUAL:    return GREATER;
-        case GREATER:          return LESS_OR_EQUAL;
-        case GREATER_OR_EQUAL: return LESS;
-        case EQUAL:            return NOT_EQUAL;
-        case NOT_EQUAL:        return EQUAL;
-        default:               throw std::logic_error("Unsupported comparison operator type");
-    }
+    program.append(Instruction(IR_HLT));
 }
 
 void CodegenVisitor::pushDefaultValueForType(Type type) {
@@ -410,45 +550,214 @@ void CodegenVisitor::pushDefaultValueForType(Type type) {
 }
 
 void CodegenVisitor::getVarByAddress(unsigned int address) {
-    address = symbolTable.getNextLocalVariableAddress() - address;
+    // varRamAddress = AX - (frameSize - VARIABLE_SIZE_IN_BYTES - varLocalAddress)
+    program.append(Instruction(IR_PUSH_FRAME, AX, frameSize - VARIABLE_SIZE_IN_BYTES - address));
+}
 
-    // varRamAddress = AX - (nextVarLocalAddress - varLocalAddress)
-    if (address == 0) {
-        pushRamByReg("AX");
-    } else {
-        pushReg("AX");
-        push(address);
-        arithmeticOperation(SUBTRACTION);
-        popReg("BX"); // Now BX = varRamAddress
+void CodegenVisitor::setVarByAddress(unsigned int address) {
+    // varRamAddress = AX - (frameSize - VARIABLE_SIZE_IN_BYTES - varLocalAddress)
+    program.append(Instruction(IR_POP_FRAME, AX, frameSize - VARIABLE_SIZE_IN_BYTES - address));
+}
+
+unsigned int CodegenVisitor::allocateMemoizationTables(const std::shared_ptr<ASTNode>& root) {
+    // Tables are allocated from the beginning of RAM, and the frames grow after them, so even deep calls can't overwrite them
+    unsigned int nextTableAddress = 0;
+    for (size_t i = 0; i < root->getChildrenNumber(); ++i) {
+        const auto& statement = root->getChildren()[i];
+        if (statement->getType() != NodeType::FUNCTION_DEFINITION_NODE) continue;
+
+        const char* functionName = dynamic_cast<FunctionDefinitionNode*>(statement.get())->getFunctionName()->getName();
+        bool isMemoized = false;
+        for (const char* memoizedFunction : memoizedFunctions) {
+            if (strcmp(memoizedFunction, functionName) == 0) isMemoized = true;
+        }
+        if (!isMemoized || findMemoizationTable(functionName) != nullptr) continue;
+
+        MemoizationTable table = { functionName, 0, (unsigned int)statement->getChildren()[0]->getChildrenNumber(), { } };
+        if (nextTableAddress + table.getSize() > RAM_SIZE) throw std::logic_error("Not enough RAM for memoization tables");
+        table.address = nextTableAddress;
+        nextTableAddress += table.getSize();
+        memoizationTables.push_back(table);
+
+        // Table is empty at the start
+        push(0);
+        popRam(table.address);
+        push(0);
+        popRam(table.address + 1);
+    }
+    return nextTableAddress;
+}
 
-        pushRamByReg("BX"); // To put variable value on stack
+MemoizationTable* CodegenVisitor::findMemoizationTable(const char* functionName) {
+    for (auto& table : memoizationTables) {
+        if (strcmp(table.functionName, functionName) == 0) return &table;
     }
+    return nullptr;
 }
 
-void CodegenVisitor::setVarByAddress(unsigned int address) {
-    address = symbolTable.getNextLocalVariableAddress() - address;
+void CodegenVisitor::lookupMemoizedResult() {
+    assert(currentMemoizationTable != nullptr);
+    const MemoizationTable& table = *currentMemoizationTable;
+    const unsigned int entriesAddress = table.getEntriesAddress();
+    const unsigned int entrySize = table.getEntrySize();
 
-    // varRamAddress = AX - (nextVarLocalAddress - varLocalAddress)
-    if (address == 0) {
-        popRamByReg("AX");
-    } else {
-        pushReg("AX");
-        push(address);
-        arithmeticOperation(SUBTRACTION);
-        popReg("BX"); // Now BX = varRamAddress
+    Label loopLabel;
+    Label noWrapLabel;
+    Label notFoundLabel;
 
-        popRamByReg("BX"); // To put variable value to RAM
+    // Calls with NaN arguments are never memoized
+    for (unsigned int i = 0; i < table.parametersNumber; ++i) {
+        jumpIfParameterIsNaN(table.parametersAddresses[i], &notFoundLabel);
+    }
+
+    // DX = number of entries left to check, CX = address of the last checked entry.
+    // Entries are checked from the most recent one, so the search starts from the entry to fill next
+    pushRam(table.address);
+    popReg(DX);
+    pushRam(table.address + 1);
+    push(entrySize);
+    arithmeticOperation(MULTIPLICATION);
+    push(entriesAddress);
+    arithmeticOperation(ADDITION);
+    popReg(CX);
+
+    visitLabel(&loopLabel);
+    pushReg(DX);
+    push(0);
+    condJump(LESS_OR_EQUAL, &notFoundLabel, false);
+    pushReg(DX);
+    push(1);
+    arithmeticOperation(SUBTRACTION);
+    popReg(DX);
+
+    // CX = address of the previous entry (cyclically)
+    pushReg(CX);
+    push(entriesAddress);
+    condJump(GREATER, &noWrapLabel, false);
+    push(entriesAddress + MEMOIZATION_TABLE_CAPACITY * entrySize);
+    popReg(CX);
+    visitLabel(&noWrapLabel);
+    pushReg(CX);
+    push(entrySize);
+    arithmeticOperation(SUBTRACTION);
+    popReg(CX);
+
+    for (unsigned int i = 0; i < table.parametersNumber; ++i) {
+        jumpIfParameterDiffers(table.parametersAddresses[i], i, &loopLabel);
+    }
+
+    // Entry is found, so the saved result is returned
+    pushReg(CX);
+    push(table.parametersNumber);
+    arithmeticOperation(ADDITION);
+    popReg(BX);
+    pushRamByReg(BX);
+    popReg(BX);
+    functionEpilog();
+    pushReg(BX);
+    ret();
+
+    visitLabel(&notFoundLabel);
+}
+
+void CodegenVisitor::pushEntryValue(unsigned int index) {
+    pushReg(CX);
+    push(index);
+    arithmeticOperation(ADDITION);
+    popReg(BX);
+    pushRamByReg(BX);
+}
+
+void CodegenVisitor::jumpIfParameterDiffers(unsigned int parameterAddress, unsigned int index, const Label* label) {
+    // Ordering jumps compare numbers exactly, so the numbers are the same, if neither of them is less than the other.
+    // Zeros of the different signs are the same in this sense, so they are told apart by their reciprocals (infinities)
+    for (bool isReciprocal : { false, true }) {
+        for (ComparisonOperatorType compOp : { LESS, GREATER }) {
+            if (isReciprocal) push(1);
+            getVarByAddress(parameterAddress);
+            if (isReciprocal) arithmeticOperation(DIVISION);
+            if (isReciprocal) push(1);
+            pushEntryValue(index);
+            if (isReciprocal) arithmeticOperation(DIVISION);
+            condJump(compOp, label, false);
+        }
     }
 }
 
-std::shared_ptr<VariableSymbol> CodegenVisitor::addVariable(char* name, const TokenOrigin& originPos, bool isFinal) {
-    // Increase AX by variable size
-    pushReg("AX");
-    push(VARIABLE_SIZE_IN_BYTES);
-    fprintf(assemblyFile, "ADD\n");
-    popReg("AX");
+void CodegenVisitor::jumpIfParameterIsNaN(unsigned int parameterAddress, const Label* label) {
+    // NaN is the only value, that isn't equal to itself
+    Label isNumberLabel;
+    getVarByAddress(parameterAddress);
+    getVarByAddress(parameterAddress);
+    condJump(LESS_OR_EQUAL, &isNumberLabel, false);
+    uncondJump(label);
+    visitLabel(&isNumberLabel);
+}
+
+void CodegenVisitor::memoizeResult() {
+    assert(currentMemoizationTable != nullptr);
+    const MemoizationTable& table = *currentMemoizationTable;
+
+    Label noIndexOverflowLabel;
+    Label tableIsFullLabel;
+    Label notMemoizedLabel;
+
+    for (unsigned int i = 0; i < table.parametersNumber; ++i) {
+        jumpIfParameterIsNaN(table.parametersAddresses[i], &notMemoizedLabel);
+    }
 
-    return symbolTable.addVariable(name, originPos, isFinal);
+    // CX = address of the entry to fill
+    pushRam(table.address + 1);
+    push(table.getEntrySize());
+    arithmeticOperation(MULTIPLICATION);
+    push(table.getEntriesAddress());
+    arithmeticOperation(ADDITION);
+    popReg(CX);
+
+    for (unsigned int i = 0; i < table.parametersNumber; ++i) {
+        getVarByAddress(table.parametersAddresses[i]);
+        pushReg(CX);
+        push(i);
+        arithmeticOperation(ADDITION);
+        popReg(BX);
+        popRamByReg(BX);
+    }
+
+    // Returned value is on the top of the stack, and it should stay there
+    dup();
+    pushReg(CX);
+    push(table.parametersNumber);
+    arithmeticOperation(ADDITION);
+    popReg(BX);
+    popRamByReg(BX);
+
+    // Index of the entry to fill next is increased cyclically
+    pushRam(table.address + 1);
+    push(1);
+    arithmeticOperation(ADDITION);
+    popRam(table.address + 1);
+    pushRam(table.address + 1);
+    push(MEMOIZATION_TABLE_CAPACITY);
+    condJump(LESS, &noIndexOverflowLabel, false);
+    push(0);
+    popRam(table.address + 1);
+    visitLabel(&noIndexOverflowLabel);
+
+    pushRam(table.address);
+    push(MEMOIZATION_TABLE_CAPACITY);
+    condJump(GREATER_OR_EQUAL, &tableIsFullLabel, false);
+    pushRam(table.address);
+    push(1);
+    arithmeticOperation(ADDITION);
+    popRam(table.address);
+    visitLabel(&tableIsFullLabel);
+    visitLabel(&notMemoizedLabel);
+}
+
+std::shared_ptr<VariableSymbol> CodegenVisitor::addVariable(char* name, const TokenOrigin& originPos, bool isFinal) {
+    auto symbol = symbolTable.addVariable(name, originPos, isFinal);
+    assert(symbolTable.getNextLocalVariableAddress() <= frameSize);
+    return symbol;
 }
 
 void CodegenVisitor::coerceTo(std::shared_ptr<ASTNode>& node, Type to) {
@@ -463,13 +772,8 @@ void CodegenVisitor::coerceTo(std::shared_ptr<ASTNode>& node, Type to) {
     throw CoercionError(node->getOriginPos(), from, to);
 }
 
-void codegen(const std::shared_ptr<ASTNode>& root, const char* assemblyFileName) {
-    assert(assemblyFileName != nullptr);
-    FILE* assemblyFile = fopen(assemblyFileName, "wb");
-    if (assemblyFile == nullptr) return;
-
-    CodegenVisitor visitor(assemblyFile);
+IRProgram codegen(const std::shared_ptr<ASTNode>& root, const std::vector<const char*>& memoizedFunctions, bool forwardStores) {
+    CodegenVisitor visitor(memoizedFunctions, forwardStores);
     visitor.codegen(root);
-
-    fclose(assemblyFile);
+    return visitor.getProgram();
 }
@@ -5,7 +5,10 @@
 #ifndef COMPILER_CODEGEN_H
 #define COMPILER_CODEGEN_H
 
+#include <vector>
 #include "../frontend/ast.h"
+#include "../util/constants.h"
+#include "ir.h"
 #include "Label.h"
 #include "SymbolTable.h"
 
@@ -14,24 +17,70 @@
  *   - Each program should contain no-arg 'main' function. Program starts from it.
  *   - Arguments for functions are passed through the stack in the reverse order.
  *   - Each function preserves it's stack frame using 'AX', 'BX' and 'CX' register:
- *        -# Register 'AX' points to the address of the next empty byte in RAM.
- *        -# If there is some local variable at the LOCAL address 'X', then it's RAM address is equal to ('AX'  - (nextLocalVarAddress - varLocalAddress)). So to get or set a value of a variable, this value should be calculated. ('BX' register is used as helper in this calculations).
- *        -# On function enter, current 'AX' is pushed onto the stack (if there is some parameters, then 'CX' is used as a helper, to temporarily save 'AX' value while parameters popped from the stack).
+ *        -# Register 'AX' points to the last variable of the current frame. Frame of the called function starts right after it.
+ *        -# Frame size is the maximal size of the variables, that are alive at the same time (variables of the sibling blocks share the space).
+ *        -# If there is some local variable at the LOCAL address 'X', then it's RAM address is equal to ('AX'  - (frameSize - variableSize - varLocalAddress)). Variables are accessed by frame-relative instructions like `PUSH [AX-16]`, that are lowered to the address calculation in 'BX' (see lowerFrameAccesses).
+ *        -# On function enter, current 'AX' is pushed onto the stack and 'AX' is increased by the frame size (if there is some parameters, then 'CX' is used as a helper, to temporarily save old 'AX' value while parameters popped from the stack).
  *        -# When function is left, old 'AX' is popped from the stack and the current 'AX' is assigned to that value.
+ *   - If the statement stores a variable, and the next statement starts with reading it, the stored value is duplicated
+ *     on the stack instead of loading it back from RAM (the same is done for binary operators like `x * x`). It's done only
+ *     with optimizations, -O0 code loads every value.
+ *   - Memoized functions have lookup tables in the beginning of RAM, frame of 'main' starts right after them (see MemoizationTable):
+ *        -# Table is searched right after the parameters are popped ('CX' and 'DX' are used as helpers). If the call is found, its result is returned.
+ *        -# Before each return, parameters and returned value are saved to the table (the oldest entry is replaced, if the table is full).
+ *        -# Calls with NaN arguments are neither searched nor saved.
  */
+/**
+ * Lookup table of the memoized function. Table is located in RAM:
+ *   - [address] contains the number of filled entries;
+ *   - [address + 1] contains the index of the entry to fill next (entries are replaced in a round-robin manner);
+ *   - Entries start from (address + 2). Each entry contains values of the parameters and the returned value.
+ * Parameters are compared exactly (see jumpIfParameterDiffers), so the call is found only if it has the same arguments.
+ */
+struct MemoizationTable {
+    const char* functionName;
+    unsigned int address;
+    unsigned int parametersNumber;
+    std::vector<unsigned int> parametersAddresses; // Local addresses of the parameters
+
+    unsigned int getEntriesAddress() const {
+        return address + 2;
+    }
+
+    unsigned int getEntrySize() const {
+        return parametersNumber + 1;
+    }
+
+    unsigned int getSize() const {
+        return 2 + MEMOIZATION_TABLE_CAPACITY * getEntrySize();
+    }
+};
+
 class CodegenVisitor {
 
 private:
-    FILE* assemblyFile = nullptr;
+    IRProgram program;
     SymbolTable symbolTable;
+    const std::vector<const char*> memoizedFunctions;
+    const bool forwardStores;                 // Stored values are forwarded to the reads of the next statement (not at -O0)
+    std::vector<MemoizationTable> memoizationTables;
+    MemoizationTable* currentMemoizationTable = nullptr;
+    const ASTNode* forwardingStore = nullptr; // Store, that keeps a copy of the stored value on the stack...
+    const ASTNode* forwardedRead = nullptr;   // ...for this read in the next statement, so it's not loaded from RAM
+    unsigned int frameSize = 0;               // Size of the variables of the current function
 
 public:
-    explicit CodegenVisitor(FILE* assemblyFile_) : assemblyFile(assemblyFile_) {
-        assert(assemblyFile_ != nullptr);
-    }
+    explicit CodegenVisitor(const std::vector<const char*>& memoizedFunctions_ = { }, bool forwardStores_ = true) :
+        memoizedFunctions(memoizedFunctions_),
+        forwardStores(forwardStores_)
+    { }
 
     void codegen(const std::shared_ptr<ASTNode>& root);
 
+    const IRProgram& getProgram() const {
+        return program;
+    }
+
     void visitConstantValueNode(const ConstantValueNode* node);
     void visitVariableNode(const VariableNode* node);
     void visitValueNode(const ValueNode* node);
@@ -57,12 +106,13 @@ public:
 
     void push(double value);
     void pushRam(size_t address);
-    void pushRamByReg(const char* regName);
-    void pushReg(const char* regName);
+    void pushRamByReg(Register reg);
+    void pushReg(Register reg);
+    void dup();
     void pop();
     void popRam(size_t address);
-    void popRamByReg(const char* regName);
-    void popReg(const char* regName);
+    void popRamByReg(Register reg);
+    void popReg(Register reg);
     void condJump(ComparisonOperatorType compOp, const Label* label, bool isNegated);
     void uncondJump(const Label* label);
     void arithmeticOperation(OperatorType op);
@@ -74,15 +124,31 @@ public:
     void setVarByAddress(unsigned int address);
 
 private:
-    static ComparisonOperatorType negateCompOp(ComparisonOperatorType compOp);
-
     std::shared_ptr<VariableSymbol> addVariable(char* name, const TokenOrigin& originPos, bool isFinal);
 
+    /** @return size of all tables */
+    unsigned int allocateMemoizationTables(const std::shared_ptr<ASTNode>& root);
+    MemoizationTable* findMemoizationTable(const char* functionName);
+    void lookupMemoizedResult();
+    /** Pushes the value of the current entry of the memoization table ('CX' points to the entry) */
+    void pushEntryValue(unsigned int index);
+    /** Jumps to the label, if the parameter is not the same number as the value of the current entry (signs of zeros are compared too) */
+    void jumpIfParameterDiffers(unsigned int parameterAddress, unsigned int index, const Label* label);
+    void jumpIfParameterIsNaN(unsigned int parameterAddress, const Label* label);
+    void memoizeResult();
+
     void pushDefaultValueForType(Type type);
 
     void coerceTo(std::shared_ptr<ASTNode>& node, Type to);
 };
 
-void codegen(const std::shared_ptr<ASTNode>& root, const char* assemblyFileName);
+/**
+ * Generates IR code for the program.
+ * @param root              root of the program AST
+ * @param memoizedFunctions names of the functions, whose calls should be memoized. Functions must be pure (see PurityAnalysis)
+ * @param forwardStores     whether stored values are forwarded to the reads of the next statement (false for -O0)
+ * @return generated program
+ */
+IRProgram codegen(const std::shared_ptr<ASTNode>& root, const std::vector<const char*>& memoizedFunctions = { }, bool forwardStores = true);
 
 #endif // COMPILER_CODEGEN_H
@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief Implementation of lowering of frame-relative variable accesses to the stack machine instructions
+ */
+#include <vector>
+#include "frame-access-lowering.h"
+#include "ir.h"
+
+static inline bool isSameImmediate(double first, double second) {
+    return !(first < second || first > second);
+}
+
+/**
+ * Checks if the code ends with `PUSH AX; PUSH change; ADD (or SUB)`, so the following `POP AX` changes AX by the constant.
+ * @param change value added to AX (negative for SUB)
+ */
+static bool endsWithFrameChange(const std::vector<Instruction>& code, double& change) {
+    const size_t size = code.size();
+    if (size < 3) return false;
+
+    const Instruction& pushAX = code[size - 3];
+    const Instruction& pushChange = code[size - 2];
+    const Instruction& operation = code[size - 1];
+    if (pushAX.opcode != IR_PUSH_REG || pushAX.reg != AX || pushChange.opcode != IR_PUSH ||
+        (operation.opcode != IR_ADD && operation.opcode != IR_SUB)
+    ) {
+        return false;
+    }
+    change = operation.opcode == IR_ADD ? pushChange.immediate : -pushChange.immediate;
+    return true;
+}
+
+void lowerFrameAccesses(IRProgram& program) {
+    std::vector<Instruction>& code = program.getInstructions();
+    std::vector<Instruction> loweredCode;
+    loweredCode.reserve(code.size());
+
+    bool isAddressKnown = false;
+    double addressOffset = 0; // BX = AX - addressOffset, if the address is known
+
+    for (const Instruction& instruction : code) {
+        switch (instruction.opcode) {
+            case IR_PUSH_FRAME:
+            case IR_POP_FRAME: {
+                const IROpcode opcode = (instruction.opcode == IR_PUSH_FRAME) ? IR_PUSH_RAM_BY_REG : IR_POP_RAM_BY_REG;
+                if (isSameImmediate(instruction.immediate, 0)) {
+                    loweredCode.push_back(Instruction(opcode, AX));
+                    break;
+                }
+                if (!isAddressKnown || !isSameImmediate(addressOffset, instruction.immediate)) {
+                    loweredCode.push_back(Instruction(IR_PUSH_REG, AX));
+                    loweredCode.push_back(Instruction(IR_PUSH, AX, instruction.immediate));
+                    loweredCode.push_back(Instruction(IR_SUB));
+                    loweredCode.push_back(Instruction(IR_POP_REG, BX));
+                    isAddressKnown = true;
+                    addressOffset = instruction.immediate;
+                }
+                loweredCode.push_back(Instruction(opcode, BX));
+                break;
+            }
+            case IR_POP_REG: {
+                double change;
+                if (instruction.reg == AX && isAddressKnown && endsWithFrameChange(loweredCode, change)) {
+                    addressOffset += change;
+                } else if (instruction.reg == AX || instruction.reg == BX) {
+                    isAddressKnown = false;
+                }
+                loweredCode.push_back(instruction);
+                break;
+            }
+            case IR_LABEL: // Other paths may come with other BX
+            case IR_CALL:  // Called function changes BX
+                isAddressKnown = false;
+                loweredCode.push_back(instruction);
+                break;
+            default:
+                loweredCode.push_back(instruction);
+                break;
+        }
+    }
+
+    code.swap(loweredCode);
+}
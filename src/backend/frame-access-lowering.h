@@ -0,0 +1,27 @@
+/**
+ * @file
+ * @brief Definition of lowering of frame-relative variable accesses to the stack machine instructions
+ */
+#ifndef COMPILER_FRAME_ACCESS_LOWERING_H
+#define COMPILER_FRAME_ACCESS_LOWERING_H
+
+#include "ir.h"
+
+/**
+ * Replaces frame-relative accesses `PUSH [AX-offset]` and `POP [AX-offset]`, that the stack machine doesn't support,
+ * with the calculation of the address in BX:
+ *
+ *     PUSH AX
+ *     PUSH offset
+ *     SUB
+ *     POP BX
+ *     PUSH [BX]
+ *
+ * Accesses with zero offset become `PUSH [AX]`. BX is tracked along the straight-line code, so the address is not
+ * calculated again, if BX already contains it (e.g. in `n = n - 1`). Changes of AX by a constant shift the tracked
+ * offset, while labels, calls and other writes to AX or BX make BX unknown.
+ * Lowering must be done before the program is written (IR passes may use frame-relative accesses).
+ */
+void lowerFrameAccesses(IRProgram& program);
+
+#endif // COMPILER_FRAME_ACCESS_LOWERING_H
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Implementation of in-memory IR: instructions of the stack machine and programs built of them
+ */
+#include <cassert>
+#include <cstdio>
+#include "ir.h"
+#include "Label.h"
+
+bool Instruction::isJump() const {
+    return opcode >= IR_JMP && opcode <= IR_JMPNE;
+}
+
+bool Instruction::isTerminator() const {
+    return opcode == IR_JMP || opcode == IR_RET || opcode == IR_HLT;
+}
+
+void IRProgram::addLabel(const Label* label) {
+    assert(label != nullptr);
+    labelNames[label->id] = label->getName();
+}
+
+const char* IRProgram::getLabelName(unsigned int labelId) const {
+    const auto it = labelNames.find(labelId);
+    assert(it != labelNames.end());
+    return it->second.c_str();
+}
+
+void IRProgram::addFunction(const Label* label) {
+    assert(label != nullptr);
+    functionLabels.insert(label->id);
+}
+
+bool IRProgram::isFunction(unsigned int labelId) const {
+    return functionLabels.count(labelId) != 0;
+}
+
+void IRProgram::dump(FILE* file) const {
+    for (const Instruction& instruction : instructions) {
+        const char* opcodeName = IROpcodeStrings[instruction.opcode];
+        switch (instruction.opcode) {
+            case IR_LABEL:
+                fprintf(file, "%s:\n", getLabelName(instruction.labelId));
+                break;
+            case IR_PUSH:
+                fprintf(file, "%s %.17lg\n", opcodeName, instruction.immediate); // Folded constants need all significant digits
+                break;
+            case IR_PUSH_REG:
+            case IR_POP_REG:
+                fprintf(file, "%s %s\n", opcodeName, RegisterStrings[instruction.reg]);
+                break;
+            case IR_PUSH_RAM:
+            case IR_POP_RAM:
+                fprintf(file, "%s [%zu]\n", opcodeName, (size_t) instruction.immediate);
+                break;
+            case IR_PUSH_RAM_BY_REG:
+            case IR_POP_RAM_BY_REG:
+                fprintf(file, "%s [%s]\n", opcodeName, RegisterStrings[instruction.reg]);
+                break;
+            case IR_PUSH_FRAME:
+            case IR_POP_FRAME:
+                fprintf(file, "%s [AX-%zu]\n", opcodeName, (size_t) instruction.immediate);
+                break;
+            case IR_JMP:
+            case IR_JMPL:
+            case IR_JMPLE:
+            case IR_JMPG:
+            case IR_JMPGE:
+            case IR_JMPE:
+            case IR_JMPNE:
+            case IR_CALL:
+                fprintf(file, "%s %s\n", opcodeName, getLabelName(instruction.labelId));
+                break;
+            default:
+                fprintf(file, "%s\n", opcodeName);
+                break;
+        }
+    }
+}
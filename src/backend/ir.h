@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @brief Definition of in-memory IR: instructions of the stack machine and programs built of them
+ */
+#ifndef COMPILER_IR_H
+#define COMPILER_IR_H
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "Label.h"
+
+enum Register {
+    AX,
+    BX,
+    CX,
+    DX,
+};
+
+static const char* const RegisterStrings[] = {
+    "AX",
+    "BX",
+    "CX",
+    "DX",
+};
+
+enum IROpcode {
+    IR_LABEL,           // Not an instruction, marks the position of the label
+    IR_PUSH,            // PUSH immediate
+    IR_PUSH_REG,        // PUSH reg
+    IR_PUSH_RAM,        // PUSH [immediate]
+    IR_PUSH_RAM_BY_REG, // PUSH [reg]
+    IR_POP,             // POP (value is dropped)
+    IR_POP_REG,         // POP reg
+    IR_POP_RAM,         // POP [immediate]
+    IR_POP_RAM_BY_REG,  // POP [reg]
+    IR_PUSH_FRAME,      // PUSH [AX-immediate], not supported by the stack machine (see lowerFrameAccesses)
+    IR_POP_FRAME,       // POP [AX-immediate], not supported by the stack machine
+    IR_DUP,
+    IR_ADD,
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_IN,
+    IR_OUT,
+    IR_SQRT,
+    IR_POW,
+    IR_JMP,
+    IR_JMPL,
+    IR_JMPLE,
+    IR_JMPG,
+    IR_JMPGE,
+    IR_JMPE,
+    IR_JMPNE,
+    IR_CALL,
+    IR_RET,
+    IR_HLT,
+};
+
+static const char* const IROpcodeStrings[] = {
+    "",
+    "PUSH",
+    "PUSH",
+    "PUSH",
+    "PUSH",
+    "POP",
+    "POP",
+    "POP",
+    "POP",
+    "PUSH",
+    "POP",
+    "DUP",
+    "ADD",
+    "SUB",
+    "MUL",
+    "DIV",
+    "IN",
+    "OUT",
+    "SQRT",
+    "POW",
+    "JMP",
+    "JMPL",
+    "JMPLE",
+    "JMPG",
+    "JMPGE",
+    "JMPE",
+    "JMPNE",
+    "CALL",
+    "RET",
+    "HLT",
+};
+
+/**
+ * Instruction of the stack machine. Only the operand, that is used by the opcode, is meaningful:
+ *   - reg for the register operands (PUSH reg, POP [reg], ...);
+ *   - immediate for the constants, RAM addresses and offsets of the variables in the frame (PUSH 42, POP [8], PUSH [AX-16], ...);
+ *   - labelId for the labels, jumps and calls (id of the Label).
+ */
+struct Instruction {
+    IROpcode opcode;
+    Register reg;
+    double immediate;
+    unsigned int labelId;
+
+    explicit Instruction(IROpcode opcode_, Register reg_ = AX, double immediate_ = 0, unsigned int labelId_ = 0) :
+        opcode(opcode_), reg(reg_), immediate(immediate_), labelId(labelId_)
+    { }
+
+    /** Checks if the instruction is a conditional or unconditional jump (calls are not jumps) */
+    bool isJump() const;
+    /** Checks if the next instruction is never executed right after this one (unconditional jumps, returns and halt) */
+    bool isTerminator() const;
+};
+
+/**
+ * Program in IR: list of instructions, names of the labels, that are used in them, and labels of the functions.
+ * Code generator appends instructions to the program, then IR passes transform it, and the writers output it.
+ */
+class IRProgram {
+
+private:
+    std::vector<Instruction> instructions;
+    std::map<unsigned int, std::string> labelNames;
+    std::set<unsigned int> functionLabels;
+
+public:
+    void append(const Instruction& instruction) {
+        instructions.push_back(instruction);
+    }
+
+    /** Remembers the name of the label, so it can be used in the instructions by id */
+    void addLabel(const Label* label);
+    const char* getLabelName(unsigned int labelId) const;
+
+    /** Marks the label as the start of the function. Code of the function lasts until the next function starts */
+    void addFunction(const Label* label);
+    bool isFunction(unsigned int labelId) const;
+
+    std::vector<Instruction>& getInstructions() {
+        return instructions;
+    }
+
+    const std::vector<Instruction>& getInstructions() const {
+        return instructions;
+    }
+
+    /**
+     * Writes the program in the text format of the stack machine assembler, one instruction or label per line.
+     */
+    void dump(FILE* file) const;
+};
+
+#endif // COMPILER_IR_H
@@ -0,0 +1,219 @@
+/**
+ * @file
+ * @brief Implementation of peephole optimizer of IR
+ */
+#include <cstdio>
+#include <vector>
+#include "ir.h"
+#include "peephole-optimizer.h"
+#include "../util/comparison.h"
+
+static inline bool isSameImmediate(double first, double second) {
+    return !(first < second || first > second);
+}
+
+static inline bool isInstruction(const std::vector<Instruction>& code, size_t position, IROpcode opcode) {
+    return position < code.size() && code[position].opcode == opcode;
+}
+
+static inline bool isLoad(const Instruction& instruction) {
+    return instruction.opcode == IR_PUSH_RAM || instruction.opcode == IR_PUSH_RAM_BY_REG || instruction.opcode == IR_PUSH_FRAME;
+}
+
+static inline bool isStore(const Instruction& instruction) {
+    return instruction.opcode == IR_POP_RAM || instruction.opcode == IR_POP_RAM_BY_REG || instruction.opcode == IR_POP_FRAME;
+}
+
+/**
+ * Addressing mode of the RAM operand: by the address, by the register or by the offset in the frame.
+ */
+static inline int getAddressingMode(const Instruction& instruction) {
+    switch (instruction.opcode) {
+        case IR_PUSH_RAM:        case IR_POP_RAM:        return 0;
+        case IR_PUSH_RAM_BY_REG: case IR_POP_RAM_BY_REG: return 1;
+        default:                                         return 2;
+    }
+}
+
+/**
+ * Checks if both instructions address the same RAM cell (by the same register, address or offset in the frame).
+ */
+static bool isSameMemoryOperand(const Instruction& first, const Instruction& second) {
+    if (!(isLoad(first) || isStore(first)) || !(isLoad(second) || isStore(second))) return false;
+
+    const int addressingMode = getAddressingMode(first);
+    if (addressingMode != getAddressingMode(second)) return false;
+    return addressingMode == 1 ? first.reg == second.reg : isSameImmediate(first.immediate, second.immediate);
+}
+
+/**
+ * Evaluates the conditional jump on the constant operands the same way as the stack machine does (see isJumpTaken).
+ * @return false, if the instruction isn't a conditional jump
+ */
+static bool evaluateJump(IROpcode opcode, double left, double right, bool& isTaken) {
+    ComparisonOperatorType operatorType;
+    switch (opcode) {
+        case IR_JMPL:  operatorType = LESS;             break;
+        case IR_JMPLE: operatorType = LESS_OR_EQUAL;    break;
+        case IR_JMPG:  operatorType = GREATER;          break;
+        case IR_JMPGE: operatorType = GREATER_OR_EQUAL; break;
+        case IR_JMPE:  operatorType = EQUAL;            break;
+        case IR_JMPNE: operatorType = NOT_EQUAL;        break;
+        default:       return false;
+    }
+    isTaken = isJumpTaken(operatorType, left, right);
+    return true;
+}
+
+/**
+ * Stored value is duplicated instead of loading it back: `POP [AX-16]; PUSH [AX-16]` -> `DUP; POP [AX-16]`.
+ */
+static size_t reloadAfterStore(const std::vector<Instruction>& code, size_t position, std::vector<Instruction>& replacement) {
+    if (position + 1 >= code.size() || !isStore(code[position]) || !isLoad(code[position + 1]) ||
+        !isSameMemoryOperand(code[position], code[position + 1])
+    ) {
+        return 0;
+    }
+    replacement.push_back(Instruction(IR_DUP));
+    replacement.push_back(code[position]);
+    return 2;
+}
+
+/**
+ * Value is popped to the same place it was pushed from: `PUSH AX; POP AX` or `PUSH [AX-8]; POP [AX-8]`.
+ */
+static size_t removePushPop(const std::vector<Instruction>& code, size_t position, std::vector<Instruction>& replacement) {
+    (void) replacement;
+    if (position + 1 >= code.size()) return 0;
+
+    const Instruction& push = code[position];
+    const Instruction& pop = code[position + 1];
+    const bool isSameRegister = push.opcode == IR_PUSH_REG && pop.opcode == IR_POP_REG && push.reg == pop.reg;
+    const bool isSameMemory = isLoad(push) && isStore(pop) && isSameMemoryOperand(push, pop);
+    return (isSameRegister || isSameMemory) ? 2 : 0;
+}
+
+/**
+ * Value is pushed and immediately dropped: `PUSH 42; POP` or `DUP; POP`.
+ */
+static size_t removePushDrop(const std::vector<Instruction>& code, size_t position, std::vector<Instruction>& replacement) {
+    (void) replacement;
+    if (!isInstruction(code, position + 1, IR_POP)) return 0;
+
+    switch (code[position].opcode) {
+        case IR_PUSH:
+        case IR_PUSH_REG:
+        case IR_PUSH_RAM:
+        case IR_PUSH_RAM_BY_REG:
+        case IR_PUSH_FRAME:
+        case IR_DUP:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Conditional jump on constants is replaced with unconditional one or removed: `PUSH 0; PUSH 1; JMPGE L1` -> (nothing).
+ */
+static size_t foldConstantJump(const std::vector<Instruction>& code, size_t position, std::vector<Instruction>& replacement) {
+    if (!isInstruction(code, position, IR_PUSH) || !isInstruction(code, position + 1, IR_PUSH) ||
+        position + 2 >= code.size() || !code[position + 2].isJump() || code[position + 2].opcode == IR_JMP
+    ) {
+        return 0;
+    }
+
+    const Instruction& jump = code[position + 2];
+    bool isTaken;
+    if (!evaluateJump(jump.opcode, code[position].immediate, code[position + 1].immediate, isTaken)) return 0;
+
+    if (isTaken) replacement.push_back(Instruction(IR_JMP, AX, 0, jump.labelId));
+    return 3;
+}
+
+/**
+ * Unconditional jump to the label, that follows it, is removed: `JMP L1; L1:` -> `L1:`.
+ */
+static size_t removeJumpToNext(const std::vector<Instruction>& code, size_t position, std::vector<Instruction>& replacement) {
+    if (!isInstruction(code, position, IR_JMP)) return 0;
+
+    for (size_t i = position + 1; isInstruction(code, i, IR_LABEL); ++i) {
+        if (code[i].labelId == code[position].labelId) {
+            replacement.insert(replacement.end(), code.begin() + position + 1, code.begin() + i + 1);
+            return i + 1 - position;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Instructions between the unconditional jump (return, halt) and the next label are never executed.
+ */
+static size_t removeUnreachableCode(const std::vector<Instruction>& code, size_t position, std::vector<Instruction>& replacement) {
+    if (position >= code.size() || !code[position].isTerminator()) return 0;
+
+    size_t end = position + 1;
+    while (end < code.size() && code[end].opcode != IR_LABEL) ++end;
+    if (end == position + 1) return 0;
+
+    replacement.push_back(code[position]);
+    return end - position;
+}
+
+const PeepholeOptimizer::Rule PeepholeOptimizer::rules[] = {
+    { "reload-after-store", reloadAfterStore },
+    { "push-pop",           removePushPop },
+    { "push-drop",          removePushDrop },
+    { "constant-jump",      foldConstantJump },
+    { "jump-to-next",       removeJumpToNext },
+    { "unreachable-code",   removeUnreachableCode },
+};
+
+const size_t PeepholeOptimizer::RULES_NUMBER = sizeof(rules) / sizeof(rules[0]);
+
+static size_t countInstructions(std::vector<Instruction>::const_iterator begin, std::vector<Instruction>::const_iterator end) {
+    size_t count = 0;
+    for (auto it = begin; it != end; ++it) {
+        if (it->opcode != IR_LABEL) ++count;
+    }
+    return count;
+}
+
+bool PeepholeOptimizer::optimizeOnce(std::vector<Instruction>& code) {
+    std::vector<Instruction> optimizedCode;
+    optimizedCode.reserve(code.size());
+    std::vector<Instruction> replacement;
+    bool isChanged = false;
+
+    size_t position = 0;
+    while (position < code.size()) {
+        bool isMatched = false;
+        for (size_t i = 0; i < RULES_NUMBER && !isMatched; ++i) {
+            replacement.clear();
+            const size_t matchedNumber = rules[i].rewrite(code, position, replacement);
+            if (matchedNumber == 0) continue;
+
+            const auto matchedBegin = code.begin() + position;
+            removedNumbers[i] += countInstructions(matchedBegin, matchedBegin + matchedNumber) -
+                                 countInstructions(replacement.begin(), replacement.end());
+            optimizedCode.insert(optimizedCode.end(), replacement.begin(), replacement.end());
+            position += matchedNumber;
+            isMatched = true;
+            isChanged = true;
+        }
+        if (!isMatched) optimizedCode.push_back(code[position++]);
+    }
+
+    code.swap(optimizedCode);
+    return isChanged;
+}
+
+void PeepholeOptimizer::optimize(IRProgram& program) {
+    while (optimizeOnce(program.getInstructions())) { }
+}
+
+void PeepholeOptimizer::dump(FILE* file) const {
+    for (size_t i = 0; i < RULES_NUMBER; ++i) {
+        fprintf(file, "%s %zu\n", rules[i].name, removedNumbers[i]);
+    }
+}
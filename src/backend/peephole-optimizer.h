@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @brief Definition of peephole optimizer of IR
+ */
+#ifndef COMPILER_PEEPHOLE_OPTIMIZER_H
+#define COMPILER_PEEPHOLE_OPTIMIZER_H
+
+#include <cstdio>
+#include <vector>
+#include "ir.h"
+
+/**
+ * Replaces short sequences of instructions with the shorter (or cheaper) ones. Each rule of the table looks at the window
+ * of instructions at the current position and, if it matches, gives the replacement:
+ *
+ *     POP [AX-16]; PUSH [AX-16]  ->  DUP; POP [AX-16]
+ *     PUSH AX; POP AX            ->  (nothing)
+ *     PUSH 0; PUSH 1; JMPGE L1   ->  (nothing)
+ *     JMP L1; L1:                ->  L1:
+ *
+ * Rewrites expose new matches, so the program is scanned until no rule matches.
+ * Optimizer works before frame-relative accesses are lowered (see lowerFrameAccesses).
+ */
+class PeepholeOptimizer {
+
+private:
+    /**
+     * Tries to match the rule at the given position of the code.
+     * @param replacement instructions to put instead of the matched ones (is empty on the call)
+     * @return number of the matched instructions or 0, if the rule doesn't match
+     */
+    typedef size_t (*Rewrite)(const std::vector<Instruction>& code, size_t position, std::vector<Instruction>& replacement);
+
+    struct Rule {
+        const char* name;
+        Rewrite rewrite;
+    };
+
+    static const Rule rules[];
+    static const size_t RULES_NUMBER;
+
+    std::vector<size_t> removedNumbers = std::vector<size_t>(RULES_NUMBER, 0); // Number of removed instructions by rule
+
+    /** @return true, if any rule was applied */
+    bool optimizeOnce(std::vector<Instruction>& code);
+
+public:
+    void optimize(IRProgram& program);
+
+    /** Writes the number of instructions, removed by each rule, one rule per line */
+    void dump(FILE* file) const;
+};
+
+#endif // COMPILER_PEEPHOLE_OPTIMIZER_H
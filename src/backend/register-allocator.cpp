@@ -0,0 +1,167 @@
+/**
+ * @file
+ * @brief Implementation of register allocator for the local variables
+ */
+#include <map>
+#include <set>
+#include <vector>
+#include "ir.h"
+#include "register-allocator.h"
+
+static constexpr double LOOP_WEIGHT = 8;    // Expected number of iterations of the loop body per loop entry
+static constexpr double ACCESS_SAVING = 4;  // Instructions of the address calculation, that register access doesn't need
+static constexpr double SPILL_COST = 12;    // Instructions of the store before the call and the load after it
+
+static inline bool isSameImmediate(double first, double second) {
+    return !(first < second || first > second);
+}
+
+static inline bool isFrameAccess(const Instruction& instruction, double offset) {
+    return (instruction.opcode == IR_PUSH_FRAME || instruction.opcode == IR_POP_FRAME) && isSameImmediate(instruction.immediate, offset);
+}
+
+static bool usesRegister(const Instruction& instruction, Register reg) {
+    switch (instruction.opcode) {
+        case IR_PUSH_REG:
+        case IR_POP_REG:
+        case IR_PUSH_RAM_BY_REG:
+        case IR_POP_RAM_BY_REG:
+            return instruction.reg == reg;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Code of the function: instructions [begin, end) and positions of its labels.
+ */
+struct FunctionCode {
+    const std::vector<Instruction>& code;
+    size_t begin;
+    size_t end;
+    std::map<unsigned int, size_t> labelPositions;
+
+    FunctionCode(const std::vector<Instruction>& code_, size_t begin_, size_t end_) : code(code_), begin(begin_), end(end_) {
+        for (size_t i = begin; i < end; ++i) {
+            if (code[i].opcode == IR_LABEL) labelPositions[code[i].labelId] = i;
+        }
+    }
+
+    /** @return position of the jump target or end, if it's outside of the function */
+    size_t getTarget(const Instruction& jump) const {
+        const auto target = labelPositions.find(jump.labelId);
+        return target == labelPositions.end() ? end : target->second;
+    }
+};
+
+/**
+ * Weights of the instructions: LOOP_WEIGHT to the power of the loop depth. Loop is the code between the label and
+ * the backward jump to it.
+ */
+static std::vector<double> computeWeights(const FunctionCode& function) {
+    std::vector<double> weights(function.end - function.begin, 1);
+    for (size_t i = function.begin; i < function.end; ++i) {
+        if (!function.code[i].isJump()) continue;
+
+        const size_t target = function.getTarget(function.code[i]);
+        if (target > i) continue;
+        for (size_t j = target; j <= i; ++j) weights[j - function.begin] *= LOOP_WEIGHT;
+    }
+    return weights;
+}
+
+/**
+ * Computes, if the value of the frame slot is read later, before each instruction of the function.
+ * Element for the end of the function is false (the slot is dead after return).
+ */
+static std::vector<bool> computeLiveness(const FunctionCode& function, double offset) {
+    std::vector<bool> isLiveBefore(function.end - function.begin + 1, false);
+    bool isChanged = true;
+    while (isChanged) {
+        isChanged = false;
+        for (size_t i = function.end - 1; i + 1 > function.begin; --i) {
+            const Instruction& instruction = function.code[i];
+            bool isLiveAfter = !instruction.isTerminator() && isLiveBefore[i + 1 - function.begin];
+            if (instruction.isJump()) isLiveAfter = isLiveAfter || isLiveBefore[function.getTarget(instruction) - function.begin];
+
+            bool isLive = isLiveAfter;
+            if (isFrameAccess(instruction, offset)) isLive = instruction.opcode == IR_PUSH_FRAME;
+            if (isLive != isLiveBefore[i - function.begin]) {
+                isLiveBefore[i - function.begin] = isLive;
+                isChanged = true;
+            }
+        }
+    }
+    return isLiveBefore;
+}
+
+/**
+ * Allocates DX for the most profitable frame slot of the function and appends the rewritten code of the function.
+ */
+static void allocateFunction(const FunctionCode& function, std::vector<Instruction>& allocatedCode) {
+    const std::vector<Instruction>& code = function.code;
+    std::set<double> offsets;
+    bool isDXUsed = false;
+    for (size_t i = function.begin; i < function.end; ++i) {
+        isDXUsed = isDXUsed || usesRegister(code[i], DX);
+        if (code[i].opcode == IR_PUSH_FRAME || code[i].opcode == IR_POP_FRAME) offsets.insert(code[i].immediate);
+    }
+    offsets.erase(0); // Slot at [AX] is accessed without the address calculation
+    if (isDXUsed) offsets.clear();
+
+    const std::vector<double> weights = computeWeights(function);
+    double bestProfit = 0;
+    double bestOffset = 0;
+    std::vector<bool> bestLiveness;
+    for (double offset : offsets) {
+        const std::vector<bool> isLiveBefore = computeLiveness(function, offset);
+        double profit = 0;
+        for (size_t i = function.begin; i < function.end; ++i) {
+            const double weight = weights[i - function.begin];
+            if (isFrameAccess(code[i], offset)) profit += ACCESS_SAVING * weight;
+            if (code[i].opcode == IR_CALL && isLiveBefore[i + 1 - function.begin]) profit -= SPILL_COST * weight;
+        }
+        if (profit > bestProfit) {
+            bestProfit = profit;
+            bestOffset = offset;
+            bestLiveness = isLiveBefore;
+        }
+    }
+
+    if (bestLiveness.empty()) {
+        allocatedCode.insert(allocatedCode.end(), code.begin() + function.begin, code.begin() + function.end);
+        return;
+    }
+    for (size_t i = function.begin; i < function.end; ++i) {
+        const Instruction& instruction = code[i];
+        if (isFrameAccess(instruction, bestOffset)) {
+            allocatedCode.push_back(Instruction(instruction.opcode == IR_PUSH_FRAME ? IR_PUSH_REG : IR_POP_REG, DX));
+        } else if (instruction.opcode == IR_CALL && bestLiveness[i + 1 - function.begin]) {
+            // Called function may change DX, so the variable is spilled to its slot
+            allocatedCode.push_back(Instruction(IR_PUSH_REG, DX));
+            allocatedCode.push_back(Instruction(IR_POP_FRAME, AX, bestOffset));
+            allocatedCode.push_back(instruction);
+            allocatedCode.push_back(Instruction(IR_PUSH_FRAME, AX, bestOffset));
+            allocatedCode.push_back(Instruction(IR_POP_REG, DX));
+        } else {
+            allocatedCode.push_back(instruction);
+        }
+    }
+}
+
+void allocateRegisters(IRProgram& program) {
+    std::vector<Instruction>& code = program.getInstructions();
+    std::vector<size_t> functionStarts;
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (code[i].opcode == IR_LABEL && program.isFunction(code[i].labelId)) functionStarts.push_back(i);
+    }
+    if (functionStarts.empty()) return;
+
+    std::vector<Instruction> allocatedCode(code.begin(), code.begin() + functionStarts[0]); // Entry code
+    allocatedCode.reserve(code.size());
+    for (size_t i = 0; i < functionStarts.size(); ++i) {
+        const size_t end = (i + 1 < functionStarts.size()) ? functionStarts[i + 1] : code.size();
+        allocateFunction(FunctionCode(code, functionStarts[i], end), allocatedCode);
+    }
+    code.swap(allocatedCode);
+}
@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @brief Definition of register allocator for the local variables
+ */
+#ifndef COMPILER_REGISTER_ALLOCATOR_H
+#define COMPILER_REGISTER_ALLOCATOR_H
+
+#include "ir.h"
+
+/**
+ * Keeps the hottest variable of each function in register DX instead of its frame slot, so `PUSH [AX-16]` becomes
+ * `PUSH DX`. DX is the only register, that codegen doesn't use for the frame (it's used only by memoization, so
+ * memoized functions are skipped).
+ *
+ * Frame slots are compared by the number of their accesses, weighted by the loop depth (loops are found by the backward
+ * jumps), minus the cost of spilling. DX is not preserved by calls, so the variable is stored to its slot before each
+ * call and loaded back after it, if it's live after the call (liveness of the slot is computed over the control flow
+ * of the function). Slot of the last variable is never allocated, because it's accessed by a single `PUSH [AX]` anyway.
+ *
+ * Only one register is allocated on purpose: AX is the frame pointer, BX holds the lowered frame addresses and the
+ * returned value in the epilog, CX keeps the old AX, while the parameters are stored, and both are used by the lookup
+ * in the memoization table. So DX is the only register, that is free in the whole function body, and the stack machine
+ * has no more registers. Allocation is done only with optimizations (-O1 and above), -O0 code follows the source exactly.
+ *
+ * Allocation must be done before frame-relative accesses are lowered (see lowerFrameAccesses).
+ */
+void allocateRegisters(IRProgram& program);
+
+#endif // COMPILER_REGISTER_ALLOCATOR_H
@@ -2,7 +2,13 @@
  * @file
  */
 #include <memory>
+#include <vector>
+#include "backend/bytecode-writer.h"
 #include "backend/codegen.h"
+#include "backend/frame-access-lowering.h"
+#include "backend/ir.h"
+#include "backend/peephole-optimizer.h"
+#include "backend/register-allocator.h"
 #include "frontend/ast.h"
 #include "frontend/recursive_parser.h"
 #include "util/SyntaxError.h"
@@ -10,11 +16,16 @@
 #include "util/CoercionError.h"
 #include "util/ValueReassignmentError.h"
 #include "MappedFile.h"
-#include "middleend/ast-optimizers.h"
+#include "middleend/effect-analysis.h"
+#include "middleend/pass-pipeline.h"
+#include "middleend/profile.h"
 #include "stack-machine/src/arg-parser.h"
 #include "stack-machine/src/stack-machine.h"
 
 const char* const irFileExtension = ".ir";
+const char* const effectsFileExtension = ".effects";
+const char* const profileFileExtension = ".profile";
+const char* const peepholeFileExtension = ".peephole";
 
 enum CompilerRunningMode {
     PRINT_AST,
@@ -37,35 +48,174 @@ void outputAST(const std::shared_ptr<ASTNode>& root, const char* fileName) {
     root->visualize(fileName);
 }
 
+void outputEffects(const EffectAnalysis& effects, const char* codeFileName) {
+    char effectsFileName[maxFileNameLength];
+    replaceExtension(effectsFileName, codeFileName, effectsFileExtension);
+    FILE* effectsFile = fopen(effectsFileName, "w");
+    if (effectsFile == nullptr) {
+        fprintf(stderr, "Can't open file '%s' for writing function effects", effectsFileName);
+        return;
+    }
+    effects.dump(effectsFile);
+    fclose(effectsFile);
+}
+
+void outputIR(const IRProgram& program, const char* codeFileName) {
+    char irFileName[maxFileNameLength];
+    replaceExtension(irFileName, codeFileName, irFileExtension);
+    FILE* irFile = fopen(irFileName, "wb");
+    if (irFile == nullptr) {
+        fprintf(stderr, "Can't open file '%s' for writing IR", irFileName);
+        return;
+    }
+    program.dump(irFile);
+    fclose(irFile);
+}
+
+void outputPeepholeStatistics(const PeepholeOptimizer& peepholeOptimizer, const char* codeFileName) {
+    char statisticsFileName[maxFileNameLength];
+    replaceExtension(statisticsFileName, codeFileName, peepholeFileExtension);
+    FILE* statisticsFile = fopen(statisticsFileName, "w");
+    if (statisticsFile == nullptr) {
+        fprintf(stderr, "Can't open file '%s' for writing peephole statistics", statisticsFileName);
+        return;
+    }
+    peepholeOptimizer.dump(statisticsFile);
+    fclose(statisticsFile);
+}
+
+void outputProfile(const Profile& profile, const char* codeFileName) {
+    char profileFileName[maxFileNameLength];
+    replaceExtension(profileFileName, codeFileName, profileFileExtension);
+    FILE* profileFile = fopen(profileFileName, "w");
+    if (profileFile == nullptr) {
+        fprintf(stderr, "Can't open file '%s' for writing profile", profileFileName);
+        return;
+    }
+    profile.dump(profileFile);
+    fclose(profileFile);
+}
+
+std::shared_ptr<const Profile> inputProfile(const char* codeFileName) {
+    char profileFileName[maxFileNameLength];
+    replaceExtension(profileFileName, codeFileName, profileFileExtension);
+    FILE* profileFile = fopen(profileFileName, "r");
+    if (profileFile == nullptr) {
+        fprintf(stderr, "Can't open file '%s' for reading profile. Compiling without profile\n", profileFileName);
+        return nullptr;
+    }
+    auto profile = std::make_shared<Profile>();
+    const bool isLoaded = profile->load(profileFile);
+    fclose(profileFile);
+    if (!isLoaded) {
+        fprintf(stderr, "Invalid profile in file '%s'. Compiling without profile\n", profileFileName);
+        return nullptr;
+    }
+    return profile;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 2 || argc > 3) {
-        fprintf(stderr, "Invalid arguments number (argc = %d). Expected filename or filename and mode", argc);
+    if (argc < 2 || argc > 12) {
+        fprintf(stderr, "Invalid arguments number (argc = %d). Expected filename, optional mode and optional '-O0'..'-O3' ('-O2' by default), '--passes=...', "
+                        "'--memoize', '--fp=strict|fast', '--dump-ir', '--dump-effects', '--dump-peephole', '--profile-generate' "
+                        "(runs the program by the compiler's interpreter instead of the stack machine) and '--profile-use' flags", argc);
         return -1;
     }
     const char* codeFileName = argv[1];
+    const char* modeName = nullptr;
+    bool memoize = false;
+    FloatingPointMode fpMode = FP_STRICT;
+    bool dumpIR = false;
+    bool dumpEffects = false;
+    bool dumpPeephole = false;
+    bool generateProfile = false;
+    bool useProfile = false;
+    OptimizationLevel optimizationLevel = O2;
+    const char* passNames = nullptr;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--memoize") == 0) {
+            memoize = true;
+        } else if (strcmp(argv[i], "--fp=strict") == 0) {
+            fpMode = FP_STRICT;
+        } else if (strcmp(argv[i], "--fp=fast") == 0 || strcmp(argv[i], "--fast-math") == 0) {
+            fpMode = FP_FAST;
+        } else if (strcmp(argv[i], "--dump-ir") == 0) {
+            dumpIR = true;
+        } else if (strcmp(argv[i], "--dump-effects") == 0) {
+            dumpEffects = true;
+        } else if (strcmp(argv[i], "--dump-peephole") == 0) {
+            dumpPeephole = true;
+        } else if (strcmp(argv[i], "--profile-generate") == 0) {
+            generateProfile = true;
+        } else if (strcmp(argv[i], "--profile-use") == 0) {
+            useProfile = true;
+        } else if (strncmp(argv[i], "-O", 2) == 0 && argv[i][2] >= '0' && argv[i][2] <= '3' && argv[i][3] == '\0') {
+            optimizationLevel = (OptimizationLevel) (O0 + (argv[i][2] - '0'));
+        } else if (strncmp(argv[i], "--passes=", 9) == 0) {
+            passNames = argv[i] + 9;
+        } else if (modeName == nullptr) {
+            modeName = argv[i];
+        } else {
+            fprintf(stderr, "Unexpected argument '%s'", argv[i]);
+            return -1;
+        }
+    }
     MappedFile file(codeFileName);
-    CompilerRunningMode mode = (argc >= 3) ? parseCompilerRunningMode(argv[2]) : COMPILE;
+    CompilerRunningMode mode = (modeName != nullptr) ? parseCompilerRunningMode(modeName) : COMPILE;
+    if (generateProfile && mode != COMPILE_AND_RUN) {
+        fprintf(stderr, "Profile can be generated only in 'run' mode. Ignoring '--profile-generate'\n");
+        generateProfile = false;
+    }
+    const std::shared_ptr<const Profile> profile = useProfile ? inputProfile(codeFileName) : nullptr;
 
-    auto optimizer = std::make_shared<CompositeOptimizer>();
-    optimizer->addOptimizer(std::make_shared<UnaryAdditionOptimizer>());
-    optimizer->addOptimizer(std::make_shared<ArithmeticNegationOptimizer>());
-    optimizer->addOptimizer(std::make_shared<TrivialOperationsOptimizer>());
+    const PipelineOptions pipelineOptions = { fpMode, profile };
+    const auto optimizer = (passNames != nullptr) ? buildPipeline(passNames, pipelineOptions) : buildPipeline(optimizationLevel, pipelineOptions);
+    if (optimizer == nullptr) {
+        fprintf(stderr, "Unknown pass in '--passes=%s'. Available passes:", passNames);
+        for (const char* name : getPassNames()) fprintf(stderr, " %s", name);
+        return -1;
+    }
 
     int exitCode = 0;
     try {
         std::shared_ptr<ASTNode> ASTRoot = buildASTRecursively(file.getTextPtr());
+        if (generateProfile) {
+            // Profile is collected on the original program, so it can be applied to any optimization pipeline
+            const auto collectedProfile = collectProfile(ASTRoot);
+            if (collectedProfile == nullptr) {
+                fprintf(stderr, "Program failed while profiling (RAM overflow, too deep recursion or end of input)");
+                return -1;
+            }
+            outputProfile(*collectedProfile, codeFileName);
+            return 0;
+        }
         ASTRoot = optimizer->optimize(ASTRoot);
+        const EffectAnalysis effects(ASTRoot);
+        if (dumpEffects) outputEffects(effects, codeFileName);
 
         if (mode == PRINT_AST) {
             outputAST(ASTRoot, codeFileName);
         } else if (mode == COMPILE || mode == COMPILE_AND_RUN) {
-            char irFileName[maxFileNameLength];
-            replaceExtension(irFileName, codeFileName, irFileExtension);
-            codegen(ASTRoot, irFileName);
+            std::vector<const char*> memoizedFunctions;
+            if (memoize || profile != nullptr) {
+                // Profile tells, which functions are called with the same arguments often enough
+                for (const char* name : effects.getMemoizableFunctions()) {
+                    if (profile == nullptr || profile->isMemoizationProfitable(name)) memoizedFunctions.push_back(name);
+                }
+            }
+            IRProgram program = codegen(ASTRoot, memoizedFunctions, optimizationLevel != O0);
+            if (optimizationLevel != O0) {
+                allocateRegisters(program);
+                PeepholeOptimizer peepholeOptimizer;
+                peepholeOptimizer.optimize(program);
+                if (dumpPeephole) outputPeepholeStatistics(peepholeOptimizer, codeFileName);
+            }
+            lowerFrameAccesses(program);
+            if (dumpIR) outputIR(program, codeFileName);
 
             char assemblyFileName[maxFileNameLength];
             replaceExtension(assemblyFileName, codeFileName, assemblyFileExtension);
-            exitCode = assemble(irFileName, assemblyFileName);
+            exitCode = writeBytecode(program, assemblyFileName);
 
             if (mode == COMPILE_AND_RUN && exitCode == 0) {
                 exitCode = run(assemblyFileName);
@@ -4,10 +4,10 @@
  */
 #include <cmath>
 #include <memory>
+#include <vector>
 #include "../frontend/ast.h"
 #include "ast-optimizers.h"
-
-static constexpr double COMPARE_EPS = 1e-9;
+#include "ast-utils.h"
 
 
 std::shared_ptr<ASTNode>& Optimizer::optimize(std::shared_ptr<ASTNode>& node) const {
@@ -67,12 +67,24 @@ std::shared_ptr<ASTNode>& ArithmeticNegationOptimizer::optimizeCurrent(std::shar
     return node;
 }
 
+static inline bool isEqualToConstant(double value, double constant) {
+    return value <= constant && value >= constant;
+}
+
+static inline bool isConstantNodeEqualTo(const std::shared_ptr<ASTNode>& node, double constant) {
+    return (node->getType() == NodeType::CONSTANT_VALUE_NODE) && isEqualToConstant(dynamic_cast<ConstantValueNode*>(node.get())->getValue(), constant);
+}
+
 static inline bool isZeroConstant(const std::shared_ptr<ASTNode>& node) {
-    return (node->getType() == NodeType::CONSTANT_VALUE_NODE) && (fabs(dynamic_cast<ConstantValueNode*>(node.get())->getValue()) < COMPARE_EPS);
+    return isConstantNodeEqualTo(node, 0);
+}
+
+static inline bool isNegativeZeroConstant(const std::shared_ptr<ASTNode>& node) {
+    return isZeroConstant(node) && std::signbit(dynamic_cast<ConstantValueNode*>(node.get())->getValue());
 }
 
 static inline bool isOneConstant(const std::shared_ptr<ASTNode>& node) {
-    return (node->getType() == NodeType::CONSTANT_VALUE_NODE) && (fabs(dynamic_cast<ConstantValueNode*>(node.get())->getValue() - 1) < COMPARE_EPS);
+    return isConstantNodeEqualTo(node, 1);
 }
 
 std::shared_ptr<ASTNode>& TrivialAdditionOptimizer::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
@@ -81,15 +93,27 @@ std::shared_ptr<ASTNode>& TrivialAdditionOptimizer::optimizeCurrent(std::shared_
         hasChanges = false;
         if (node->getType() == NodeType::OPERATOR_NODE) {
             const auto operatorNode = dynamic_cast<OperatorNode*>(node.get());
-            if (operatorNode->getToken()->getOperatorType() == OperatorType::ADDITION) {
+            const auto operatorType = operatorNode->getToken()->getOperatorType();
+            if (operatorType == OperatorType::ADDITION) {
                 assert(node->getChildrenNumber() == 2);
 
+                // (-0 + x) = x, (x + -0) = x. Positive zero changes the sign of -0, so it's removed only in fast mode
                 const auto leftChild = node->getChildren()[0];
                 const auto rightChild = node->getChildren()[1];
-                if (isZeroConstant(leftChild)) {
+                if (isZeroConstant(leftChild) && (fpMode == FP_FAST || isNegativeZeroConstant(leftChild))) {
                     node = rightChild;
                     hasChanges = true;
-                } else if (isZeroConstant(rightChild)) {
+                } else if (isZeroConstant(rightChild) && (fpMode == FP_FAST || isNegativeZeroConstant(rightChild))) {
+                    node = leftChild;
+                    hasChanges = true;
+                }
+            } else if (operatorType == OperatorType::SUBTRACTION) {
+                assert(node->getChildrenNumber() == 2);
+
+                // (x - 0) = x
+                const auto leftChild = node->getChildren()[0];
+                const auto rightChild = node->getChildren()[1];
+                if (isZeroConstant(rightChild) && (fpMode == FP_FAST || !isNegativeZeroConstant(rightChild))) {
                     node = leftChild;
                     hasChanges = true;
                 }
@@ -105,18 +129,27 @@ std::shared_ptr<ASTNode>& TrivialMultiplicationOptimizer::optimizeCurrent(std::s
         hasChanges = false;
         if (node->getType() == NodeType::OPERATOR_NODE) {
             const auto operatorNode = dynamic_cast<OperatorNode*>(node.get());
-            if (operatorNode->getToken()->getOperatorType() == OperatorType::MULTIPLICATION) {
+            const auto operatorType = operatorNode->getToken()->getOperatorType();
+            if (operatorType == OperatorType::MULTIPLICATION) {
                 assert(node->getChildrenNumber() == 2);
 
                 const auto leftChild = node->getChildren()[0];
                 const auto rightChild = node->getChildren()[1];
-                if (isZeroConstant(leftChild)|| isOneConstant(rightChild)) { // (0 * x) = 0, (x * 1) = x
+                const bool isFastMode = fpMode == FP_FAST;
+                if (isOneConstant(rightChild) || (isFastMode && isZeroConstant(leftChild) && isSideEffectFree(rightChild))) { // (x * 1) = x, (0 * x) = 0
                     node = leftChild;
                     hasChanges = true;
-                } else if (isZeroConstant(rightChild) || isOneConstant(leftChild)) { // (x * 0) = 0, (1 * x) = x
+                } else if (isOneConstant(leftChild) || (isFastMode && isZeroConstant(rightChild) && isSideEffectFree(leftChild))) { // (1 * x) = x, (x * 0) = 0
                     node = rightChild;
                     hasChanges = true;
                 }
+            } else if (operatorType == OperatorType::DIVISION) {
+                assert(node->getChildrenNumber() == 2);
+
+                if (isOneConstant(node->getChildren()[1])) { // (x / 1) = x
+                    node = node->getChildren()[0];
+                    hasChanges = true;
+                }
             }
         }
     } while (hasChanges);
@@ -157,6 +190,229 @@ std::shared_ptr<ASTNode>& ConstantCompressor::optimizeCurrent(std::shared_ptr<AS
     }
 }
 
+static inline bool isOperatorNode(const std::shared_ptr<ASTNode>& node, OperatorType operatorType) {
+    return (node->getType() == NodeType::OPERATOR_NODE) && (dynamic_cast<OperatorNode*>(node.get())->getToken()->getOperatorType() == operatorType);
+}
+
+static inline bool isConstantNode(const std::shared_ptr<ASTNode>& node) {
+    return node->getType() == NodeType::CONSTANT_VALUE_NODE;
+}
+
+static inline double getConstantValue(const std::shared_ptr<ASTNode>& node) {
+    return dynamic_cast<ConstantValueNode*>(node.get())->getValue();
+}
+
+static inline std::shared_ptr<ASTNode> makeConstantNode(TokenOrigin originPos, double value) {
+    return std::make_shared<ConstantValueNode>(originPos, value);
+}
+
+static inline std::shared_ptr<ASTNode> makeNegationNode(const std::shared_ptr<ASTNode>& child) {
+    return std::make_shared<OperatorNode>(std::make_shared<ArithmeticNegationOperator>(child->getOriginPos()), child);
+}
+
+/**
+ * Applies transformations that push negations down to constants and don't change results of floating-point operations.
+ * @return true, if node was changed.
+ */
+static bool pushNegationDown(std::shared_ptr<ASTNode>& node) {
+    if (node->getType() != NodeType::OPERATOR_NODE) return false;
+
+    const auto children = node->getChildren();
+    const auto operatorType = dynamic_cast<OperatorNode*>(node.get())->getToken()->getOperatorType();
+    if (operatorType == ARITHMETIC_NEGATION) {
+        const auto child = children[0];
+        if (isConstantNode(child)) { // -(c) -> (-c)
+            node = makeConstantNode(child->getOriginPos(), -getConstantValue(child));
+            return true;
+        }
+        if (isOperatorNode(child, ARITHMETIC_NEGATION)) { // --x -> x
+            node = child->getChildren()[0];
+            return true;
+        }
+        if (isOperatorNode(child, MULTIPLICATION) || isOperatorNode(child, DIVISION)) { // -(c * x) -> (-c) * x
+            const auto childOperatorType = dynamic_cast<OperatorNode*>(child.get())->getToken()->getOperatorType();
+            const auto left = child->getChildren()[0];
+            const auto right = child->getChildren()[1];
+            if (isConstantNode(left)) {
+                node = makeBinaryOperatorNode(childOperatorType, makeConstantNode(left->getOriginPos(), -getConstantValue(left)), right);
+                return true;
+            }
+            if (isConstantNode(right)) {
+                node = makeBinaryOperatorNode(childOperatorType, left, makeConstantNode(right->getOriginPos(), -getConstantValue(right)));
+                return true;
+            }
+        }
+        return false;
+    }
+    if (node->getChildrenNumber() != 2) return false;
+
+    const auto left = children[0];
+    const auto right = children[1];
+    switch (operatorType) {
+        case ADDITION:
+            if (isOperatorNode(right, ARITHMETIC_NEGATION)) { // x + -y -> x - y
+                node = makeBinaryOperatorNode(SUBTRACTION, left, right->getChildren()[0]);
+                return true;
+            }
+            if (isOperatorNode(left, ARITHMETIC_NEGATION) && (isSideEffectFree(left) || isSideEffectFree(right))) { // -x + y -> y - x
+                node = makeBinaryOperatorNode(SUBTRACTION, right, left->getChildren()[0]);
+                return true;
+            }
+            return false;
+        case SUBTRACTION:
+            if (isOperatorNode(right, ARITHMETIC_NEGATION)) { // x - -y -> x + y
+                node = makeBinaryOperatorNode(ADDITION, left, right->getChildren()[0]);
+                return true;
+            }
+            if (isConstantNode(right) && getConstantValue(right) < 0) { // x - (-c) -> x + c
+                node = makeBinaryOperatorNode(ADDITION, left, makeConstantNode(right->getOriginPos(), -getConstantValue(right)));
+                return true;
+            }
+            return false;
+        case MULTIPLICATION:
+        case DIVISION:
+            if (isOperatorNode(left, ARITHMETIC_NEGATION) && isOperatorNode(right, ARITHMETIC_NEGATION)) { // -x * -y -> x * y
+                node = makeBinaryOperatorNode(operatorType, left->getChildren()[0], right->getChildren()[0]);
+                return true;
+            }
+            if (isConstantNode(left) && isOperatorNode(right, ARITHMETIC_NEGATION)) { // c * -x -> (-c) * x
+                node = makeBinaryOperatorNode(operatorType, makeConstantNode(left->getOriginPos(), -getConstantValue(left)), right->getChildren()[0]);
+                return true;
+            }
+            if (isOperatorNode(left, ARITHMETIC_NEGATION) && isConstantNode(right)) { // -x * c -> x * (-c)
+                node = makeBinaryOperatorNode(operatorType, left->getChildren()[0], makeConstantNode(right->getOriginPos(), -getConstantValue(right)));
+                return true;
+            }
+            if (isConstantNode(right) && isEqualToConstant(getConstantValue(right), -1)) { // x * -1 -> -x
+                node = makeNegationNode(left);
+                return true;
+            }
+            if (operatorType == MULTIPLICATION && isConstantNode(left) && isEqualToConstant(getConstantValue(left), -1)) { // -1 * x -> -x
+                node = makeNegationNode(right);
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+struct SumTerm {
+    double coefficient;
+    std::shared_ptr<ASTNode> base;
+};
+
+static void flattenSum(const std::shared_ptr<ASTNode>& node, double sign, std::vector<SumTerm>& terms, double& constant) {
+    if (isOperatorNode(node, ADDITION) || isOperatorNode(node, SUBTRACTION)) {
+        flattenSum(node->getChildren()[0], sign, terms, constant);
+        flattenSum(node->getChildren()[1], isOperatorNode(node, ADDITION) ? sign : -sign, terms, constant);
+    } else if (isOperatorNode(node, ARITHMETIC_NEGATION)) {
+        flattenSum(node->getChildren()[0], -sign, terms, constant);
+    } else if (isConstantNode(node)) {
+        constant += sign * getConstantValue(node);
+    } else {
+        SumTerm term = { sign, node };
+        if (isOperatorNode(node, MULTIPLICATION)) { // Products are already canonical, so constant is the left factor
+            const auto left = node->getChildren()[0];
+            if (isConstantNode(left)) term = { sign * getConstantValue(left), node->getChildren()[1] };
+        }
+
+        if (isSideEffectFree(term.base)) {
+            for (auto& similarTerm : terms) {
+                if (isSideEffectFree(similarTerm.base) && isEqualAST(similarTerm.base, term.base)) {
+                    similarTerm.coefficient += term.coefficient;
+                    return;
+                }
+            }
+        }
+        terms.push_back(term);
+    }
+}
+
+static std::shared_ptr<ASTNode> buildSum(TokenOrigin originPos, const std::vector<SumTerm>& terms, double constant) {
+    std::shared_ptr<ASTNode> sum = nullptr;
+    for (const auto& term : terms) {
+        if (isEqualToConstant(term.coefficient, 0) && isSideEffectFree(term.base)) continue;
+
+        const bool isNegative = term.coefficient < 0;
+        const double absoluteCoefficient = fabs(term.coefficient);
+        if (sum == nullptr) {
+            if (isEqualToConstant(absoluteCoefficient, 1)) {
+                sum = isNegative ? makeNegationNode(term.base) : term.base;
+            } else {
+                sum = makeBinaryOperatorNode(MULTIPLICATION, makeConstantNode(term.base->getOriginPos(), term.coefficient), term.base);
+            }
+        } else {
+            const auto addend = isEqualToConstant(absoluteCoefficient, 1) ?
+                term.base :
+                makeBinaryOperatorNode(MULTIPLICATION, makeConstantNode(term.base->getOriginPos(), absoluteCoefficient), term.base);
+            sum = makeBinaryOperatorNode(isNegative ? SUBTRACTION : ADDITION, sum, addend);
+        }
+    }
+
+    if (sum == nullptr) return makeConstantNode(originPos, constant);
+    if (isEqualToConstant(constant, 0)) return sum;
+    return makeBinaryOperatorNode(constant < 0 ? SUBTRACTION : ADDITION, sum, makeConstantNode(originPos, fabs(constant)));
+}
+
+static void flattenProduct(const std::shared_ptr<ASTNode>& node, std::vector<std::shared_ptr<ASTNode>>& factors, double& constant) {
+    if (isOperatorNode(node, MULTIPLICATION)) {
+        flattenProduct(node->getChildren()[0], factors, constant);
+        flattenProduct(node->getChildren()[1], factors, constant);
+    } else if (isOperatorNode(node, DIVISION) && isConstantNode(node->getChildren()[1]) && !isZeroConstant(node->getChildren()[1])) { // x / c -> (1 / c) * x
+        flattenProduct(node->getChildren()[0], factors, constant);
+        constant /= getConstantValue(node->getChildren()[1]);
+    } else if (isOperatorNode(node, ARITHMETIC_NEGATION)) {
+        flattenProduct(node->getChildren()[0], factors, constant);
+        constant = -constant;
+    } else if (isConstantNode(node)) {
+        constant *= getConstantValue(node);
+    } else {
+        factors.push_back(node);
+    }
+}
+
+static std::shared_ptr<ASTNode> buildProduct(TokenOrigin originPos, const std::vector<std::shared_ptr<ASTNode>>& factors, double constant) {
+    bool isSideEffectFreeProduct = true;
+    for (const auto& factor : factors) {
+        if (!isSideEffectFree(factor)) isSideEffectFreeProduct = false;
+    }
+    if (factors.empty() || (isEqualToConstant(constant, 0) && isSideEffectFreeProduct)) return makeConstantNode(originPos, constant);
+
+    std::shared_ptr<ASTNode> product = factors[0];
+    for (size_t i = 1; i < factors.size(); ++i) {
+        product = makeBinaryOperatorNode(MULTIPLICATION, product, factors[i]);
+    }
+
+    if (isEqualToConstant(constant, 1)) return product;
+    if (isEqualToConstant(constant, -1)) return makeNegationNode(product);
+    return makeBinaryOperatorNode(MULTIPLICATION, makeConstantNode(originPos, constant), product);
+}
+
+std::shared_ptr<ASTNode>& ArithmeticReassociationOptimizer::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != NodeType::OPERATOR_NODE) return node;
+
+    if (fpMode == FP_FAST) {
+        if (isOperatorNode(node, MULTIPLICATION) || isOperatorNode(node, DIVISION)) {
+            std::vector<std::shared_ptr<ASTNode>> factors;
+            double constant = 1;
+            flattenProduct(node, factors, constant);
+            if (isOperatorNode(node, MULTIPLICATION) || factors.size() != 1 || factors[0] != node) {
+                node = buildProduct(node->getOriginPos(), factors, constant);
+            }
+        }
+        if (isOperatorNode(node, ADDITION) || isOperatorNode(node, SUBTRACTION) || isOperatorNode(node, ARITHMETIC_NEGATION)) {
+            std::vector<SumTerm> terms;
+            double constant = 0;
+            flattenSum(node, 1, terms, constant);
+            node = buildSum(node->getOriginPos(), terms, constant);
+        }
+    }
+
+    while (pushNegationDown(node)) { }
+    return node;
+}
+
 std::shared_ptr<ASTNode>& TrivialOperationsOptimizer::optimize(std::shared_ptr<ASTNode>& node) const {
     const auto children = node->getChildren();
     const size_t childrenNumber = node->getChildrenNumber();
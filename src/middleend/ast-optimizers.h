@@ -9,6 +9,19 @@
 #include <vector>
 #include "../frontend/ast.h"
 
+/**
+ * Floating-point model, that optimizers must follow.
+ *
+ * In strict mode results of all floating-point operations (including NaN, infinities and the sign of zero) are preserved
+ * exactly, so only exact rewrites are applied (like `x * 1` -> `x` or folding of constant operations, that are computed
+ * the same way as in the stack machine). In fast mode operations may be reassociated and rewritten as if numbers were
+ * real (like `0 * x` -> `0`, `(x + 1) + 2` -> `x + 3` or `x / 4 * 8` -> `2 * x`).
+ */
+enum FloatingPointMode {
+    FP_STRICT,
+    FP_FAST,
+};
+
 class Optimizer {
 
 private:
@@ -76,27 +89,36 @@ public:
 };
 
 /**
- * Optimizer for expressions like (0 + ...), (... + 0)
+ * Optimizer for expressions like (0 + ...), (... + 0), (... - 0).
+ * In strict mode only exact rewrites are applied: `x - 0` -> `x` and `x + -0` -> `x` (`-0 + 0` is `+0`).
  */
 class TrivialAdditionOptimizer : public Optimizer {
 
+private:
+    const FloatingPointMode fpMode;
+
 public:
-    TrivialAdditionOptimizer() : Optimizer(true) { }
+    explicit TrivialAdditionOptimizer(FloatingPointMode fpMode_) : Optimizer(true), fpMode(fpMode_) { }
     std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
 };
 
 /**
- * Optimizer for expressions like (1 * ...), (... * 1), (0 * ...), (... * 0)
+ * Optimizer for expressions like (1 * ...), (... * 1), (... / 1), (0 * ...), (... * 0).
+ * Multiplications by zero are replaced with zero only in fast mode (`0 * x` is NaN or -0 for some x), if x has no side effects.
  */
 class TrivialMultiplicationOptimizer : public Optimizer {
 
+private:
+    const FloatingPointMode fpMode;
+
 public:
-    TrivialMultiplicationOptimizer() : Optimizer(true) { }
+    explicit TrivialMultiplicationOptimizer(FloatingPointMode fpMode_) : Optimizer(true), fpMode(fpMode_) { }
     std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
 };
 
 /**
- * Compresses all expressions where all operands are constants
+ * Compresses all expressions where all operands are constants.
+ * It's exact in any floating-point mode, because constants are computed with the same double operations as in the stack machine.
  */
 class ConstantCompressor : public Optimizer {
 
@@ -105,6 +127,28 @@ public:
     std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
 };
 
+/**
+ * Brings arithmetic expressions to the canonical form.
+ *
+ * Negations are pushed down to constants: `x - -y` -> `x + y`, `x + -y` -> `x - y`, `-x * -y` -> `x * y`,
+ * `-(2 * x)` -> `-2 * x`, `-1 * x` -> `-x`. These transformations don't change results of floating-point operations.
+ *
+ * In fast mode chains of additions and multiplications are also flattened and reassociated. Constants are
+ * folded into one constant, that is put to the right of the sum (`(x + 1) + 2` -> `x + 3`) or to the left of the
+ * product (`2 * x * 3` -> `6 * x`), division by constant is replaced with multiplication by its reciprocal
+ * (`x / 4 * 8` -> `2 * x`), and similar terms are collected (`x - -4*x` -> `5 * x`).
+ * Terms and factors with side effects are never dropped and keep their order.
+ */
+class ArithmeticReassociationOptimizer : public Optimizer {
+
+private:
+    const FloatingPointMode fpMode;
+
+public:
+    explicit ArithmeticReassociationOptimizer(FloatingPointMode fpMode_) : Optimizer(true), fpMode(fpMode_) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
 // TODO: TrivialPowerOptimizer (x^0 = 1, x^1 = x, 1^x = 1, maybe x^-y = 1/x^y)
 
 /**
@@ -113,32 +157,13 @@ public:
 class TrivialOperationsOptimizer : public CompositeOptimizer {
 
 public:
-    TrivialOperationsOptimizer() : CompositeOptimizer() {
-        addOptimizer(std::make_shared<TrivialMultiplicationOptimizer>());
-        addOptimizer(std::make_shared<TrivialAdditionOptimizer>());
+    explicit TrivialOperationsOptimizer(FloatingPointMode fpMode) : CompositeOptimizer() {
+        addOptimizer(std::make_shared<TrivialMultiplicationOptimizer>(fpMode));
+        addOptimizer(std::make_shared<TrivialAdditionOptimizer>(fpMode));
         addOptimizer(std::make_shared<ConstantCompressor>());
     }
 
     std::shared_ptr<ASTNode>& optimize(std::shared_ptr<ASTNode>& node) const override;
 };
 
-// TODO: 0 - x -> -x
-// TODO: Push negation operators down to constants and variables. (to eliminate x - -4*x)
-
-// TODO: x + -y -> x - y ; x - -y -> x + y
-
-// TODO: -1 * x -> -x ; x * -1 -> -x (NOTE: Use before ArithmeticNegationOptimizer: -(-1 * X) -> --X -> X; otherwise --X wil be produced) (But what if --1 * --X? It will be optimized to 1 * X, not X)
-/*
- *      ...                ...
- *     /                  /
- *    *        --->      -
- *   / \                 |
- *  /   \                |
- * -    X                X
- * |
- * |
- * 1
- */
-// TODO: -1 * -x -> x ; -x * -1 -> x (Solution of the problem above?)
-
 #endif // AST_BUILDER_AST_OPTIMIZERS_H
@@ -0,0 +1,285 @@
+/**
+ * @file
+ * @brief Implementation of helper functions for AST transformations
+ */
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include "ast-utils.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+static unsigned int nextUniqueNameId = 0u;
+
+static inline void appendSuffix(char* destination, const char* name, const char* suffix) {
+    snprintf(destination, MAX_ID_LENGTH + 1, "%s%s", name, suffix != nullptr ? suffix : "");
+}
+
+static std::vector<std::shared_ptr<ASTNode>> copyChildren(const ASTNode* node, const char* nameSuffix) {
+    std::vector<std::shared_ptr<ASTNode>> children;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        children.push_back(copyAST(node->getChildren()[i], nameSuffix));
+    }
+    return children;
+}
+
+std::shared_ptr<ASTNode> copyAST(const std::shared_ptr<ASTNode>& node, const char* nameSuffix) {
+    assert(node != nullptr);
+
+    const TokenOrigin originPos = node->getOriginPos();
+    const auto children = copyChildren(node.get(), nameSuffix);
+    char name[MAX_ID_LENGTH + 1];
+
+    switch (node->getType()) {
+        case CONSTANT_VALUE_NODE:
+            return std::make_shared<ConstantValueNode>(originPos, dynamic_cast<ConstantValueNode*>(node.get())->getValue());
+        case VARIABLE_NODE:
+            appendSuffix(name, dynamic_cast<VariableNode*>(node.get())->getName(), nameSuffix);
+            return std::make_shared<VariableNode>(originPos, name);
+        case VALUE_NODE:
+            appendSuffix(name, dynamic_cast<ValueNode*>(node.get())->getName(), nameSuffix);
+            return std::make_shared<ValueNode>(originPos, name);
+        case OPERATOR_NODE:
+            return std::make_shared<OperatorNode>(dynamic_cast<OperatorNode*>(node.get())->getToken(), children);
+        case ASSIGNMENT_OPERATOR_NODE:
+            return std::make_shared<AssignmentOperatorNode>(
+                std::make_shared<AssignmentOperatorToken>(originPos),
+                std::dynamic_pointer_cast<VariableNode>(children[0]),
+                children[1]
+            );
+        case COMPARISON_OPERATOR_NODE:
+            return std::make_shared<ComparisonOperatorNode>(dynamic_cast<ComparisonOperatorNode*>(node.get())->getToken(), children[0], children[1]);
+        case STATEMENTS_NODE:
+            return std::make_shared<StatementsNode>(originPos, children);
+        case BLOCK_NODE:
+            return std::make_shared<BlockNode>(originPos, std::dynamic_pointer_cast<StatementsNode>(children[0]));
+        case IF_NODE:
+            return std::make_shared<IfNode>(originPos, std::dynamic_pointer_cast<ComparisonOperatorNode>(children[0]), children[1]);
+        case IF_ELSE_NODE:
+            return std::make_shared<IfElseNode>(originPos, std::dynamic_pointer_cast<ComparisonOperatorNode>(children[0]), children[1], children[2]);
+        case WHILE_NODE:
+            return std::make_shared<WhileNode>(originPos, std::dynamic_pointer_cast<ComparisonOperatorNode>(children[0]), children[1]);
+        case PARAMETERS_LIST_NODE:
+            return std::make_shared<ParametersListNode>(originPos, children);
+        case ARGUMENTS_LIST_NODE:
+            return std::make_shared<ArgumentsListNode>(originPos, children);
+        case FUNCTION_DEFINITION_NODE:
+            return std::make_shared<FunctionDefinitionNode>(
+                dynamic_cast<FunctionDefinitionNode*>(node.get())->getFunctionName(),
+                std::dynamic_pointer_cast<ParametersListNode>(children[0]),
+                std::dynamic_pointer_cast<BlockNode>(children[1])
+            );
+        case FUNCTION_CALL_NODE:
+            return std::make_shared<FunctionCallNode>(
+                dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName(),
+                std::dynamic_pointer_cast<ArgumentsListNode>(children[0])
+            );
+        case VARIABLE_DECLARATION_NODE:
+            if (children.size() == 1) {
+                return std::make_shared<VariableDeclarationNode>(originPos, std::dynamic_pointer_cast<VariableNode>(children[0]));
+            }
+            return std::make_shared<VariableDeclarationNode>(originPos, std::dynamic_pointer_cast<VariableNode>(children[0]), children[1]);
+        case VALUE_DECLARATION_NODE:
+            return std::make_shared<ValueDeclarationNode>(originPos, std::dynamic_pointer_cast<ValueNode>(children[0]), children[1]);
+        case RETURN_STATEMENT_NODE:
+            return std::make_shared<ReturnStatementNode>(originPos, children[0]);
+        default:
+            throw std::logic_error("Unsupported node type");
+    }
+}
+
+bool isEqualAST(const std::shared_ptr<ASTNode>& first, const std::shared_ptr<ASTNode>& second) {
+    if (first->getType() != second->getType() || first->getChildrenNumber() != second->getChildrenNumber()) return false;
+
+    switch (first->getType()) {
+        case CONSTANT_VALUE_NODE: {
+            const double firstValue = dynamic_cast<ConstantValueNode*>(first.get())->getValue();
+            const double secondValue = dynamic_cast<ConstantValueNode*>(second.get())->getValue();
+            if (firstValue < secondValue || firstValue > secondValue) return false;
+            break;
+        }
+        case VARIABLE_NODE:
+        case VALUE_NODE:
+            if (strcmp(getIdentifierName(first.get()), getIdentifierName(second.get())) != 0) return false;
+            break;
+        case OPERATOR_NODE:
+            if (dynamic_cast<OperatorNode*>(first.get())->getToken()->getOperatorType() !=
+                dynamic_cast<OperatorNode*>(second.get())->getToken()->getOperatorType()) return false;
+            break;
+        case COMPARISON_OPERATOR_NODE:
+            if (dynamic_cast<ComparisonOperatorNode*>(first.get())->getToken()->getOperatorType() !=
+                dynamic_cast<ComparisonOperatorNode*>(second.get())->getToken()->getOperatorType()) return false;
+            break;
+        case FUNCTION_CALL_NODE:
+            if (strcmp(dynamic_cast<FunctionCallNode*>(first.get())->getFunctionName()->getName(),
+                       dynamic_cast<FunctionCallNode*>(second.get())->getFunctionName()->getName()) != 0) return false;
+            break;
+        case FUNCTION_DEFINITION_NODE:
+            if (strcmp(dynamic_cast<FunctionDefinitionNode*>(first.get())->getFunctionName()->getName(),
+                       dynamic_cast<FunctionDefinitionNode*>(second.get())->getFunctionName()->getName()) != 0) return false;
+            break;
+        default:
+            break;
+    }
+
+    const size_t childrenNumber = first->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (!isEqualAST(first->getChildren()[i], second->getChildren()[i])) return false;
+    }
+    return true;
+}
+
+size_t countASTNodes(const std::shared_ptr<ASTNode>& node) {
+    size_t nodesNumber = 1;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        nodesNumber += countASTNodes(node->getChildren()[i]);
+    }
+    return nodesNumber;
+}
+
+bool containsNodeOfType(const std::shared_ptr<ASTNode>& node, NodeType type) {
+    if (node->getType() == type) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (containsNodeOfType(node->getChildren()[i], type)) return true;
+    }
+    return false;
+}
+
+bool alwaysReturns(const std::shared_ptr<ASTNode>& statement) {
+    switch (statement->getType()) {
+        case RETURN_STATEMENT_NODE:
+            return true;
+        case BLOCK_NODE:
+            return alwaysReturns(statement->getChildren()[0]);
+        case STATEMENTS_NODE:
+            for (size_t i = 0; i < statement->getChildrenNumber(); ++i) {
+                if (alwaysReturns(statement->getChildren()[i])) return true;
+            }
+            return false;
+        case IF_ELSE_NODE:
+            return alwaysReturns(statement->getChildren()[1]) && alwaysReturns(statement->getChildren()[2]);
+        default:
+            return false;
+    }
+}
+
+char* getIdentifierName(const ASTNode* node) {
+    if (node->getType() == VARIABLE_NODE) return dynamic_cast<const VariableNode*>(node)->getName();
+    if (node->getType() == VALUE_NODE)    return dynamic_cast<const ValueNode*>(node)->getName();
+    return nullptr;
+}
+
+bool isPureInternalFunction(const char* functionName) {
+    return strcmp(functionName, "sqrt") == 0 || strcmp(functionName, "pow") == 0;
+}
+
+bool isSideEffectFree(const std::shared_ptr<ASTNode>& node) {
+    switch (node->getType()) {
+        case ASSIGNMENT_OPERATOR_NODE:
+        case VARIABLE_DECLARATION_NODE:
+        case VALUE_DECLARATION_NODE:
+        case RETURN_STATEMENT_NODE:
+            return false;
+        case FUNCTION_CALL_NODE:
+            if (!isPureInternalFunction(dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName())) return false;
+            break;
+        default:
+            break;
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (!isSideEffectFree(node->getChildren()[i])) return false;
+    }
+    return true;
+}
+
+void generateUniqueName(char* destination, const char* baseName) {
+    snprintf(destination, MAX_ID_LENGTH + 1, "%s.%u", baseName, nextUniqueNameId++);
+}
+
+void generateUniqueFunctionName(char* destination, const char* baseName) {
+    snprintf(destination, MAX_ID_LENGTH + 1, "%s_%u", baseName, nextUniqueNameId++);
+}
+
+size_t getEvaluationCost(const std::shared_ptr<ASTNode>& node) {
+    size_t cost = 0;
+    switch (node->getType()) {
+        case CONSTANT_VALUE_NODE:
+            return 1;
+        case VALUE_NODE:
+            return VARIABLE_READ_COST;
+        case OPERATOR_NODE:
+            cost = dynamic_cast<OperatorNode*>(node.get())->getToken()->getOperatorType() == ARITHMETIC_NEGATION ? 2 : 1;
+            break;
+        case FUNCTION_CALL_NODE:
+            cost = isPureInternalFunction(dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName()) ? 1 : USER_FUNCTION_CALL_COST;
+            break;
+        default:
+            break;
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        cost += getEvaluationCost(node->getChildren()[i]);
+    }
+    return cost;
+}
+
+std::shared_ptr<OperatorNode> makeBinaryOperatorNode(
+    OperatorType operatorType,
+    const std::shared_ptr<ASTNode>& leftChild,
+    const std::shared_ptr<ASTNode>& rightChild
+) {
+    const TokenOrigin originPos = leftChild->getOriginPos();
+    std::shared_ptr<OperatorToken> token = nullptr;
+    switch (operatorType) {
+        case ADDITION:       token = std::make_shared<AdditionOperator>(originPos);       break;
+        case SUBTRACTION:    token = std::make_shared<SubtractionOperator>(originPos);    break;
+        case MULTIPLICATION: token = std::make_shared<MultiplicationOperator>(originPos); break;
+        case DIVISION:       token = std::make_shared<DivisionOperator>(originPos);       break;
+        default:             throw std::logic_error("Operator is not binary");
+    }
+    return std::make_shared<OperatorNode>(token, leftChild, rightChild);
+}
+
+std::shared_ptr<AssignmentOperatorNode> makeAssignmentNode(const char* variableName, const std::shared_ptr<ASTNode>& value) {
+    const TokenOrigin originPos = value->getOriginPos();
+    return std::make_shared<AssignmentOperatorNode>(
+        std::make_shared<AssignmentOperatorToken>(originPos),
+        std::make_shared<VariableNode>(originPos, variableName),
+        value
+    );
+}
+
+std::shared_ptr<VariableDeclarationNode> makeVariableDeclarationNode(TokenOrigin originPos, const char* variableName, const std::shared_ptr<ASTNode>& initialValue) {
+    auto variable = std::make_shared<VariableNode>(originPos, variableName);
+    if (initialValue == nullptr) return std::make_shared<VariableDeclarationNode>(originPos, variable);
+    return std::make_shared<VariableDeclarationNode>(originPos, variable, initialValue);
+}
+
+std::shared_ptr<BlockNode> makeBlockNode(TokenOrigin originPos, const std::vector<std::shared_ptr<ASTNode>>& statements) {
+    return std::make_shared<BlockNode>(originPos, std::make_shared<StatementsNode>(originPos, statements));
+}
+
+std::shared_ptr<ComparisonOperatorNode> makeNegatedComparisonNode(const ComparisonOperatorNode* comparison) {
+    const TokenOrigin originPos = comparison->getOriginPos();
+    std::shared_ptr<ComparisonOperatorToken> token;
+    switch (comparison->getToken()->getOperatorType()) {
+        case LESS:             token = std::make_shared<GreaterOrEqualComparisonOperator>(originPos); break;
+        case LESS_OR_EQUAL:    token = std::make_shared<GreaterComparisonOperator>(originPos);        break;
+        case GREATER:          token = std::make_shared<LessOrEqualComparisonOperator>(originPos);    break;
+        case GREATER_OR_EQUAL: token = std::make_shared<LessComparisonOperator>(originPos);           break;
+        case EQUAL:            token = std::make_shared<NotEqualComparisonOperator>(originPos);       break;
+        case NOT_EQUAL:        token = std::make_shared<EqualComparisonOperator>(originPos);          break;
+        default:               throw std::logic_error("Unknown comparison operator");
+    }
+    return std::make_shared<ComparisonOperatorNode>(token, comparison->getChildren()[0], comparison->getChildren()[1]);
+}
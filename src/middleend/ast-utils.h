@@ -0,0 +1,99 @@
+/**
+ * @file
+ * @brief Definition of helper functions for AST transformations (copying, building, inspecting nodes)
+ */
+#ifndef COMPILER_AST_UTILS_H
+#define COMPILER_AST_UTILS_H
+
+#include <memory>
+#include <vector>
+#include "../frontend/ast.h"
+#include "../util/comparison.h"
+
+// Approximate costs in stack machine instructions. RAM access is much slower than other instructions
+constexpr size_t RAM_ACCESS_COST = 10;
+constexpr size_t VARIABLE_READ_COST = 4 + RAM_ACCESS_COST;
+constexpr size_t VARIABLE_ASSIGNMENT_COST = 8 + RAM_ACCESS_COST;
+constexpr size_t VARIABLE_DECLARATION_COST = 8 + RAM_ACCESS_COST;
+constexpr size_t USER_FUNCTION_CALL_COST = 20 + 4 * RAM_ACCESS_COST;
+
+/**
+ * Creates a deep copy of the given subtree. Tokens are shared between the original and the copy, because they are immutable.
+ * @param node       root of the subtree to copy
+ * @param nameSuffix if not nullptr, it's appended to the name of each variable and value in the copy
+ * @return root of the copied subtree.
+ */
+std::shared_ptr<ASTNode> copyAST(const std::shared_ptr<ASTNode>& node, const char* nameSuffix = nullptr);
+
+/**
+ * Checks if two subtrees are structurally equal (same node types, operators, names, constants and function names).
+ */
+bool isEqualAST(const std::shared_ptr<ASTNode>& first, const std::shared_ptr<ASTNode>& second);
+
+/**
+ * Counts nodes in the given subtree (including the root).
+ */
+size_t countASTNodes(const std::shared_ptr<ASTNode>& node);
+
+/**
+ * Checks if there is a node of the given type in the subtree (including the root).
+ */
+bool containsNodeOfType(const std::shared_ptr<ASTNode>& node, NodeType type);
+
+/**
+ * Checks if the statement returns from function in each case.
+ */
+bool alwaysReturns(const std::shared_ptr<ASTNode>& statement);
+
+/**
+ * Returns name of the variable or value node or nullptr, if node is neither of them.
+ */
+char* getIdentifierName(const ASTNode* node);
+
+/**
+ * Checks if the function with the given name is internal and has no side effects (like 'sqrt' or 'pow').
+ */
+bool isPureInternalFunction(const char* functionName);
+
+/**
+ * Checks if evaluation of the expression can't affect anything except its own result.
+ * Calls of non-internal functions are conservatively considered as side effects.
+ */
+bool isSideEffectFree(const std::shared_ptr<ASTNode>& node);
+
+/**
+ * Writes unique name that can't clash with user-defined names into the destination.
+ * Generated names contain '.', that can't be a part of identifier in the source code.
+ * @param[out] destination buffer of (MAX_ID_LENGTH + 1) bytes
+ * @param[in]  baseName    name to generate unique name from
+ */
+void generateUniqueName(char* destination, const char* baseName);
+
+/**
+ * Writes unique function name that can't clash with user-defined names into the destination.
+ * Generated names contain '_', that can't be a part of identifier in the source code, but (unlike '.') is allowed in labels.
+ * @param[out] destination buffer of (MAX_ID_LENGTH + 1) bytes
+ * @param[in]  baseName    name to generate unique name from
+ */
+void generateUniqueFunctionName(char* destination, const char* baseName);
+
+/**
+ * Estimates cost of the expression evaluation in stack machine instructions (see costs above).
+ */
+size_t getEvaluationCost(const std::shared_ptr<ASTNode>& node);
+
+std::shared_ptr<OperatorNode> makeBinaryOperatorNode(
+    OperatorType operatorType,
+    const std::shared_ptr<ASTNode>& leftChild,
+    const std::shared_ptr<ASTNode>& rightChild
+);
+std::shared_ptr<AssignmentOperatorNode> makeAssignmentNode(const char* variableName, const std::shared_ptr<ASTNode>& value);
+std::shared_ptr<VariableDeclarationNode> makeVariableDeclarationNode(TokenOrigin originPos, const char* variableName, const std::shared_ptr<ASTNode>& initialValue);
+std::shared_ptr<BlockNode> makeBlockNode(TokenOrigin originPos, const std::vector<std::shared_ptr<ASTNode>>& statements);
+
+/**
+ * Builds comparison, that is true if and only if the given one is false (like `a >= b` for `a < b`). Operands are shared.
+ */
+std::shared_ptr<ComparisonOperatorNode> makeNegatedComparisonNode(const ComparisonOperatorNode* comparison);
+
+#endif // COMPILER_AST_UTILS_H
@@ -0,0 +1,22 @@
+/**
+ * @file
+ * @brief Implementation of profile-guided branch layout optimizer
+ */
+#include <memory>
+#include "ast-utils.h"
+#include "branch-layout-optimizer.h"
+#include "profile.h"
+#include "../frontend/ast.h"
+
+std::shared_ptr<ASTNode>& BranchLayoutOptimizer::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (profile == nullptr || node->getType() != IF_ELSE_NODE) return node;
+
+    BranchProfile branch = { LESS, 0, 0 };
+    if (!profile->getBranch(node.get(), branch) || branch.takenNumber <= branch.notTakenNumber) return node;
+
+    const auto children = node->getChildren();
+
+    const auto condition = makeNegatedComparisonNode(dynamic_cast<ComparisonOperatorNode*>(children[0].get()));
+    node = std::make_shared<IfElseNode>(node->getOriginPos(), condition, children[2], children[1]);
+    return node;
+}
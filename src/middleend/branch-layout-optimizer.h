@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @brief Definition of profile-guided branch layout optimizer
+ */
+#ifndef COMPILER_BRANCH_LAYOUT_OPTIMIZER_H
+#define COMPILER_BRANCH_LAYOUT_OPTIMIZER_H
+
+#include <memory>
+#include "ast-optimizers.h"
+#include "profile.h"
+#include "../frontend/ast.h"
+
+/**
+ * Reorders branches of if-else statements, so the branch, that is executed more often according to the profile, is the 'else' branch.
+ *
+ * The 'if' branch is followed by the jump over the 'else' branch, so the 'else' branch is cheaper to execute:
+ *
+ *     if (x < 0) {       --->      if (x >= 0) {
+ *         hot branch                   cold branch
+ *     } else {                     } else {
+ *         cold branch                  hot branch
+ *     }                            }
+ */
+class BranchLayoutOptimizer : public Optimizer {
+
+private:
+    const std::shared_ptr<const Profile> profile;
+
+public:
+    explicit BranchLayoutOptimizer(const std::shared_ptr<const Profile>& profile_) : Optimizer(true), profile(profile_) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_BRANCH_LAYOUT_OPTIMIZER_H
@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief Implementation of program call graph
+ */
+#include <algorithm>
+#include <cassert>
+#include <set>
+#include <vector>
+#include "call-graph.h"
+
+CallGraph::CallGraph(const std::shared_ptr<ASTNode>& program) {
+    assert(program != nullptr);
+
+    std::set<const char*, keyCompare> redefinedFunctions;
+    const size_t statementsNumber = program->getChildrenNumber();
+    for (size_t i = 0; i < statementsNumber; ++i) {
+        const auto& statement = program->getChildren()[i];
+        if (statement->getType() != FUNCTION_DEFINITION_NODE) continue;
+
+        const char* name = dynamic_cast<FunctionDefinitionNode*>(statement.get())->getFunctionName()->getName();
+        if (functions.count(name) != 0) {
+            redefinedFunctions.insert(name);
+            continue;
+        }
+        functions[name] = { statement, i, 0, { }, 0, false };
+    }
+    for (const auto& name : redefinedFunctions) {
+        functions.erase(name);
+    }
+
+    for (auto& function : functions) {
+        addCalls(function.first, function.second.definition);
+    }
+
+    ComponentSearchState state;
+    for (const auto& function : functions) {
+        if (state.indices.count(function.first) == 0) findComponents(function.first, state);
+    }
+}
+
+/**
+ * Tarjan's algorithm. Components are found in reverse topological order of the condensed graph, i.e. bottom-up.
+ */
+void CallGraph::findComponents(const char* name, ComponentSearchState& state) {
+    const size_t index = state.indices.size();
+    state.indices[name] = index;
+    state.lowLinks[name] = index;
+    state.stack.push_back(name);
+    state.stackedFunctions.insert(name);
+
+    for (const char* callee : functions.at(name).callees) {
+        if (state.indices.count(callee) == 0) {
+            findComponents(callee, state);
+            state.lowLinks[name] = std::min(state.lowLinks[name], state.lowLinks[callee]);
+        } else if (state.stackedFunctions.count(callee) != 0) {
+            state.lowLinks[name] = std::min(state.lowLinks[name], state.indices[callee]);
+        }
+    }
+    if (state.lowLinks[name] != index) return;
+
+    std::vector<const char*> component;
+    const char* member = nullptr;
+    do {
+        member = state.stack.back();
+        state.stack.pop_back();
+        state.stackedFunctions.erase(member);
+        functions.at(member).componentIndex = components.size();
+        component.push_back(member);
+    } while (strcmp(member, name) != 0);
+
+    std::sort(component.begin(), component.end(), [this](const char* first, const char* second) {
+        return functions.at(first).position < functions.at(second).position;
+    });
+    components.push_back(component);
+}
+
+void CallGraph::addCalls(const char* callerName, const std::shared_ptr<ASTNode>& node) {
+    if (node->getType() == FUNCTION_CALL_NODE) {
+        const char* calleeName = dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName();
+        auto callee = functions.find(calleeName);
+        if (callee != functions.end()) {
+            ++callee->second.callSitesNumber;
+
+            if (strcmp(callerName, calleeName) == 0) functions.at(callerName).callsItself = true;
+            auto& callees = functions.at(callerName).callees;
+            bool isKnownCallee = false;
+            for (const char* knownCallee : callees) {
+                if (strcmp(knownCallee, calleeName) == 0) isKnownCallee = true;
+            }
+            if (!isKnownCallee) callees.push_back(callee->first);
+        }
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        addCalls(callerName, node->getChildren()[i]);
+    }
+}
+
+bool CallGraph::hasFunction(const char* name) const {
+    assert(name != nullptr);
+
+    return functions.count(name) != 0;
+}
+
+std::vector<const char*> CallGraph::getFunctionNames() const {
+    std::vector<const char*> names;
+    for (const auto& function : functions) {
+        names.push_back(function.first);
+    }
+    return names;
+}
+
+FunctionDefinitionNode* CallGraph::getFunctionDefinition(const char* name) const {
+    return dynamic_cast<FunctionDefinitionNode*>(functions.at(name).definition.get());
+}
+
+size_t CallGraph::getFunctionPosition(const char* name) const {
+    return functions.at(name).position;
+}
+
+size_t CallGraph::getCallSitesNumber(const char* name) const {
+    return functions.at(name).callSitesNumber;
+}
+
+const std::vector<const char*>& CallGraph::getCallees(const char* name) const {
+    return functions.at(name).callees;
+}
+
+bool CallGraph::isRecursive(const char* name) const {
+    const FunctionInfo& function = functions.at(name);
+    return function.callsItself || components[function.componentIndex].size() > 1;
+}
+
+const std::vector<std::vector<const char*>>& CallGraph::getBottomUpComponents() const {
+    return components;
+}
+
+size_t CallGraph::getComponentIndex(const char* name) const {
+    return functions.at(name).componentIndex;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @brief Definition of program call graph. Used by interprocedural optimizations.
+ */
+#ifndef COMPILER_CALL_GRAPH_H
+#define COMPILER_CALL_GRAPH_H
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+#include "../frontend/ast.h"
+
+/**
+ * Call graph of the program. Nodes are user-defined functions, edges are calls between them.
+ *
+ * Internal functions (like 'print' or 'sqrt') and undeclared functions are not included in the graph.
+ * Functions that are defined more than once are not included too, because such program is invalid anyway.
+ *
+ * Graph is built once and is not updated on AST changes, so it should be rebuilt after each transformation that adds or removes calls.
+ *
+ * Functions are also grouped into strongly connected components (functions, that call each other directly or through
+ * other functions), which are ordered bottom-up: each component goes after the components of all functions it calls.
+ * So interprocedural optimizations can process callees before their callers (or vice versa) even if calls of functions,
+ * defined below the caller, form cycles.
+ */
+class CallGraph {
+
+private:
+    struct keyCompare {
+        bool operator()(const char* a, const char* b) const {
+            return strcmp(a, b) < 0;
+        }
+    };
+
+    struct FunctionInfo {
+        std::shared_ptr<ASTNode> definition;
+        size_t position;
+        size_t callSitesNumber;
+        std::vector<const char*> callees; // Unique names of the called user-defined functions
+        size_t componentIndex;
+        bool callsItself;
+    };
+
+    struct ComponentSearchState {
+        std::map<const char*, size_t, keyCompare> indices;
+        std::map<const char*, size_t, keyCompare> lowLinks;
+        std::vector<const char*> stack;
+        std::set<const char*, keyCompare> stackedFunctions;
+    };
+
+    std::map<const char*, FunctionInfo, keyCompare> functions;
+    std::vector<std::vector<const char*>> components; // Strongly connected components in bottom-up order
+
+    void addCalls(const char* callerName, const std::shared_ptr<ASTNode>& node);
+    void findComponents(const char* name, ComponentSearchState& state);
+
+public:
+    /**
+     * Builds call graph for the given program.
+     * @param program root of the program AST (statements node containing function definitions)
+     */
+    explicit CallGraph(const std::shared_ptr<ASTNode>& program);
+
+    bool hasFunction(const char* name) const;
+
+    /** Returns names of all functions in the graph */
+    std::vector<const char*> getFunctionNames() const;
+
+    /** Returns definition node of the function. Function should be in the graph (see hasFunction). */
+    FunctionDefinitionNode* getFunctionDefinition(const char* name) const;
+
+    /** Returns index of the function definition among the program statements */
+    size_t getFunctionPosition(const char* name) const;
+
+    /** Returns number of calls of the function in the whole program */
+    size_t getCallSitesNumber(const char* name) const;
+
+    const std::vector<const char*>& getCallees(const char* name) const;
+
+    /** Checks if function can call itself directly or through other functions */
+    bool isRecursive(const char* name) const;
+
+    /**
+     * Returns strongly connected components of the graph in bottom-up order: functions of each component call only
+     * functions of the same or previous components. Functions in the component are ordered by their positions.
+     */
+    const std::vector<std::vector<const char*>>& getBottomUpComponents() const;
+
+    /** Returns index of the function component in the bottom-up order (see getBottomUpComponents) */
+    size_t getComponentIndex(const char* name) const;
+};
+
+#endif // COMPILER_CALL_GRAPH_H
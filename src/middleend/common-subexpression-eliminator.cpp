@@ -0,0 +1,242 @@
+/**
+ * @file
+ * @brief Implementation of common subexpression eliminator
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "common-subexpression-eliminator.h"
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+typedef std::vector<std::shared_ptr<ASTNode>*> Occurrences;
+
+static inline bool isCandidate(const std::shared_ptr<ASTNode>& node, const EffectAnalysis& effects) {
+    return (node->getType() == OPERATOR_NODE || node->getType() == FUNCTION_CALL_NODE) && effects.isSideEffectFree(node);
+}
+
+static void collectCandidates(std::shared_ptr<ASTNode>& node, Occurrences& candidates, const EffectAnalysis& effects) {
+    if (isCandidate(node, effects)) candidates.push_back(&node);
+
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        collectCandidates(children[i], candidates, effects);
+    }
+}
+
+static void collectReadVariables(const std::shared_ptr<ASTNode>& node, std::vector<const char*>& variables) {
+    if (node->getType() == VALUE_NODE) variables.push_back(getIdentifierName(node.get()));
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        collectReadVariables(node->getChildren()[i], variables);
+    }
+}
+
+static inline bool containsName(const std::vector<const char*>& names, const char* name) {
+    for (const char* other : names) {
+        if (strcmp(other, name) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * Checks if any of the variables is assigned or declared in the subtree.
+ */
+static bool isKilledIn(const std::shared_ptr<ASTNode>& node, const std::vector<const char*>& variables) {
+    if (node->getType() == VARIABLE_NODE && containsName(variables, getIdentifierName(node.get()))) return true;
+    if (node->getType() == VALUE_DECLARATION_NODE && containsName(variables, getIdentifierName(node->getChildren()[0].get()))) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (isKilledIn(node->getChildren()[i], variables)) return true;
+    }
+    return false;
+}
+
+static void findOccurrences(std::shared_ptr<ASTNode>& node, const std::shared_ptr<ASTNode>& expression, Occurrences& occurrences) {
+    if (isEqualAST(node, expression)) {
+        occurrences.push_back(&node);
+        return;
+    }
+
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        findOccurrences(children[i], expression, occurrences);
+    }
+}
+
+static bool findAvailableOccurrences(
+    std::shared_ptr<ASTNode>& statements, size_t from,
+    const std::shared_ptr<ASTNode>& expression, const std::vector<const char*>& variables, Occurrences& occurrences
+);
+
+/**
+ * Finds occurrences of the expression in the statement, where the expression is still available.
+ * @return false, if the expression is not available after the statement.
+ */
+static bool findAvailableOccurrences(
+    std::shared_ptr<ASTNode>& statement,
+    const std::shared_ptr<ASTNode>& expression, const std::vector<const char*>& variables, Occurrences& occurrences
+) {
+    const auto children = statement->getChildren();
+    switch (statement->getType()) {
+        case ASSIGNMENT_OPERATOR_NODE:
+        case VALUE_DECLARATION_NODE:
+        case VARIABLE_DECLARATION_NODE:
+            if (statement->getChildrenNumber() == 2) findOccurrences(children[1], expression, occurrences);
+            return !containsName(variables, getIdentifierName(children[0].get()));
+        case IF_NODE:
+            findOccurrences(children[0], expression, occurrences);
+            return findAvailableOccurrences(children[1], expression, variables, occurrences);
+        case IF_ELSE_NODE: {
+            findOccurrences(children[0], expression, occurrences);
+            const bool isAvailableAfterIf = findAvailableOccurrences(children[1], expression, variables, occurrences);
+            const bool isAvailableAfterElse = findAvailableOccurrences(children[2], expression, variables, occurrences);
+            return isAvailableAfterIf && isAvailableAfterElse;
+        }
+        case WHILE_NODE:
+            // Condition and body are evaluated after the previous iterations, so nothing is available in the loop that kills the expression
+            if (isKilledIn(statement, variables)) return false;
+            findOccurrences(statement, expression, occurrences);
+            return true;
+        case BLOCK_NODE:
+            return findAvailableOccurrences(children[0], 0, expression, variables, occurrences);
+        default:
+            findOccurrences(statement, expression, occurrences);
+            return true;
+    }
+}
+
+static bool findAvailableOccurrences(
+    std::shared_ptr<ASTNode>& statements, size_t from,
+    const std::shared_ptr<ASTNode>& expression, const std::vector<const char*>& variables, Occurrences& occurrences
+) {
+    const auto children = statements->getChildren();
+    for (size_t i = from; i < statements->getChildrenNumber(); ++i) {
+        if (!findAvailableOccurrences(children[i], expression, variables, occurrences)) return false;
+    }
+    return true;
+}
+
+static std::shared_ptr<ASTNode>* getEvaluatedExpression(std::shared_ptr<ASTNode>& statement) {
+    switch (statement->getType()) {
+        case ASSIGNMENT_OPERATOR_NODE:
+        case VALUE_DECLARATION_NODE:
+            return &statement->getChildren()[1];
+        case VARIABLE_DECLARATION_NODE:
+            return statement->getChildrenNumber() == 2 ? &statement->getChildren()[1] : nullptr;
+        case RETURN_STATEMENT_NODE:
+        case IF_NODE:
+        case IF_ELSE_NODE:
+            return &statement->getChildren()[0];
+        case WHILE_NODE:
+        case BLOCK_NODE:
+            return nullptr;
+        default:
+            return &statement;
+    }
+}
+
+static void replaceOccurrences(const Occurrences& occurrences, const char* name) {
+    for (auto occurrence : occurrences) {
+        *occurrence = std::make_shared<ValueNode>((*occurrence)->getOriginPos(), name);
+    }
+}
+
+/**
+ * Tries to eliminate occurrences of the expression, that is evaluated in the statement with the given index.
+ * @return true, if the AST was changed.
+ */
+static bool eliminateExpression(std::shared_ptr<ASTNode>& statements, size_t index, std::shared_ptr<ASTNode>& expression) {
+    auto& statement = statements->getChildren()[index];
+    std::vector<const char*> variables;
+    collectReadVariables(expression, variables);
+    const size_t expressionCost = getEvaluationCost(expression);
+
+    // If the whole expression is saved to the variable, this variable can be reused while it's not changed
+    const bool isSavedToVariable = (statement->getType() == ASSIGNMENT_OPERATOR_NODE ||
+                                    statement->getType() == VALUE_DECLARATION_NODE ||
+                                    statement->getType() == VARIABLE_DECLARATION_NODE) &&
+                                   statement->getChildrenNumber() == 2 && &statement->getChildren()[1] == &expression;
+    if (isSavedToVariable) {
+        const char* holderName = getIdentifierName(statement->getChildren()[0].get());
+        if (containsName(variables, holderName)) return false;
+        variables.push_back(holderName);
+
+        Occurrences occurrences;
+        findAvailableOccurrences(statements, index + 1, expression, variables, occurrences);
+        if (occurrences.empty() || expressionCost <= VARIABLE_READ_COST) return false;
+
+        replaceOccurrences(occurrences, holderName);
+        return true;
+    }
+
+    Occurrences occurrences;
+    if (findAvailableOccurrences(statement, expression, variables, occurrences)) {
+        findAvailableOccurrences(statements, index + 1, expression, variables, occurrences);
+    }
+    const size_t occurrencesNumber = occurrences.size();
+    if (occurrencesNumber < 2) return false;
+    if (occurrencesNumber * expressionCost <= expressionCost + VARIABLE_DECLARATION_COST + occurrencesNumber * VARIABLE_READ_COST) return false;
+
+    char temporaryName[MAX_ID_LENGTH + 1];
+    generateUniqueName(temporaryName, "cse");
+    auto declaration = makeVariableDeclarationNode(expression->getOriginPos(), temporaryName, copyAST(expression));
+    replaceOccurrences(occurrences, temporaryName);
+
+    std::vector<std::shared_ptr<ASTNode>> newStatements(statements->getChildren(), statements->getChildren() + statements->getChildrenNumber());
+    newStatements.insert(newStatements.begin() + index, declaration);
+    statements = std::make_shared<StatementsNode>(statements->getOriginPos(), newStatements);
+    return true;
+}
+
+static bool eliminateInStatements(std::shared_ptr<ASTNode>& statements, const EffectAnalysis& effects);
+
+static bool eliminateInNestedStatements(std::shared_ptr<ASTNode>& statement, const EffectAnalysis& effects) {
+    switch (statement->getType()) {
+        case BLOCK_NODE:
+            return eliminateInStatements(statement->getChildren()[0], effects);
+        case IF_NODE:
+        case WHILE_NODE:
+            return eliminateInNestedStatements(statement->getChildren()[1], effects);
+        case IF_ELSE_NODE:
+            return eliminateInNestedStatements(statement->getChildren()[1], effects) ||
+                   eliminateInNestedStatements(statement->getChildren()[2], effects);
+        default:
+            return false;
+    }
+}
+
+/**
+ * Eliminates one common subexpression in the statements (or nested statements).
+ * @return true, if the AST was changed.
+ */
+static bool eliminateInStatements(std::shared_ptr<ASTNode>& statements, const EffectAnalysis& effects) {
+    for (size_t i = 0; i < statements->getChildrenNumber(); ++i) {
+        auto& statement = statements->getChildren()[i];
+        std::shared_ptr<ASTNode>* evaluatedExpression = getEvaluatedExpression(statement);
+        if (evaluatedExpression != nullptr) {
+            // Candidates are collected from the biggest to the smallest, so the biggest common expressions are eliminated first
+            Occurrences candidates;
+            collectCandidates(*evaluatedExpression, candidates, effects);
+            for (auto candidate : candidates) {
+                if (eliminateExpression(statements, i, *candidate)) return true;
+            }
+        }
+        if (eliminateInNestedStatements(statement, effects)) return true;
+    }
+    return false;
+}
+
+std::shared_ptr<ASTNode>& CommonSubexpressionEliminator::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != FUNCTION_DEFINITION_NODE) return node;
+
+    auto& body = node->getChildren()[1];
+    while (eliminateInStatements(body->getChildren()[0], *effects)) { }
+    return node;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief Definition of common subexpression eliminator
+ */
+#ifndef COMPILER_COMMON_SUBEXPRESSION_ELIMINATOR_H
+#define COMPILER_COMMON_SUBEXPRESSION_ELIMINATOR_H
+
+#include <memory>
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Replaces repeated side-effect free expressions with reads of the variable, that holds the value of the expression:
+ *
+ *     val d = b*b - 4*a*c;                 --->      val d = b*b - 4*a*c;
+ *     if (b*b - 4*a*c > 0) { ... }                   if (d > 0) { ... }
+ *
+ *     x = (b*b - a*c) / 2;                 --->      var cse.1 = b*b - a*c;
+ *     y = (b*b - a*c) / 3;                           x = cse.1 / 2;
+ *                                                    y = cse.1 / 3;
+ *
+ * Expression is available from the statement, where it's evaluated, until any of its variables is assigned or redeclared.
+ * Availability flows into the nested blocks and both branches of 'if' statements; after 'if' it's available, if it's not
+ * killed in any branch. Expressions are not available in the loops that assign their variables.
+ *
+ * Calls of pure user-defined functions without loops and recursion (see EffectAnalysis) can be eliminated too.
+ *
+ * Each replacement is done only if it's profitable: reading of a variable costs a RAM access, so simple expressions
+ * like `2 * a` are cheaper to recompute than to save to RAM and read back.
+ */
+class CommonSubexpressionEliminator : public EffectAwareOptimizer {
+
+public:
+    CommonSubexpressionEliminator() : EffectAwareOptimizer(false) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_COMMON_SUBEXPRESSION_ELIMINATOR_H
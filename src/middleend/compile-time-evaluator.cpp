@@ -0,0 +1,37 @@
+/**
+ * @file
+ * @brief Implementation of compile-time evaluator of function calls
+ */
+#include <memory>
+#include "compile-time-evaluator.h"
+#include "effect-analysis.h"
+#include "interpreter.h"
+#include "../frontend/ast.h"
+
+/**
+ * Interpreter of pure functions. Calls of functions with side effects fail the evaluation.
+ */
+class PureFunctionInterpreter : public Interpreter {
+
+private:
+    const EffectAnalysis& effects;
+
+protected:
+    bool canCall(const char* functionName) const override {
+        return effects.isPure(functionName);
+    }
+
+public:
+    PureFunctionInterpreter(const EffectAnalysis& effects_, size_t maxSteps_, size_t maxCallDepth_) :
+        Interpreter(effects_.getCallGraph(), maxSteps_, maxCallDepth_), effects(effects_) { }
+};
+
+std::shared_ptr<ASTNode>& CompileTimeEvaluator::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != FUNCTION_CALL_NODE) return node;
+    if (!effects->isPure(dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName())) return node;
+
+    PureFunctionInterpreter interpreter(*effects, MAX_EVALUATION_STEPS, MAX_CALL_DEPTH);
+    double result = 0;
+    if (interpreter.evaluate(node, result)) node = std::make_shared<ConstantValueNode>(node->getOriginPos(), result);
+    return node;
+}
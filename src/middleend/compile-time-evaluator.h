@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @brief Definition of compile-time evaluator of function calls
+ */
+#ifndef COMPILER_COMPILE_TIME_EVALUATOR_H
+#define COMPILER_COMPILE_TIME_EVALUATOR_H
+
+#include <memory>
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Replaces calls of pure functions with constant arguments (like `fib(10)` or `sqrt(2)`) with their results.
+ * Should be applied to the root of the program.
+ *
+ * Calls are evaluated by interpreting the AST of the called functions (see Interpreter). Internal functions 'sqrt' and 'pow'
+ * are evaluated natively. Evaluation is abandoned (and the call is kept), if it:
+ *     -# takes more than MAX_EVALUATION_STEPS steps or makes calls deeper than MAX_CALL_DEPTH;
+ *     -# needs more variables than fit in the stack machine RAM;
+ *     -# calls impure or unknown function or gets not finite result.
+ * So errors, that happen at run time (like RAM overflow), are not hidden.
+ */
+class CompileTimeEvaluator : public EffectAwareOptimizer {
+
+private:
+    static constexpr size_t MAX_EVALUATION_STEPS = 1000000;
+    static constexpr size_t MAX_CALL_DEPTH = 32;
+
+public:
+    CompileTimeEvaluator() : EffectAwareOptimizer(true) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_COMPILE_TIME_EVALUATOR_H
@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief Implementation of dead code eliminator
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "dead-code-eliminator.h"
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+enum ConditionValue {
+    ALWAYS_FALSE,
+    ALWAYS_TRUE,
+    UNKNOWN,
+};
+
+static ConditionValue getConditionValue(const std::shared_ptr<ASTNode>& condition) {
+    const auto& left = condition->getChildren()[0];
+    const auto& right = condition->getChildren()[1];
+    if (left->getType() != CONSTANT_VALUE_NODE || right->getType() != CONSTANT_VALUE_NODE) return UNKNOWN;
+
+    const bool value = evaluateComparison(
+        dynamic_cast<ComparisonOperatorNode*>(condition.get())->getToken()->getOperatorType(),
+        dynamic_cast<ConstantValueNode*>(left.get())->getValue(),
+        dynamic_cast<ConstantValueNode*>(right.get())->getValue()
+    );
+    return value ? ALWAYS_TRUE : ALWAYS_FALSE;
+}
+
+static inline bool isExpressionStatement(const std::shared_ptr<ASTNode>& statement) {
+    switch (statement->getType()) {
+        case CONSTANT_VALUE_NODE:
+        case VALUE_NODE:
+        case OPERATOR_NODE:
+        case FUNCTION_CALL_NODE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Replaces `if` and `while` statements with constant conditions by the executed branch.
+ * @return statement to keep or nullptr, if statement is never executed.
+ */
+static std::shared_ptr<ASTNode> eliminateConstantCondition(const std::shared_ptr<ASTNode>& statement) {
+    switch (statement->getType()) {
+        case IF_NODE:
+            switch (getConditionValue(statement->getChildren()[0])) {
+                case ALWAYS_TRUE:  return statement->getChildren()[1];
+                case ALWAYS_FALSE: return nullptr;
+                default:           return statement;
+            }
+        case IF_ELSE_NODE:
+            switch (getConditionValue(statement->getChildren()[0])) {
+                case ALWAYS_TRUE:  return statement->getChildren()[1];
+                case ALWAYS_FALSE: return statement->getChildren()[2];
+                default:           return statement;
+            }
+        case WHILE_NODE:
+            return getConditionValue(statement->getChildren()[0]) == ALWAYS_FALSE ? nullptr : statement;
+        default:
+            return statement;
+    }
+}
+
+static inline bool isEndless(const std::shared_ptr<ASTNode>& statement) {
+    return statement->getType() == WHILE_NODE && getConditionValue(statement->getChildren()[0]) == ALWAYS_TRUE;
+}
+
+static bool containsIdentifier(const std::shared_ptr<ASTNode>& node, const char* name) {
+    const char* identifierName = getIdentifierName(node.get());
+    if (identifierName != nullptr && strcmp(identifierName, name) == 0) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (containsIdentifier(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+static inline bool isUnusedDeclaration(
+    const std::shared_ptr<ASTNode>& statement,
+    const std::vector<std::shared_ptr<ASTNode>>& nextStatements,
+    const EffectAnalysis& effects
+) {
+    if (statement->getType() != VARIABLE_DECLARATION_NODE && statement->getType() != VALUE_DECLARATION_NODE) return false;
+    if (statement->getChildrenNumber() == 2 && !effects.isSideEffectFree(statement->getChildren()[1])) return false;
+
+    // Any mention of the name (even in the nested blocks, where it can be shadowed) is considered as a usage
+    const char* name = getIdentifierName(statement->getChildren()[0].get());
+    for (const auto& nextStatement : nextStatements) {
+        if (containsIdentifier(nextStatement, name)) return false;
+    }
+    return true;
+}
+
+std::shared_ptr<ASTNode>& DeadCodeEliminator::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != STATEMENTS_NODE) return node;
+
+    std::vector<std::shared_ptr<ASTNode>> reachableStatements;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        auto statement = eliminateConstantCondition(node->getChildren()[i]);
+        if (statement == nullptr) continue;
+        if (isExpressionStatement(statement) && effects->isSideEffectFree(statement)) continue;
+
+        reachableStatements.push_back(statement);
+        if (alwaysReturns(statement) || isEndless(statement)) break;
+    }
+
+    // Declarations are checked from the end, so declarations used only by unused declarations are removed too
+    std::vector<std::shared_ptr<ASTNode>> usedStatements;
+    for (size_t i = reachableStatements.size(); i > 0; --i) {
+        if (!isUnusedDeclaration(reachableStatements[i - 1], usedStatements, *effects)) {
+            usedStatements.insert(usedStatements.begin(), reachableStatements[i - 1]);
+        }
+    }
+
+    node = std::make_shared<StatementsNode>(node->getOriginPos(), usedStatements);
+    return node;
+}
@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @brief Definition of dead code eliminator
+ */
+#ifndef COMPILER_DEAD_CODE_ELIMINATOR_H
+#define COMPILER_DEAD_CODE_ELIMINATOR_H
+
+#include <memory>
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Removes statements that are never executed or whose execution doesn't affect anything:
+ *     -# Statements after `return` (and after `while` with always true condition, because it never ends without return);
+ *     -# Expression statements without side effects (e.g. `x + 1;`), their results are just popped from the stack
+ *        (calls of pure user-defined functions without loops and recursion are side effect free, see EffectAnalysis);
+ *     -# `if` and `while` statements, whose conditions compare two constants, are replaced with the executed branch (or removed);
+ *     -# Declarations of variables and values, that are never used, if their initializers have no side effects.
+ *
+ * Should be applied after ConstantCompressor, so constant conditions are already folded.
+ */
+class DeadCodeEliminator : public EffectAwareOptimizer {
+
+public:
+    DeadCodeEliminator() : EffectAwareOptimizer(true) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_DEAD_CODE_ELIMINATOR_H
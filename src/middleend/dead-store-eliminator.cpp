@@ -0,0 +1,153 @@
+/**
+ * @file
+ * @brief Implementation of dead store eliminator
+ */
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "ast-utils.h"
+#include "dead-store-eliminator.h"
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+// Names are copied, because removed statements are destroyed during the analysis
+typedef std::set<std::string> LiveVariables;
+
+static void addReads(const std::shared_ptr<ASTNode>& node, LiveVariables& live) {
+    if (node->getType() == VALUE_NODE) live.insert(getIdentifierName(node.get()));
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        addReads(node->getChildren()[i], live);
+    }
+}
+
+/**
+ * Transforms variables, that are live after the statement, to variables, that are live before it.
+ * If isTransforming is true, dead stores are removed from the statement (it's replaced with nullptr, if nothing is left).
+ */
+static void eliminateInStatement(
+    std::shared_ptr<ASTNode>& statement,
+    LiveVariables& live,
+    bool isTransforming,
+    bool& hasChanges,
+    const EffectAnalysis& effects
+);
+
+static void eliminateInStatements(
+    std::shared_ptr<ASTNode>& statements,
+    LiveVariables& live,
+    bool isTransforming,
+    bool& hasChanges,
+    const EffectAnalysis& effects
+) {
+    bool hasRemovedStatements = false;
+    const size_t childrenNumber = statements->getChildrenNumber();
+    for (size_t i = childrenNumber; i > 0; --i) {
+        eliminateInStatement(statements->getChildren()[i - 1], live, isTransforming, hasChanges, effects);
+        if (statements->getChildren()[i - 1] == nullptr) hasRemovedStatements = true;
+    }
+    if (!hasRemovedStatements) return;
+
+    std::vector<std::shared_ptr<ASTNode>> remainingStatements;
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (statements->getChildren()[i] != nullptr) remainingStatements.push_back(statements->getChildren()[i]);
+    }
+    statements = std::make_shared<StatementsNode>(statements->getOriginPos(), remainingStatements);
+}
+
+static void eliminateInStatement(
+    std::shared_ptr<ASTNode>& statement,
+    LiveVariables& live,
+    bool isTransforming,
+    bool& hasChanges,
+    const EffectAnalysis& effects
+) {
+    const auto children = statement->getChildren();
+    switch (statement->getType()) {
+        case ASSIGNMENT_OPERATOR_NODE: {
+            const char* name = getIdentifierName(children[0].get());
+            const auto value = children[1];
+            if (isTransforming && live.count(name) == 0) {
+                statement = effects.isSideEffectFree(value) ? nullptr : value;
+                hasChanges = true;
+            } else {
+                live.erase(name);
+            }
+            addReads(value, live);
+            return;
+        }
+        case VARIABLE_DECLARATION_NODE:
+        case VALUE_DECLARATION_NODE:
+            live.erase(getIdentifierName(children[0].get()));
+            if (statement->getChildrenNumber() == 2) addReads(children[1], live);
+            return;
+        case RETURN_STATEMENT_NODE:
+            live.clear();
+            addReads(children[0], live);
+            return;
+        case IF_NODE: {
+            LiveVariables bodyLive = live;
+            eliminateInStatement(children[1], bodyLive, isTransforming, hasChanges, effects);
+            live.insert(bodyLive.begin(), bodyLive.end());
+            addReads(children[0], live);
+            return;
+        }
+        case IF_ELSE_NODE: {
+            LiveVariables elseLive = live;
+            eliminateInStatement(children[1], live, isTransforming, hasChanges, effects);
+            eliminateInStatement(children[2], elseLive, isTransforming, hasChanges, effects);
+            live.insert(elseLive.begin(), elseLive.end());
+            addReads(children[0], live);
+            return;
+        }
+        case WHILE_NODE: {
+            // Variables live before the condition are live after the body too
+            LiveVariables loopLive = live;
+            addReads(children[0], loopLive);
+            while (true) {
+                LiveVariables bodyLive = loopLive;
+                eliminateInStatement(children[1], bodyLive, false, hasChanges, effects);
+                const size_t liveNumber = loopLive.size();
+                loopLive.insert(bodyLive.begin(), bodyLive.end());
+                if (loopLive.size() == liveNumber) break;
+            }
+            if (isTransforming) {
+                LiveVariables bodyLive = loopLive;
+                eliminateInStatement(children[1], bodyLive, true, hasChanges, effects);
+            }
+            live = loopLive;
+            return;
+        }
+        case BLOCK_NODE: {
+            // Variables declared in the block shadow the outer ones, so their outer liveness passes through the block
+            LiveVariables outerLive;
+            const auto& statements = children[0];
+            for (size_t i = 0; i < statements->getChildrenNumber(); ++i) {
+                const auto& nested = statements->getChildren()[i];
+                const bool isDeclaration = nested->getType() == VARIABLE_DECLARATION_NODE || nested->getType() == VALUE_DECLARATION_NODE;
+                const char* name = isDeclaration ? getIdentifierName(nested->getChildren()[0].get()) : nullptr;
+                if (name != nullptr && live.count(name) != 0) outerLive.insert(name);
+            }
+            eliminateInStatements(children[0], live, isTransforming, hasChanges, effects);
+            live.insert(outerLive.begin(), outerLive.end());
+            return;
+        }
+        case STATEMENTS_NODE:
+            eliminateInStatements(statement, live, isTransforming, hasChanges, effects);
+            return;
+        default:
+            addReads(statement, live);
+            return;
+    }
+}
+
+std::shared_ptr<ASTNode>& DeadStoreEliminator::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != FUNCTION_DEFINITION_NODE) return node;
+
+    bool hasChanges = false;
+    LiveVariables live;
+    eliminateInStatement(node->getChildren()[1], live, true, hasChanges, *effects);
+    return node;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file
+ * @brief Definition of dead store eliminator
+ */
+#ifndef COMPILER_DEAD_STORE_ELIMINATOR_H
+#define COMPILER_DEAD_STORE_ELIMINATOR_H
+
+#include <memory>
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Removes assignments of local variables, whose values are never read before the next assignment or the function end:
+ *
+ *     x = a * 2;                    --->
+ *     x = b;                                  x = b;
+ *     print(x);                               print(x);
+ *
+ * Liveness of the variables is computed backwards over the function body: both branches of 'if' statements are merged,
+ * while loops are iterated until the fixed point, variables are dead after `return`.
+ * If the assigned expression has side effects (see EffectAnalysis), it's kept as an expression statement.
+ *
+ * Removed stores can leave unused declarations, so DeadCodeEliminator should be applied after it.
+ */
+class DeadStoreEliminator : public EffectAwareOptimizer {
+
+public:
+    DeadStoreEliminator() : EffectAwareOptimizer(false) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_DEAD_STORE_ELIMINATOR_H
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @brief Implementation of effect analysis of the functions
+ */
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "effect-analysis.h"
+
+static constexpr FunctionEffects UNKNOWN_FUNCTION_EFFECTS = { true, true, true, true };
+
+static inline bool isInternalFunction(const char* name) {
+    return strcmp(name, "read") == 0 || strcmp(name, "print") == 0 || isPureInternalFunction(name);
+}
+
+static inline FunctionEffects getInternalFunctionEffects(const char* name) {
+    return { strcmp(name, "read") == 0, strcmp(name, "print") == 0, false, false };
+}
+
+/**
+ * Collects effects of the statements themselves and of the calls of the internal and unknown functions.
+ */
+static void collectLocalEffects(const std::shared_ptr<ASTNode>& node, const CallGraph& callGraph, FunctionEffects& effects) {
+    if (node->getType() == WHILE_NODE) effects.mayNotTerminate = true;
+    if (node->getType() == FUNCTION_CALL_NODE) {
+        const char* name = dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName();
+        if (!callGraph.hasFunction(name)) {
+            const FunctionEffects calleeEffects = isInternalFunction(name) ? getInternalFunctionEffects(name) : UNKNOWN_FUNCTION_EFFECTS;
+            effects.readsInput = effects.readsInput || calleeEffects.readsInput;
+            effects.writesOutput = effects.writesOutput || calleeEffects.writesOutput;
+            effects.mayNotTerminate = effects.mayNotTerminate || calleeEffects.mayNotTerminate;
+        }
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        collectLocalEffects(node->getChildren()[i], callGraph, effects);
+    }
+}
+
+static bool assignsIdentifier(const std::shared_ptr<ASTNode>& node, const char* name) {
+    if (node->getType() == ASSIGNMENT_OPERATOR_NODE && strcmp(getIdentifierName(node->getChildren()[0].get()), name) == 0) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (assignsIdentifier(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+EffectAnalysis::EffectAnalysis(const std::shared_ptr<ASTNode>& program) : callGraph(program) {
+    assert(program != nullptr);
+
+    // Components are processed bottom-up, so effects of the called functions from other components are already known.
+    // Functions of the same component call each other, so they share all effects
+    for (const auto& component : callGraph.getBottomUpComponents()) {
+        FunctionEffects componentEffects = { false, false, false, false };
+        for (const char* name : component) {
+            collectLocalEffects(callGraph.getFunctionDefinition(name)->getChildren()[1], callGraph, componentEffects);
+            for (const char* callee : callGraph.getCallees(name)) {
+                if (callGraph.getComponentIndex(callee) == callGraph.getComponentIndex(name)) continue;
+
+                const FunctionEffects& calleeEffects = effects.at(callee);
+                componentEffects.readsInput = componentEffects.readsInput || calleeEffects.readsInput;
+                componentEffects.writesOutput = componentEffects.writesOutput || calleeEffects.writesOutput;
+                componentEffects.mayNotTerminate = componentEffects.mayNotTerminate || calleeEffects.mayNotTerminate;
+            }
+        }
+
+        for (const char* name : component) {
+            const bool isRecursive = callGraph.isRecursive(name);
+            effects[name] = {
+                componentEffects.readsInput,
+                componentEffects.writesOutput,
+                isRecursive,
+                componentEffects.mayNotTerminate || isRecursive
+            };
+        }
+    }
+}
+
+FunctionEffects EffectAnalysis::getEffects(const char* functionName) const {
+    const auto functionEffects = effects.find(functionName);
+    if (functionEffects != effects.end()) return functionEffects->second;
+    // Redefined functions are not in the call graph, even if they have internal names
+    if (isInternalFunction(functionName) && !callGraph.hasFunction(functionName)) return getInternalFunctionEffects(functionName);
+    return UNKNOWN_FUNCTION_EFFECTS;
+}
+
+bool EffectAnalysis::readsInput(const char* functionName) const {
+    return getEffects(functionName).readsInput;
+}
+
+bool EffectAnalysis::writesOutput(const char* functionName) const {
+    return getEffects(functionName).writesOutput;
+}
+
+bool EffectAnalysis::isPure(const char* functionName) const {
+    return getEffects(functionName).isPure();
+}
+
+bool EffectAnalysis::isRecursive(const char* functionName) const {
+    return getEffects(functionName).isRecursive;
+}
+
+bool EffectAnalysis::isSideEffectFree(const std::shared_ptr<ASTNode>& node) const {
+    switch (node->getType()) {
+        case ASSIGNMENT_OPERATOR_NODE:
+        case VARIABLE_DECLARATION_NODE:
+        case VALUE_DECLARATION_NODE:
+        case RETURN_STATEMENT_NODE:
+            return false;
+        case FUNCTION_CALL_NODE: {
+            const char* name = dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName();
+            const FunctionEffects functionEffects = getEffects(name);
+            if (!functionEffects.isPure() || functionEffects.mayNotTerminate) return false;
+            // Calls with wrong number of arguments are errors, that shouldn't be hidden
+            if (callGraph.hasFunction(name) &&
+                callGraph.getFunctionDefinition(name)->getChildren()[0]->getChildrenNumber() != node->getChildren()[0]->getChildrenNumber()) {
+                return false;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (!isSideEffectFree(node->getChildren()[i])) return false;
+    }
+    return true;
+}
+
+bool EffectAnalysis::isMemoizable(const char* functionName) const {
+    if (!callGraph.hasFunction(functionName) || strcmp(functionName, "main") == 0) return false;
+    if (!isPure(functionName) || !isRecursive(functionName)) return false;
+
+    const auto definition = callGraph.getFunctionDefinition(functionName);
+    const auto& parameters = definition->getChildren()[0];
+    if (parameters->getChildrenNumber() == 0) return false;
+
+    for (size_t i = 0; i < parameters->getChildrenNumber(); ++i) {
+        if (assignsIdentifier(definition->getChildren()[1], getIdentifierName(parameters->getChildren()[i].get()))) return false;
+    }
+    return true;
+}
+
+std::vector<const char*> EffectAnalysis::getMemoizableFunctions() const {
+    std::vector<const char*> memoizableFunctions;
+    for (const char* name : callGraph.getFunctionNames()) {
+        if (isMemoizable(name)) memoizableFunctions.push_back(name);
+    }
+    return memoizableFunctions;
+}
+
+void EffectAnalysis::dump(FILE* file) const {
+    assert(file != nullptr);
+
+    for (const auto& function : effects) {
+        const FunctionEffects& functionEffects = function.second;
+        fprintf(file, "%s:", function.first);
+        if (functionEffects.isPure())          fprintf(file, " pure");
+        if (functionEffects.readsInput)        fprintf(file, " reads-input");
+        if (functionEffects.writesOutput)      fprintf(file, " writes-output");
+        if (functionEffects.isRecursive)       fprintf(file, " recursive");
+        if (functionEffects.mayNotTerminate)   fprintf(file, " may-not-terminate");
+        fprintf(file, "\n");
+    }
+}
+
+std::shared_ptr<ASTNode>& EffectAwareOptimizer::optimize(std::shared_ptr<ASTNode>& node) const {
+    if (effects != nullptr) return Optimizer::optimize(node);
+
+    effects = std::make_shared<EffectAnalysis>(node);
+    node = Optimizer::optimize(node);
+    effects = nullptr;
+    return node;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @brief Definition of effect analysis of the functions
+ */
+#ifndef COMPILER_EFFECT_ANALYSIS_H
+#define COMPILER_EFFECT_ANALYSIS_H
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <vector>
+#include "ast-optimizers.h"
+#include "call-graph.h"
+#include "../frontend/ast.h"
+
+/**
+ * Summary of what the function does, directly or through the called functions.
+ */
+struct FunctionEffects {
+    bool readsInput;      // Calls 'read'
+    bool writesOutput;    // Calls 'print'
+    bool isRecursive;
+    bool mayNotTerminate; // Contains loops or recursion
+
+    /** There are no global variables, so result of the pure function depends only on its arguments */
+    inline bool isPure() const {
+        return !readsInput && !writesOutput;
+    }
+};
+
+/**
+ * Computes effects of all user-defined functions. Effects of the called functions are propagated to the callers
+ * bottom-up by the call graph components, functions of the same component share their effects.
+ *
+ * Internal functions have known effects ('read' reads input, 'print' writes output, 'sqrt' and 'pow' are pure).
+ * Calls of the unknown functions (undeclared or redefined) are conservatively considered to have all effects.
+ */
+class EffectAnalysis {
+
+private:
+    struct keyCompare {
+        bool operator()(const char* a, const char* b) const {
+            return strcmp(a, b) < 0;
+        }
+    };
+
+    const CallGraph callGraph;
+    std::map<const char*, FunctionEffects, keyCompare> effects;
+
+public:
+    /**
+     * Analyses functions of the given program.
+     * @param program root of the program AST (statements node containing function definitions)
+     */
+    explicit EffectAnalysis(const std::shared_ptr<ASTNode>& program);
+
+    inline const CallGraph& getCallGraph() const {
+        return callGraph;
+    }
+
+    /** Returns effects of the user-defined or internal function */
+    FunctionEffects getEffects(const char* functionName) const;
+
+    bool readsInput(const char* functionName) const;
+    bool writesOutput(const char* functionName) const;
+    bool isPure(const char* functionName) const;
+    bool isRecursive(const char* functionName) const;
+
+    /**
+     * Checks if evaluation of the expression can't affect anything except its own result.
+     * Unlike isSideEffectFree from ast-utils.h, calls of pure user-defined functions without loops and recursion are allowed,
+     * so such calls can be removed, hoisted or evaluated once.
+     */
+    bool isSideEffectFree(const std::shared_ptr<ASTNode>& node) const;
+
+    /**
+     * Checks if calls of the function can be memoized: function is pure, recursive (so the same calls are likely repeated),
+     * has parameters and never changes them (so the parameters are still the key of the call, when the result is returned).
+     */
+    bool isMemoizable(const char* functionName) const;
+
+    /** Returns names of the functions, whose calls can be memoized (see isMemoizable) */
+    std::vector<const char*> getMemoizableFunctions() const;
+
+    /**
+     * Prints effects of all user-defined functions in the human-readable form (one function per line).
+     */
+    void dump(FILE* file) const;
+};
+
+/**
+ * Optimizer that uses effects of the functions. Effects are analysed once, when optimizer is applied to the program root,
+ * and are available in optimizeCurrent of all nodes.
+ */
+class EffectAwareOptimizer : public Optimizer {
+
+protected:
+    mutable std::shared_ptr<const EffectAnalysis> effects = nullptr;
+
+public:
+    explicit EffectAwareOptimizer(bool optimizeChildrenFirst_) : Optimizer(optimizeChildrenFirst_) { }
+
+    std::shared_ptr<ASTNode>& optimize(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_EFFECT_ANALYSIS_H
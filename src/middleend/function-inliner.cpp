@@ -0,0 +1,488 @@
+/**
+ * @file
+ * @brief Implementation of function inliner
+ */
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ast-utils.h"
+#include "call-graph.h"
+#include "function-inliner.h"
+#include "profile.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+struct InliningContext {
+    const CallGraph& callGraph;
+    size_t callerPosition;
+    size_t smallFunctionSize;
+    size_t singleCallFunctionSize;
+    size_t hotFunctionSizeFactor;
+    const Profile* profile;
+};
+
+static inline const char* getFunctionName(const ASTNode* node) {
+    if (node->getType() == FUNCTION_CALL_NODE) return dynamic_cast<const FunctionCallNode*>(node)->getFunctionName()->getName();
+    return dynamic_cast<const FunctionDefinitionNode*>(node)->getFunctionName()->getName();
+}
+
+static inline const std::shared_ptr<ASTNode>& getBodyStatements(const FunctionDefinitionNode* function) {
+    return function->getChildren()[1]->getChildren()[0];
+}
+
+static inline bool isTrivialExpression(const std::shared_ptr<ASTNode>& node) {
+    return node->getType() == CONSTANT_VALUE_NODE || node->getType() == VALUE_NODE;
+}
+
+static FunctionDefinitionNode* getInlinableCallee(const ASTNode* call, const InliningContext& context) {
+    const char* name = getFunctionName(call);
+    if (!context.callGraph.hasFunction(name) || strcmp(name, "main") == 0) return nullptr;
+    // Calls of functions, defined below the caller, are errors, that shouldn't be hidden
+    if (context.callGraph.getFunctionPosition(name) >= context.callerPosition) return nullptr;
+    if (context.callGraph.isRecursive(name)) return nullptr;
+
+    FunctionDefinitionNode* callee = context.callGraph.getFunctionDefinition(name);
+    if (callee->getChildren()[0]->getChildrenNumber() != call->getChildren()[0]->getChildrenNumber()) return nullptr;
+
+    const size_t calleeSize = countASTNodes(callee->getChildren()[1]);
+    const bool isSingleCall = context.callGraph.getCallSitesNumber(name) == 1;
+    if (isSingleCall && calleeSize <= context.singleCallFunctionSize) return callee;
+
+    size_t smallFunctionSize = context.smallFunctionSize;
+    if (context.profile != nullptr) {
+        if (context.profile->isColdFunction(name)) return nullptr;
+        if (context.profile->isHotFunction(name)) smallFunctionSize *= context.hotFunctionSizeFactor;
+    }
+    return (calleeSize <= smallFunctionSize) ? callee : nullptr;
+}
+
+static size_t countUses(const std::shared_ptr<ASTNode>& node, const char* name) {
+    if (node->getType() == VALUE_NODE && strcmp(getIdentifierName(node.get()), name) == 0) return 1;
+
+    size_t usesNumber = 0;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        usesNumber += countUses(node->getChildren()[i], name);
+    }
+    return usesNumber;
+}
+
+static bool isAssignedOrDeclared(const std::shared_ptr<ASTNode>& node, const char* name) {
+    if (node->getType() == VARIABLE_NODE && strcmp(getIdentifierName(node.get()), name) == 0) return true;
+    if (node->getType() == VALUE_DECLARATION_NODE && strcmp(getIdentifierName(node->getChildren()[0].get()), name) == 0) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (isAssignedOrDeclared(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+/**
+ * Replaces reads of the parameter with the copies of the argument.
+ */
+static void substituteParameter(std::shared_ptr<ASTNode>& node, const char* name, const std::shared_ptr<ASTNode>& argument) {
+    if (node->getType() == VALUE_NODE && strcmp(getIdentifierName(node.get()), name) == 0) {
+        node = copyAST(argument);
+        return;
+    }
+
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        substituteParameter(children[i], name, argument);
+    }
+}
+
+/**
+ * Replaces reads of all parameters with the copies of the corresponding arguments at once, so the argument, that reads
+ * the variable with the same name as other parameter (like `b` in `f(b, a)`), is not substituted again.
+ */
+static void substituteParameters(std::shared_ptr<ASTNode>& node, const std::shared_ptr<ASTNode>& parameters, const std::shared_ptr<ASTNode>& arguments) {
+    if (node->getType() == VALUE_NODE) {
+        const size_t parametersNumber = parameters->getChildrenNumber();
+        for (size_t i = 0; i < parametersNumber; ++i) {
+            if (strcmp(getIdentifierName(node.get()), getIdentifierName(parameters->getChildren()[i].get())) == 0) {
+                node = copyAST(arguments->getChildren()[i]);
+                return;
+            }
+        }
+        return;
+    }
+
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        substituteParameters(children[i], parameters, arguments);
+    }
+}
+
+/**
+ * Inlines call of the function, whose body is a single `return` statement, as an expression.
+ * @return inlined expression or nullptr, if parameters can't be substituted by arguments without changing the semantics.
+ */
+static std::shared_ptr<ASTNode> inlineAsExpression(const ASTNode* call, const FunctionDefinitionNode* callee) {
+    const auto& bodyStatements = getBodyStatements(callee);
+    if (bodyStatements->getChildrenNumber() != 1 || bodyStatements->getChildren()[0]->getType() != RETURN_STATEMENT_NODE) return nullptr;
+
+    const auto& returnedExpression = bodyStatements->getChildren()[0]->getChildren()[0];
+    const auto& parameters = callee->getChildren()[0];
+    const auto& arguments = call->getChildren()[0];
+    const size_t parametersNumber = parameters->getChildrenNumber();
+    for (size_t i = 0; i < parametersNumber; ++i) {
+        const auto& argument = arguments->getChildren()[i];
+        if (isTrivialExpression(argument)) continue;
+
+        // Argument is evaluated exactly once in the original program, so it can't be duplicated or dropped
+        const char* parameterName = getIdentifierName(parameters->getChildren()[i].get());
+        if (!isSideEffectFree(argument) || countUses(returnedExpression, parameterName) > 1) return nullptr;
+    }
+
+    auto inlinedExpression = copyAST(returnedExpression);
+    substituteParameters(inlinedExpression, parameters, arguments);
+    return inlinedExpression;
+}
+
+static void inlineExpressionCalls(std::shared_ptr<ASTNode>& node, const InliningContext& context) {
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        inlineExpressionCalls(children[i], context);
+    }
+
+    if (node->getType() != FUNCTION_CALL_NODE) return;
+
+    const FunctionDefinitionNode* callee = getInlinableCallee(node.get(), context);
+    if (callee == nullptr) return;
+
+    auto inlinedExpression = inlineAsExpression(node.get(), callee);
+    if (inlinedExpression != nullptr) node = inlinedExpression;
+}
+
+static inline bool isVoidCall(const std::shared_ptr<ASTNode>& node) {
+    return node->getType() == FUNCTION_CALL_NODE && strcmp(getFunctionName(node.get()), "print") == 0;
+}
+
+/**
+ * Replaces `return` statements in the inlined body with assignments of the returned values to the result variable.
+ * If result variable is nullptr, returned values are just evaluated (or dropped, if they are side-effect free).
+ * Statements after the conditional returns are moved into the branches, where there is no return.
+ * @return false if returns can't be eliminated (e.g. there is a return inside of the loop).
+ */
+static bool rewriteReturns(std::vector<std::shared_ptr<ASTNode>>& statements, const char* resultName) {
+    std::vector<std::shared_ptr<ASTNode>> rewrittenStatements;
+    for (size_t i = 0; i < statements.size(); ++i) {
+        auto statement = statements[i];
+        std::vector<std::shared_ptr<ASTNode>> restStatements(statements.begin() + i + 1, statements.end());
+
+        switch (statement->getType()) {
+            case RETURN_STATEMENT_NODE: {
+                const auto& returnedExpression = statement->getChildren()[0];
+                if (resultName != nullptr) {
+                    if (isVoidCall(returnedExpression)) return false;
+                    rewrittenStatements.push_back(makeAssignmentNode(resultName, returnedExpression));
+                } else if (!isSideEffectFree(returnedExpression)) {
+                    rewrittenStatements.push_back(returnedExpression);
+                }
+                statements = rewrittenStatements;
+                return true;
+            }
+            case BLOCK_NODE: {
+                if (!containsNodeOfType(statement, RETURN_STATEMENT_NODE)) break;
+                if (!alwaysReturns(statement)) return false;
+
+                std::vector<std::shared_ptr<ASTNode>> blockStatements;
+                const auto& nestedStatements = statement->getChildren()[0];
+                for (size_t j = 0; j < nestedStatements->getChildrenNumber(); ++j) {
+                    blockStatements.push_back(nestedStatements->getChildren()[j]);
+                }
+                if (!rewriteReturns(blockStatements, resultName)) return false;
+
+                rewrittenStatements.push_back(makeBlockNode(statement->getOriginPos(), blockStatements));
+                statements = rewrittenStatements;
+                return true;
+            }
+            case IF_NODE: {
+                if (!containsNodeOfType(statement, RETURN_STATEMENT_NODE)) break;
+                if (!alwaysReturns(statement->getChildren()[1])) return false;
+
+                std::vector<std::shared_ptr<ASTNode>> ifStatements = { statement->getChildren()[1] };
+                if (!rewriteReturns(ifStatements, resultName)) return false;
+                if (!rewriteReturns(restStatements, resultName)) return false;
+
+                rewrittenStatements.push_back(std::make_shared<IfElseNode>(
+                    statement->getOriginPos(),
+                    std::dynamic_pointer_cast<ComparisonOperatorNode>(statement->getChildren()[0]),
+                    makeBlockNode(statement->getOriginPos(), ifStatements),
+                    makeBlockNode(statement->getOriginPos(), restStatements)
+                ));
+                statements = rewrittenStatements;
+                return true;
+            }
+            case IF_ELSE_NODE: {
+                if (!containsNodeOfType(statement, RETURN_STATEMENT_NODE)) break;
+
+                std::shared_ptr<ASTNode> branches[2];
+                for (size_t j = 0; j < 2; ++j) {
+                    const auto& branch = statement->getChildren()[j + 1];
+                    std::vector<std::shared_ptr<ASTNode>> branchStatements = { branch };
+                    if (!alwaysReturns(branch)) {
+                        if (containsNodeOfType(branch, RETURN_STATEMENT_NODE)) return false;
+                        branchStatements.insert(branchStatements.end(), restStatements.begin(), restStatements.end());
+                    }
+                    if (!rewriteReturns(branchStatements, resultName)) return false;
+                    branches[j] = makeBlockNode(branch->getOriginPos(), branchStatements);
+                }
+
+                rewrittenStatements.push_back(std::make_shared<IfElseNode>(
+                    statement->getOriginPos(),
+                    std::dynamic_pointer_cast<ComparisonOperatorNode>(statement->getChildren()[0]),
+                    branches[0],
+                    branches[1]
+                ));
+                statements = rewrittenStatements;
+                return true;
+            }
+            case WHILE_NODE:
+                if (containsNodeOfType(statement, RETURN_STATEMENT_NODE)) return false;
+                break;
+            default:
+                break;
+        }
+        rewrittenStatements.push_back(statement);
+    }
+    statements = rewrittenStatements;
+    return true;
+}
+
+/**
+ * Returns pointer to the expression, that is evaluated by the statement, or nullptr, if statement can't be a place for the inlining.
+ */
+static std::shared_ptr<ASTNode>* getEvaluatedExpression(std::shared_ptr<ASTNode>& statement) {
+    switch (statement->getType()) {
+        case ASSIGNMENT_OPERATOR_NODE:
+        case VALUE_DECLARATION_NODE:
+            return &statement->getChildren()[1];
+        case VARIABLE_DECLARATION_NODE:
+            return statement->getChildrenNumber() == 2 ? &statement->getChildren()[1] : nullptr;
+        case RETURN_STATEMENT_NODE:
+        case IF_NODE:
+        case IF_ELSE_NODE:
+            return &statement->getChildren()[0];
+        case WHILE_NODE: // Condition is evaluated on each iteration
+        case BLOCK_NODE:
+        case FUNCTION_DEFINITION_NODE:
+            return nullptr;
+        default:
+            return &statement;
+    }
+}
+
+/**
+ * Collects calls in the order of their evaluation (arguments are evaluated from right to left).
+ */
+static void collectCalls(std::shared_ptr<ASTNode>& node, std::vector<std::shared_ptr<ASTNode>*>& calls) {
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    if (node->getType() == ARGUMENTS_LIST_NODE) {
+        for (size_t i = childrenNumber; i > 0; --i) {
+            collectCalls(children[i - 1], calls);
+        }
+    } else {
+        for (size_t i = 0; i < childrenNumber; ++i) {
+            collectCalls(children[i], calls);
+        }
+    }
+    if (node->getType() == FUNCTION_CALL_NODE) calls.push_back(&node);
+}
+
+static bool containsNode(const std::shared_ptr<ASTNode>& node, const ASTNode* target) {
+    if (node.get() == target) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (containsNode(node->getChildren()[i], target)) return true;
+    }
+    return false;
+}
+
+static void inlineStatementCalls(std::shared_ptr<ASTNode> statement, const InliningContext& context, std::vector<std::shared_ptr<ASTNode>>& result);
+
+static std::shared_ptr<ASTNode> inlineStatementsListCalls(const std::shared_ptr<ASTNode>& statements, const InliningContext& context) {
+    std::vector<std::shared_ptr<ASTNode>> result;
+    for (size_t i = 0; i < statements->getChildrenNumber(); ++i) {
+        inlineStatementCalls(statements->getChildren()[i], context, result);
+    }
+    return std::make_shared<StatementsNode>(statements->getOriginPos(), result);
+}
+
+static void inlineNestedStatementsCalls(const std::shared_ptr<ASTNode>& statement, const InliningContext& context) {
+    switch (statement->getType()) {
+        case BLOCK_NODE:
+            statement->getChildren()[0] = inlineStatementsListCalls(statement->getChildren()[0], context);
+            break;
+        case IF_NODE:
+        case WHILE_NODE:
+            inlineNestedStatementsCalls(statement->getChildren()[1], context);
+            break;
+        case IF_ELSE_NODE:
+            inlineNestedStatementsCalls(statement->getChildren()[1], context);
+            inlineNestedStatementsCalls(statement->getChildren()[2], context);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Inlines the call, that is evaluated by the statement. Inlined body and declarations it needs are added to the result.
+ * @param[in,out] statement statement with the call. Is set to nullptr, if the whole statement is replaced by the inlined body.
+ * @return false, if the call can't be inlined.
+ */
+static bool inlineCall(
+    std::shared_ptr<ASTNode>& statement,
+    std::shared_ptr<ASTNode>& call,
+    const FunctionDefinitionNode* callee,
+    const InliningContext& context,
+    std::vector<std::shared_ptr<ASTNode>>& result
+) {
+    char suffix[MAX_ID_LENGTH + 1];
+    generateUniqueName(suffix, "");
+
+    const auto inlinedBody = copyAST(getBodyStatements(callee), suffix);
+    std::vector<std::shared_ptr<ASTNode>> bodyStatements;
+    for (size_t i = 0; i < inlinedBody->getChildrenNumber(); ++i) {
+        bodyStatements.push_back(inlinedBody->getChildren()[i]);
+    }
+
+    const auto& parameters = callee->getChildren()[0];
+    const auto& arguments = call->getChildren()[0];
+    const TokenOrigin originPos = call->getOriginPos();
+    char parameterName[MAX_ID_LENGTH + 1];
+
+    // Arguments are evaluated from right to left
+    std::vector<std::shared_ptr<ASTNode>> parametersDeclarations;
+    for (size_t i = parameters->getChildrenNumber(); i > 0; --i) {
+        const auto& argument = arguments->getChildren()[i - 1];
+        snprintf(parameterName, MAX_ID_LENGTH + 1, "%s%s", getIdentifierName(parameters->getChildren()[i - 1].get()), suffix);
+
+        if (isTrivialExpression(argument) && !isAssignedOrDeclared(inlinedBody, parameterName)) {
+            for (auto& bodyStatement : bodyStatements) {
+                substituteParameter(bodyStatement, parameterName, argument);
+            }
+        } else {
+            parametersDeclarations.push_back(makeVariableDeclarationNode(originPos, parameterName, argument));
+        }
+    }
+
+    std::vector<std::shared_ptr<ASTNode>> blockStatements;
+    for (const auto& declaration : parametersDeclarations) {
+        inlineStatementCalls(declaration, context, blockStatements);
+    }
+
+    char resultName[MAX_ID_LENGTH + 1];
+    std::shared_ptr<ASTNode> resultDeclaration = nullptr;
+    std::shared_ptr<ASTNode> remainingStatement = statement;
+    const bool isCallResultUnused = statement == call;
+    const bool isCallResultReturned = statement->getType() == RETURN_STATEMENT_NODE && &statement->getChildren()[0] == &call;
+    const bool isCallResultAssigned = statement->getType() == ASSIGNMENT_OPERATOR_NODE && &statement->getChildren()[1] == &call;
+    const bool isCallResultVariableInitializer = statement->getType() == VARIABLE_DECLARATION_NODE && &statement->getChildren()[1] == &call;
+
+    if (isCallResultUnused) {
+        if (!rewriteReturns(bodyStatements, nullptr)) return false;
+        remainingStatement = nullptr;
+    } else if (isCallResultReturned) {
+        remainingStatement = alwaysReturns(inlinedBody) ? nullptr :
+            std::make_shared<ReturnStatementNode>(originPos, std::make_shared<ConstantValueNode>(originPos, 0));
+    } else if (isCallResultAssigned && alwaysReturns(inlinedBody)) {
+        if (!rewriteReturns(bodyStatements, getIdentifierName(statement->getChildren()[0].get()))) return false;
+        remainingStatement = nullptr;
+    } else if (isCallResultVariableInitializer && alwaysReturns(inlinedBody) && countUses(call, getIdentifierName(statement->getChildren()[0].get())) == 0) {
+        const char* variableName = getIdentifierName(statement->getChildren()[0].get());
+        if (!rewriteReturns(bodyStatements, variableName)) return false;
+        resultDeclaration = makeVariableDeclarationNode(statement->getOriginPos(), variableName, nullptr);
+        remainingStatement = nullptr;
+    } else {
+        generateUniqueName(resultName, "result");
+        if (!rewriteReturns(bodyStatements, resultName)) return false;
+        // Function returns 0, if there is no return statement in the end
+        resultDeclaration = makeVariableDeclarationNode(
+            originPos, resultName, alwaysReturns(inlinedBody) ? nullptr : std::make_shared<ConstantValueNode>(originPos, 0)
+        );
+        call = std::make_shared<ValueNode>(originPos, resultName);
+    }
+
+    blockStatements.insert(blockStatements.end(), bodyStatements.begin(), bodyStatements.end());
+    if (resultDeclaration != nullptr) result.push_back(resultDeclaration);
+    result.push_back(makeBlockNode(originPos, blockStatements));
+    statement = remainingStatement;
+    return true;
+}
+
+/**
+ * Tries to inline the first call, evaluated by the statement.
+ * @return false, if there is no call to inline.
+ */
+static bool inlineFirstCall(std::shared_ptr<ASTNode>& statement, const InliningContext& context, std::vector<std::shared_ptr<ASTNode>>& result) {
+    std::shared_ptr<ASTNode>* evaluatedExpression = getEvaluatedExpression(statement);
+    if (evaluatedExpression == nullptr) return false;
+
+    std::vector<std::shared_ptr<ASTNode>*> calls;
+    collectCalls(*evaluatedExpression, calls);
+
+    // Inlined body is evaluated before the statement, so calls with side effects, evaluated before the inlined call, must be its arguments
+    std::vector<const ASTNode*> sideEffectCalls;
+    for (auto call : calls) {
+        bool canBeHoisted = true;
+        for (const ASTNode* sideEffectCall : sideEffectCalls) {
+            if (!containsNode(*call, sideEffectCall)) canBeHoisted = false;
+        }
+
+        const FunctionDefinitionNode* callee = getInlinableCallee(call->get(), context);
+        if (canBeHoisted && callee != nullptr && inlineCall(statement, *call, callee, context, result)) return true;
+
+        if (!isPureInternalFunction(getFunctionName(call->get()))) sideEffectCalls.push_back(call->get());
+    }
+    return false;
+}
+
+static void inlineStatementCalls(std::shared_ptr<ASTNode> statement, const InliningContext& context, std::vector<std::shared_ptr<ASTNode>>& result) {
+    inlineNestedStatementsCalls(statement, context);
+    while (statement != nullptr) {
+        if (!inlineFirstCall(statement, context, result)) {
+            result.push_back(statement);
+            return;
+        }
+    }
+}
+
+std::shared_ptr<ASTNode>& FunctionInliner::optimize(std::shared_ptr<ASTNode>& node) const {
+    return optimizeCurrent(node);
+}
+
+std::shared_ptr<ASTNode>& FunctionInliner::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != STATEMENTS_NODE) return node;
+
+    // Functions are processed bottom-up, so callees are already optimized, when they are inlined
+    std::vector<std::string> functionNames;
+    const CallGraph initialCallGraph(node);
+    for (const auto& component : initialCallGraph.getBottomUpComponents()) {
+        functionNames.insert(functionNames.end(), component.begin(), component.end());
+    }
+
+    for (const auto& name : functionNames) {
+        const CallGraph callGraph(node);
+        const size_t position = callGraph.getFunctionPosition(name.c_str());
+        const auto& function = node->getChildren()[position];
+        const InliningContext context = {
+            callGraph, position, SMALL_FUNCTION_SIZE, SINGLE_CALL_FUNCTION_SIZE, HOT_FUNCTION_SIZE_FACTOR, profile.get()
+        };
+
+        auto& body = function->getChildren()[1];
+        inlineExpressionCalls(body, context);
+        body->getChildren()[0] = inlineStatementsListCalls(body->getChildren()[0], context);
+    }
+    return node;
+}
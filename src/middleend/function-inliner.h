@@ -0,0 +1,58 @@
+/**
+ * @file
+ * @brief Definition of function inliner
+ */
+#ifndef COMPILER_FUNCTION_INLINER_H
+#define COMPILER_FUNCTION_INLINER_H
+
+#include <memory>
+#include "ast-optimizers.h"
+#include "profile.h"
+#include "../frontend/ast.h"
+
+/**
+ * Replaces calls of small non-recursive functions with their bodies. Should be applied to the root of the program.
+ *
+ * Function is inlined if it's not recursive (see CallGraph), it's defined above the caller (so no errors are hidden)
+ * and it's small enough: its size is at most SMALL_FUNCTION_SIZE nodes or SINGLE_CALL_FUNCTION_SIZE nodes, if it's called only once.
+ *
+ * Calls of functions like `func f(x) { return x * x; }` are replaced with the returned expression, where parameters are
+ * substituted by arguments. Such inlining is possible anywhere (e.g. in the while condition).
+ *
+ * Other functions are inlined only into the statements, where the call is evaluated before any other call with side effects.
+ * The body is put into the block before such statement:
+ *
+ *     var x = 1 + f(a, b);      --->      var result.2;
+ *                                         {
+ *                                             var b.1 = b;
+ *                                             var a.1 = a;
+ *                                             ...body of f, where `return y` is replaced with `result.2 = y`...
+ *                                         }
+ *                                         var x = 1 + result.2;
+ *
+ * Names of the inlined variables get unique suffixes, so they can't shadow or clash with the caller's variables.
+ * Returns that are not in tail positions are eliminated by moving the following statements into the 'else' branches.
+ * If it's impossible (e.g. there is a return inside of the while loop), function is inlined only into `return f(...)` statements.
+ *
+ * Functions are processed bottom-up by the call graph components, so callees are already optimized, when they are inlined.
+ *
+ * If the profile is given, hot functions (see Profile::isHotFunction) may be HOT_FUNCTION_SIZE_FACTOR times larger,
+ * and functions, that were never called, are inlined only if they are called once (so the code doesn't grow).
+ */
+class FunctionInliner : public Optimizer {
+
+private:
+    static constexpr size_t SMALL_FUNCTION_SIZE = 40;
+    static constexpr size_t SINGLE_CALL_FUNCTION_SIZE = 200;
+    static constexpr size_t HOT_FUNCTION_SIZE_FACTOR = 2;
+
+    const std::shared_ptr<const Profile> profile;
+
+public:
+    explicit FunctionInliner(const std::shared_ptr<const Profile>& profile_ = nullptr) : Optimizer(false), profile(profile_) { }
+
+    std::shared_ptr<ASTNode>& optimize(std::shared_ptr<ASTNode>& node) const override;
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_FUNCTION_INLINER_H
@@ -0,0 +1,341 @@
+/**
+ * @file
+ * @brief Implementation of function specializer (interprocedural constant propagation)
+ */
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ast-utils.h"
+#include "call-graph.h"
+#include "function-specializer.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+struct SpecializedParameter {
+    size_t index;
+    double value;
+};
+
+typedef std::vector<SpecializedParameter> Specialization;
+typedef std::vector<std::shared_ptr<ASTNode>*> CallSites;
+
+struct SpecializationLimits {
+    size_t maxFunctionSize;
+    size_t maxSpecializationsNumber;
+};
+
+static inline const char* getFunctionName(const ASTNode* node) {
+    if (node->getType() == FUNCTION_CALL_NODE) return dynamic_cast<const FunctionCallNode*>(node)->getFunctionName()->getName();
+    return dynamic_cast<const FunctionDefinitionNode*>(node)->getFunctionName()->getName();
+}
+
+static bool getConstantArgument(const std::shared_ptr<ASTNode>& argument, double& value) {
+    if (argument->getType() == CONSTANT_VALUE_NODE) {
+        value = dynamic_cast<ConstantValueNode*>(argument.get())->getValue();
+        return true;
+    }
+    if (argument->getType() == OPERATOR_NODE &&
+        dynamic_cast<OperatorNode*>(argument.get())->getToken()->getOperatorType() == ARITHMETIC_NEGATION &&
+        argument->getChildren()[0]->getType() == CONSTANT_VALUE_NODE) {
+        value = -dynamic_cast<ConstantValueNode*>(argument->getChildren()[0].get())->getValue();
+        return true;
+    }
+    return false;
+}
+
+static inline bool isSameValue(double first, double second) {
+    return !(first < second || first > second);
+}
+
+/**
+ * Collects calls of the function in post-order, so nested calls in arguments are redirected before the outer ones.
+ */
+static void collectCalls(std::shared_ptr<ASTNode>& node, const char* name, size_t argumentsNumber, CallSites& calls) {
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        collectCalls(children[i], name, argumentsNumber, calls);
+    }
+
+    if (node->getType() == FUNCTION_CALL_NODE && strcmp(getFunctionName(node.get()), name) == 0 &&
+        node->getChildren()[0]->getChildrenNumber() == argumentsNumber) {
+        calls.push_back(&node);
+    }
+}
+
+static bool containsCall(const std::shared_ptr<ASTNode>& node, const char* name) {
+    if (node->getType() == FUNCTION_CALL_NODE && strcmp(getFunctionName(node.get()), name) == 0) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (containsCall(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+static bool containsRead(const std::shared_ptr<ASTNode>& node, const char* name) {
+    if (node->getType() == VALUE_NODE && strcmp(getIdentifierName(node.get()), name) == 0) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (containsRead(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+static bool isAssignedOrDeclared(const std::shared_ptr<ASTNode>& node, const char* name) {
+    if (node->getType() == VARIABLE_NODE && strcmp(getIdentifierName(node.get()), name) == 0) return true;
+    if (node->getType() == VALUE_DECLARATION_NODE && strcmp(getIdentifierName(node->getChildren()[0].get()), name) == 0) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (isAssignedOrDeclared(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+static bool isUsedInCondition(const std::shared_ptr<ASTNode>& node, const char* name) {
+    const NodeType type = node->getType();
+    if ((type == IF_NODE || type == IF_ELSE_NODE || type == WHILE_NODE) && containsRead(node->getChildren()[0], name)) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (isUsedInCondition(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+static Specialization getSpecialization(const std::shared_ptr<ASTNode>& call, const std::vector<bool>& isSpecializable) {
+    Specialization specialization;
+    const auto& arguments = call->getChildren()[0];
+    for (size_t i = 0; i < arguments->getChildrenNumber(); ++i) {
+        double value = 0;
+        if (isSpecializable[i] && getConstantArgument(arguments->getChildren()[i], value)) specialization.push_back({ i, value });
+    }
+    return specialization;
+}
+
+static bool isSameSpecialization(const Specialization& first, const Specialization& second) {
+    if (first.size() != second.size()) return false;
+    for (size_t i = 0; i < first.size(); ++i) {
+        if (first[i].index != second[i].index || !isSameValue(first[i].value, second[i].value)) return false;
+    }
+    return true;
+}
+
+static bool matchesSpecialization(const std::shared_ptr<ASTNode>& call, const Specialization& specialization) {
+    const auto& arguments = call->getChildren()[0];
+    for (const auto& parameter : specialization) {
+        double value = 0;
+        if (!getConstantArgument(arguments->getChildren()[parameter.index], value) || !isSameValue(value, parameter.value)) return false;
+    }
+    return true;
+}
+
+/**
+ * Replaces the call with the call of the specialized function, where constant arguments are removed.
+ */
+static void redirectCall(std::shared_ptr<ASTNode>& call, const char* name, const Specialization& specialization) {
+    const auto& arguments = call->getChildren()[0];
+    std::vector<std::shared_ptr<ASTNode>> newArguments;
+    size_t specializedIndex = 0;
+    for (size_t i = 0; i < arguments->getChildrenNumber(); ++i) {
+        if (specializedIndex < specialization.size() && specialization[specializedIndex].index == i) {
+            ++specializedIndex;
+        } else {
+            newArguments.push_back(arguments->getChildren()[i]);
+        }
+    }
+    call = std::make_shared<FunctionCallNode>(
+        std::make_shared<IdToken>(call->getOriginPos(), name),
+        std::make_shared<ArgumentsListNode>(arguments->getOriginPos(), newArguments)
+    );
+}
+
+static void substituteParameter(std::shared_ptr<ASTNode>& node, const char* name, double value) {
+    if (node->getType() == VALUE_NODE && strcmp(getIdentifierName(node.get()), name) == 0) {
+        node = std::make_shared<ConstantValueNode>(node->getOriginPos(), value);
+        return;
+    }
+
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        substituteParameter(children[i], name, value);
+    }
+}
+
+/**
+ * Makes a copy of the function, where specialized parameters are replaced with constants.
+ * @param[out] hasUnspecializedRecursiveCalls set to true, if the copy calls the original function with other arguments
+ */
+static std::shared_ptr<ASTNode> makeSpecializedFunction(
+    const std::shared_ptr<ASTNode>& function,
+    const char* newName,
+    const Specialization& specialization,
+    bool& hasUnspecializedRecursiveCalls
+) {
+    const char* name = getFunctionName(function.get());
+    const auto& parameters = function->getChildren()[0];
+    auto body = copyAST(function->getChildren()[1]);
+
+    std::vector<std::shared_ptr<ASTNode>> newParameters;
+    size_t specializedIndex = 0;
+    for (size_t i = 0; i < parameters->getChildrenNumber(); ++i) {
+        const auto& parameter = parameters->getChildren()[i];
+        if (specializedIndex < specialization.size() && specialization[specializedIndex].index == i) {
+            substituteParameter(body, getIdentifierName(parameter.get()), specialization[specializedIndex].value);
+            ++specializedIndex;
+        } else {
+            newParameters.push_back(parameter);
+        }
+    }
+
+    hasUnspecializedRecursiveCalls = false;
+    CallSites recursiveCalls;
+    collectCalls(body, name, parameters->getChildrenNumber(), recursiveCalls);
+    for (auto recursiveCall : recursiveCalls) {
+        if (matchesSpecialization(*recursiveCall, specialization)) {
+            redirectCall(*recursiveCall, newName, specialization);
+        } else {
+            hasUnspecializedRecursiveCalls = true;
+        }
+    }
+
+    return std::make_shared<FunctionDefinitionNode>(
+        std::make_shared<IdToken>(function->getOriginPos(), newName),
+        std::make_shared<ParametersListNode>(parameters->getOriginPos(), newParameters),
+        std::dynamic_pointer_cast<BlockNode>(body)
+    );
+}
+
+/**
+ * Specializes the function at the given position for the calls with constant arguments.
+ */
+static void specializeFunction(std::shared_ptr<ASTNode>& program, size_t position, const SpecializationLimits& limits) {
+    const auto function = program->getChildren()[position];
+    const char* name = getFunctionName(function.get());
+    if (strcmp(name, "main") == 0) return;
+
+    const auto& parameters = function->getChildren()[0];
+    const auto& body = function->getChildren()[1];
+    const size_t parametersNumber = parameters->getChildrenNumber();
+    CallSites recursiveCalls;
+    collectCalls(function->getChildren()[1], name, parametersNumber, recursiveCalls);
+
+    // Parameters, that are changed in recursive calls, are not specialized, because such specialization is only a partial unrolling
+    std::vector<bool> isSpecializable(parametersNumber);
+    for (size_t i = 0; i < parametersNumber; ++i) {
+        const char* parameterName = getIdentifierName(parameters->getChildren()[i].get());
+        isSpecializable[i] = !isAssignedOrDeclared(body, parameterName);
+        for (auto recursiveCall : recursiveCalls) {
+            const auto& argument = (*recursiveCall)->getChildren()[0]->getChildren()[i];
+            const bool isSameParameter = argument->getType() == VALUE_NODE && strcmp(getIdentifierName(argument.get()), parameterName) == 0;
+            if (!isSameParameter && argument->getType() != CONSTANT_VALUE_NODE) isSpecializable[i] = false;
+        }
+    }
+
+    // Calls from the functions above are errors, that shouldn't be hidden
+    CallSites calls;
+    for (size_t i = position + 1; i < program->getChildrenNumber(); ++i) {
+        collectCalls(program->getChildren()[i], name, parametersNumber, calls);
+    }
+
+    std::vector<Specialization> specializations;
+    std::vector<CallSites> specializedCalls;
+    for (auto call : calls) {
+        const Specialization specialization = getSpecialization(*call, isSpecializable);
+        if (specialization.empty()) continue;
+
+        size_t i = 0;
+        while (i < specializations.size() && !isSameSpecialization(specializations[i], specialization)) ++i;
+        if (i == specializations.size()) {
+            specializations.push_back(specialization);
+            specializedCalls.emplace_back();
+        }
+        specializedCalls[i].push_back(call);
+    }
+    if (specializations.empty()) return;
+
+    if (specializations.size() == 1 && specializedCalls[0].size() == calls.size()) {
+        bool hasUnspecializedRecursiveCalls = false;
+        auto specializedFunction = makeSpecializedFunction(function, name, specializations[0], hasUnspecializedRecursiveCalls);
+        if (!hasUnspecializedRecursiveCalls) {
+            for (auto call : calls) {
+                redirectCall(*call, name, specializations[0]);
+            }
+            program->getChildren()[position] = specializedFunction;
+            return;
+        }
+    }
+
+    if (countASTNodes(body) > limits.maxFunctionSize) return;
+
+    std::vector<size_t> order(specializations.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&specializedCalls](size_t first, size_t second) {
+        return specializedCalls[first].size() > specializedCalls[second].size();
+    });
+
+    std::vector<std::shared_ptr<ASTNode>> specializedFunctions;
+    for (size_t i : order) {
+        if (specializedFunctions.size() == limits.maxSpecializationsNumber) break;
+
+        const Specialization& specialization = specializations[i];
+        bool isProfitable = false;
+        for (const auto& parameter : specialization) {
+            if (isUsedInCondition(body, getIdentifierName(parameters->getChildren()[parameter.index].get()))) isProfitable = true;
+        }
+        if (!isProfitable) continue;
+
+        char newName[MAX_ID_LENGTH + 1];
+        generateUniqueFunctionName(newName, name);
+        bool hasUnspecializedRecursiveCalls = false;
+        specializedFunctions.push_back(makeSpecializedFunction(function, newName, specialization, hasUnspecializedRecursiveCalls));
+        for (auto call : specializedCalls[i]) {
+            redirectCall(*call, newName, specialization);
+        }
+    }
+    if (specializedFunctions.empty()) return;
+
+    std::vector<std::shared_ptr<ASTNode>> statements(program->getChildren(), program->getChildren() + program->getChildrenNumber());
+    statements.insert(statements.begin() + position + 1, specializedFunctions.begin(), specializedFunctions.end());
+
+    // Original function is removed, if all its calls were redirected
+    bool isCalled = false;
+    for (size_t i = 0; i < statements.size(); ++i) {
+        if (i != position && containsCall(statements[i], name)) isCalled = true;
+    }
+    if (!isCalled) statements.erase(statements.begin() + position);
+
+    program = std::make_shared<StatementsNode>(program->getOriginPos(), statements);
+}
+
+std::shared_ptr<ASTNode>& FunctionSpecializer::optimize(std::shared_ptr<ASTNode>& node) const {
+    return optimizeCurrent(node);
+}
+
+std::shared_ptr<ASTNode>& FunctionSpecializer::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != STATEMENTS_NODE) return node;
+
+    // Functions are processed top-down, so constants, propagated into the caller, can be propagated further into its callees.
+    // Redefined functions are errors, that shouldn't be hidden, so they are not in the call graph and are not specialized
+    std::vector<std::string> functionNames;
+    const CallGraph initialCallGraph(node);
+    const auto& components = initialCallGraph.getBottomUpComponents();
+    for (auto component = components.rbegin(); component != components.rend(); ++component) {
+        functionNames.insert(functionNames.end(), component->begin(), component->end());
+    }
+
+    const SpecializationLimits limits = { MAX_SPECIALIZED_FUNCTION_SIZE, MAX_SPECIALIZATIONS_NUMBER };
+    for (const auto& name : functionNames) {
+        // Function is removed, if all its calls were redirected to the specialized copies
+        const CallGraph callGraph(node);
+        if (!callGraph.hasFunction(name.c_str())) continue;
+
+        specializeFunction(node, callGraph.getFunctionPosition(name.c_str()), limits);
+    }
+    return node;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @brief Definition of function specializer (interprocedural constant propagation)
+ */
+#ifndef COMPILER_FUNCTION_SPECIALIZER_H
+#define COMPILER_FUNCTION_SPECIALIZER_H
+
+#include <memory>
+#include "ast-optimizers.h"
+#include "../frontend/ast.h"
+
+/**
+ * Propagates constant arguments into the called functions. Should be applied to the root of the program.
+ *
+ * If all calls of the function pass the same constant for some parameter, the parameter is removed and its reads are
+ * replaced with the constant:
+ *
+ *     func f(x, mode) { ... mode ... }           --->      func f(x) { ... 1 ... }
+ *     ... f(a, 1) ... f(b, 1) ...                          ... f(a) ... f(b) ...
+ *
+ * Otherwise calls, that pass the same constants, are redirected to the specialized copy of the function (e.g. `f_1`),
+ * if any of these constants is used in the condition of 'if' or 'while', so the copy can be simplified by other optimizers.
+ * At most MAX_SPECIALIZATIONS_NUMBER copies of at most MAX_SPECIALIZED_FUNCTION_SIZE nodes are made for each function.
+ * Copy is put right after the original function, so it's defined above all callers.
+ *
+ * Parameters, that are assigned or redeclared in the function or changed in its recursive calls, are not specialized.
+ * Recursive calls with the same constants are redirected to the specialized function too.
+ *
+ * Functions are processed top-down by the call graph components, so callers are specialized before their callees
+ * and constants, propagated into the caller, can be passed further.
+ */
+class FunctionSpecializer : public Optimizer {
+
+private:
+    static constexpr size_t MAX_SPECIALIZED_FUNCTION_SIZE = 300;
+    static constexpr size_t MAX_SPECIALIZATIONS_NUMBER = 4;
+
+public:
+    FunctionSpecializer() : Optimizer(false) { }
+
+    std::shared_ptr<ASTNode>& optimize(std::shared_ptr<ASTNode>& node) const override;
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_FUNCTION_SPECIALIZER_H
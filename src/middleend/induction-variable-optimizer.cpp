@@ -0,0 +1,257 @@
+/**
+ * @file
+ * @brief Implementation of induction variable optimizer
+ */
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "induction-variable-optimizer.h"
+#include "loop-analysis.h"
+#include "scalar-evolution.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+// All integers up to this value are exactly representable as double
+static constexpr double MAX_EXACT_INTEGER = 9007199254740992.0;
+
+typedef std::vector<std::shared_ptr<ASTNode>*> Occurrences;
+
+static inline bool isInteger(double value) {
+    return !(std::floor(value) < value) && fabs(value) < MAX_EXACT_INTEGER;
+}
+
+static inline bool isInteger(const InvariantValue& value) {
+    return value.isConstant() && isInteger(value.constant);
+}
+
+/**
+ * Checks if the expression computes integer from integers without rounding: it consists of integer constants, reads of the
+ * given integer variables, additions, subtractions and multiplications.
+ */
+static bool isIntegerArithmetic(const std::shared_ptr<ASTNode>& expression, const char* firstName, const char* secondName = nullptr) {
+    switch (expression->getType()) {
+        case CONSTANT_VALUE_NODE:
+            return isInteger(dynamic_cast<ConstantValueNode*>(expression.get())->getValue());
+        case VALUE_NODE: {
+            const char* name = getIdentifierName(expression.get());
+            return strcmp(name, firstName) == 0 || (secondName != nullptr && strcmp(name, secondName) == 0);
+        }
+        case OPERATOR_NODE:
+            if (dynamic_cast<OperatorNode*>(expression.get())->getToken()->getOperatorType() == DIVISION) return false;
+            break;
+        default:
+            return false;
+    }
+
+    const size_t childrenNumber = expression->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (!isIntegerArithmetic(expression->getChildren()[i], firstName, secondName)) return false;
+    }
+    return true;
+}
+
+static inline std::shared_ptr<ASTNode>& getLoopStatements(const std::shared_ptr<ASTNode>& loop) {
+    return loop->getChildren()[1]->getChildren()[0];
+}
+
+bool InductionVariableOptimizer::replaceWithFinalValues(
+    const std::shared_ptr<ASTNode>& statements,
+    size_t index,
+    std::vector<std::shared_ptr<ASTNode>>& replacement
+) const {
+    const auto& loop = statements->getChildren()[index];
+    LoopCounter counter;
+    if (!findLoopCounter(loop, counter)) return false;
+
+    const auto& body = getLoopStatements(loop);
+    std::vector<Accumulator> accumulators;
+    for (size_t i = 0; i < body->getChildrenNumber(); ++i) {
+        if (i == counter.incrementIndex) continue;
+
+        Accumulator accumulator;
+        if (!findAccumulator(loop, i, counter, accumulator)) return false;
+        accumulators.push_back(accumulator);
+    }
+
+    double initialValue = 0;
+    double bound = 0;
+    if (!findConstantValueBefore(statements, index, counter.name, initialValue)) return false;
+    if (!findConstantBoundBefore(statements, index, counter, bound)) return false;
+
+    // Counter values are summed separately for the accumulators updated before and after the counter
+    size_t tripCount = 0;
+    double value = initialValue;
+    double sumBefore = 0;
+    double sumAfter = 0;
+    double absoluteSum = 0;
+    while (evaluateComparison(counter.comparison, value, bound)) {
+        if (++tripCount > MAX_SIMULATED_TRIP_COUNT) return false;
+        sumBefore += value;
+        absoluteSum += fabs(value);
+        value = counter.advance(value);
+        sumAfter += value;
+        absoluteSum += fabs(value);
+    }
+
+    const bool isIntegerCounter = isInteger(initialValue) && isInteger(counter.increment) && absoluteSum < MAX_EXACT_INTEGER;
+    const TokenOrigin originPos = loop->getOriginPos();
+    for (const auto& accumulator : accumulators) {
+        const double counterSum = (accumulator.index < counter.incrementIndex) ? sumBefore : sumAfter;
+        const InvariantValue total =
+            accumulator.increment.coefficient * InvariantValue(counterSum) +
+            accumulator.increment.offset * InvariantValue((double) tripCount);
+
+        double accumulatorValue = 0;
+        const bool isKnownAccumulator = findConstantValueBefore(statements, index, accumulator.name, accumulatorValue);
+        if (fpMode == FP_STRICT) {
+            const auto& update = body->getChildren()[accumulator.index]->getChildren()[1];
+            const auto& increment = accumulator.increment;
+            const bool isExact =
+                isIntegerCounter && isKnownAccumulator && isInteger(accumulatorValue) &&
+                isInteger(increment.coefficient) && isInteger(increment.offset) &&
+                isIntegerArithmetic(update, counter.name, accumulator.name) &&
+                fabs(accumulatorValue) + fabs(increment.coefficient.constant) * absoluteSum +
+                    fabs(increment.offset.constant) * (double) tripCount < MAX_EXACT_INTEGER;
+            if (!isExact) return false;
+        }
+
+        if (isKnownAccumulator && total.isConstant()) {
+            replacement.push_back(makeAssignmentNode(accumulator.name, std::make_shared<ConstantValueNode>(originPos, accumulatorValue + total.constant)));
+        } else if (!total.isZero()) {
+            const auto sum = makeBinaryOperatorNode(ADDITION, std::make_shared<ValueNode>(originPos, accumulator.name), copyAST(total.toExpression(originPos)));
+            replacement.push_back(makeAssignmentNode(accumulator.name, sum));
+        }
+    }
+    replacement.push_back(makeAssignmentNode(counter.name, std::make_shared<ConstantValueNode>(originPos, value)));
+    return true;
+}
+
+static void collectDerivedVariables(
+    std::shared_ptr<ASTNode>& node,
+    const LoopCounter& counter,
+    const std::vector<const char*>& variantNames,
+    std::vector<Occurrences>& groups,
+    std::vector<AffineForm>& forms
+) {
+    AffineForm form;
+    if (node->getType() == OPERATOR_NODE && findAffineForm(node, counter, variantNames, form)) {
+        if (form.coefficient.isZero()) return;
+
+        for (auto& group : groups) {
+            if (isEqualAST(*group[0], node)) {
+                group.push_back(&node);
+                return;
+            }
+        }
+        groups.push_back({ &node });
+        forms.push_back(form);
+        return;
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        collectDerivedVariables(node->getChildren()[i], counter, variantNames, groups, forms);
+    }
+}
+
+bool InductionVariableOptimizer::reduceStrength(
+    const std::shared_ptr<ASTNode>& statements,
+    size_t index,
+    std::vector<std::shared_ptr<ASTNode>>& hoistedDeclarations
+) const {
+    const auto& loop = statements->getChildren()[index];
+    LoopCounter counter;
+    if (!findLoopCounter(loop, counter)) return false;
+
+    double initialValue = 0;
+    const bool isIntegerCounter =
+        findConstantValueBefore(statements, index, counter.name, initialValue) && isInteger(initialValue) && isInteger(counter.increment);
+    if (fpMode == FP_STRICT && !isIntegerCounter) return false;
+
+    std::vector<const char*> variantNames;
+    collectVariantNames(loop, variantNames);
+
+    auto& body = getLoopStatements(loop);
+    std::vector<Occurrences> groups;
+    std::vector<AffineForm> forms;
+    for (size_t i = 0; i < body->getChildrenNumber(); ++i) {
+        if (i != counter.incrementIndex) collectDerivedVariables(body->getChildren()[i], counter, variantNames, groups, forms);
+    }
+
+    std::vector<std::shared_ptr<ASTNode>> updates;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const auto& expression = *groups[i][0];
+        const InvariantValue step = forms[i].coefficient * InvariantValue(counter.getStep());
+        if (fpMode == FP_STRICT && !(isInteger(forms[i].coefficient) && isInteger(forms[i].offset) && isIntegerArithmetic(expression, counter.name))) continue;
+
+        const size_t occurrencesNumber = groups[i].size();
+        const size_t updateCost = VARIABLE_ASSIGNMENT_COST + VARIABLE_READ_COST + 1 + (step.isConstant() ? 1 : VARIABLE_READ_COST);
+        if (occurrencesNumber * getEvaluationCost(expression) <= occurrencesNumber * VARIABLE_READ_COST + updateCost) continue;
+
+        const TokenOrigin originPos = expression->getOriginPos();
+        char name[MAX_ID_LENGTH + 1];
+        generateUniqueName(name, "iv");
+        hoistedDeclarations.push_back(makeVariableDeclarationNode(originPos, name, copyAST(expression)));
+
+        std::shared_ptr<ASTNode> update = nullptr;
+        const auto variable = std::make_shared<ValueNode>(originPos, name);
+        if (step.isConstant()) {
+            const OperatorType operatorType = step.constant < 0 ? SUBTRACTION : ADDITION;
+            update = makeBinaryOperatorNode(operatorType, variable, std::make_shared<ConstantValueNode>(originPos, fabs(step.constant)));
+        } else {
+            char stepName[MAX_ID_LENGTH + 1];
+            generateUniqueName(stepName, "ivstep");
+            hoistedDeclarations.push_back(makeVariableDeclarationNode(originPos, stepName, copyAST(step.expression)));
+            update = makeBinaryOperatorNode(ADDITION, variable, std::make_shared<ValueNode>(originPos, stepName));
+        }
+        updates.push_back(makeAssignmentNode(name, update));
+
+        for (auto occurrence : groups[i]) {
+            *occurrence = std::make_shared<ValueNode>(originPos, name);
+        }
+    }
+    if (updates.empty()) return false;
+
+    // Derived variables are updated right after the counter, so they are consistent with it in any statement
+    std::vector<std::shared_ptr<ASTNode>> bodyStatements;
+    for (size_t i = 0; i < body->getChildrenNumber(); ++i) {
+        bodyStatements.push_back(body->getChildren()[i]);
+        if (i == counter.incrementIndex) bodyStatements.insert(bodyStatements.end(), updates.begin(), updates.end());
+    }
+    body = std::make_shared<StatementsNode>(body->getOriginPos(), bodyStatements);
+    return true;
+}
+
+std::shared_ptr<ASTNode>& InductionVariableOptimizer::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != STATEMENTS_NODE) return node;
+
+    bool hasChanges = false;
+    std::vector<std::shared_ptr<ASTNode>> statements;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        const auto& statement = node->getChildren()[i];
+        if (statement->getType() != WHILE_NODE) {
+            statements.push_back(statement);
+            continue;
+        }
+
+        std::vector<std::shared_ptr<ASTNode>> replacement;
+        if (replaceWithFinalValues(node, i, replacement)) {
+            statements.insert(statements.end(), replacement.begin(), replacement.end());
+            hasChanges = true;
+            continue;
+        }
+
+        std::vector<std::shared_ptr<ASTNode>> hoistedDeclarations;
+        if (reduceStrength(node, i, hoistedDeclarations)) {
+            statements.insert(statements.end(), hoistedDeclarations.begin(), hoistedDeclarations.end());
+            hasChanges = true;
+        }
+        statements.push_back(statement);
+    }
+
+    if (hasChanges) node = std::make_shared<StatementsNode>(node->getOriginPos(), statements);
+    return node;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @brief Definition of induction variable optimizer
+ */
+#ifndef COMPILER_INDUCTION_VARIABLE_OPTIMIZER_H
+#define COMPILER_INDUCTION_VARIABLE_OPTIMIZER_H
+
+#include <memory>
+#include <vector>
+#include "ast-optimizers.h"
+#include "../frontend/ast.h"
+
+/**
+ * Optimizes while loops with counters (see LoopCounter) using scalar evolution of the loop variables (see AffineForm).
+ *
+ * If the loop only updates accumulators by affine functions of the counter, and its trip count is known,
+ * the loop is replaced with the final values:
+ *
+ *     var s = 0;                    --->      var s = 0;
+ *     var c = 0;                              var c = 0;
+ *     var i = 0;                              var i = 0;
+ *     while (i < 100) {                       s = 9900;
+ *         s = s + 2 * i;                      c = 100;
+ *         c = c + 1;                          i = 100;
+ *         i = i + 1;
+ *     }
+ *
+ * Otherwise, derived induction variables (affine functions of the counter like `a * i + b`) are computed by running
+ * additions, if it's cheaper than computing them on each iteration (see getEvaluationCost):
+ *
+ *     while (i < n) {               --->      var iv.1 = 4 * i + 1;
+ *         x = x * (4 * i + 1);                while (i < n) {
+ *         y = y + (4 * i + 1);                    x = x * iv.1;
+ *         i = i + 1;                              y = y + iv.1;
+ *     }                                           i = i + 1;
+ *                                                 iv.1 = iv.1 + 4;
+ *                                             }
+ *
+ * Both transformations reorder floating point operations, so in strict floating-point mode they are applied only if all the values
+ * are known to be integers (so computations are exact): the counter starts from an integer constant and changes by an integer,
+ * the affine functions have integer coefficients, accumulators start from integer constants.
+ */
+class InductionVariableOptimizer : public Optimizer {
+
+private:
+    static constexpr size_t MAX_SIMULATED_TRIP_COUNT = 1000000;
+    const FloatingPointMode fpMode;
+
+public:
+    explicit InductionVariableOptimizer(FloatingPointMode fpMode_) : Optimizer(true), fpMode(fpMode_) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+
+private:
+    bool replaceWithFinalValues(
+        const std::shared_ptr<ASTNode>& statements,
+        size_t index,
+        std::vector<std::shared_ptr<ASTNode>>& replacement
+    ) const;
+    bool reduceStrength(
+        const std::shared_ptr<ASTNode>& statements,
+        size_t index,
+        std::vector<std::shared_ptr<ASTNode>>& hoistedDeclarations
+    ) const;
+};
+
+#endif // COMPILER_INDUCTION_VARIABLE_OPTIMIZER_H
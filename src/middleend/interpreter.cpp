@@ -0,0 +1,199 @@
+/**
+ * @file
+ * @brief Implementation of tree-walking interpreter of the program AST
+ */
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "interpreter.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+static constexpr size_t MAX_VARIABLES_NUMBER = RAM_SIZE / VARIABLE_SIZE_IN_BYTES;
+
+Interpreter::Variable* Interpreter::findVariable(const char* name) {
+    if (frames.empty()) return nullptr;
+
+    auto& scopes = frames.back();
+    for (auto scope = scopes.rbegin(); scope != scopes.rend(); ++scope) {
+        for (auto& variable : *scope) {
+            if (strcmp(variable.name, name) == 0) return &variable;
+        }
+    }
+    return nullptr;
+}
+
+bool Interpreter::declareVariable(const char* name, double value) {
+    if (frames.empty() || variablesNumber == MAX_VARIABLES_NUMBER) return false;
+
+    frames.back().back().push_back({ name, value });
+    ++variablesNumber;
+    return true;
+}
+
+void Interpreter::enterScope() {
+    frames.back().emplace_back();
+}
+
+void Interpreter::leaveScope() {
+    variablesNumber -= frames.back().back().size();
+    frames.back().pop_back();
+}
+
+bool Interpreter::callInternalFunction(const char* functionName, const std::vector<double>& arguments, double& result) {
+    if (strcmp(functionName, "sqrt") == 0 && arguments.size() == 1) {
+        result = sqrt(arguments[0]);
+        return isAcceptableResult(result);
+    }
+    if (strcmp(functionName, "pow") == 0 && arguments.size() == 2) {
+        result = pow(arguments[0], arguments[1]);
+        return isAcceptableResult(result);
+    }
+    return false;
+}
+
+bool Interpreter::evaluate(const std::shared_ptr<ASTNode>& expression, double& result) {
+    if (!makeStep()) return false;
+
+    switch (expression->getType()) {
+        case CONSTANT_VALUE_NODE:
+            result = dynamic_cast<ConstantValueNode*>(expression.get())->getValue();
+            return true;
+        case VALUE_NODE: {
+            const Variable* variable = findVariable(getIdentifierName(expression.get()));
+            if (variable == nullptr) return false;
+            result = variable->value;
+            return true;
+        }
+        case OPERATOR_NODE: {
+            const auto& token = dynamic_cast<OperatorNode*>(expression.get())->getToken();
+            double left = 0;
+            if (!evaluate(expression->getChildren()[0], left)) return false;
+            if (expression->getChildrenNumber() == 1) {
+                result = token->calculate(1, left);
+                return true;
+            }
+            double right = 0;
+            if (!evaluate(expression->getChildren()[1], right)) return false;
+            result = token->calculate(2, left, right);
+            return true;
+        }
+        case COMPARISON_OPERATOR_NODE: {
+            double left = 0;
+            double right = 0;
+            if (!evaluate(expression->getChildren()[0], left) || !evaluate(expression->getChildren()[1], right)) return false;
+            const auto operatorType = dynamic_cast<ComparisonOperatorNode*>(expression.get())->getToken()->getOperatorType();
+            result = evaluateComparison(operatorType, left, right) ? 1 : 0;
+            return true;
+        }
+        case FUNCTION_CALL_NODE:
+            return evaluateCall(expression, result);
+        default:
+            return false;
+    }
+}
+
+bool Interpreter::evaluateCall(const std::shared_ptr<ASTNode>& call, double& result) {
+    const char* name = dynamic_cast<FunctionCallNode*>(call.get())->getFunctionName()->getName();
+    if (!canCall(name)) return false;
+
+    // Arguments are evaluated from the last to the first, like in the compiled code
+    const auto& arguments = call->getChildren()[0];
+    std::vector<double> argumentValues(arguments->getChildrenNumber());
+    for (size_t i = argumentValues.size(); i > 0; --i) {
+        if (!evaluate(arguments->getChildren()[i - 1], argumentValues[i - 1])) return false;
+    }
+    return this->call(name, argumentValues, result);
+}
+
+bool Interpreter::call(const char* functionName, const std::vector<double>& arguments, double& result) {
+    if (!callGraph.hasFunction(functionName)) return callInternalFunction(functionName, arguments, result);
+
+    const FunctionDefinitionNode* function = callGraph.getFunctionDefinition(functionName);
+    const auto& parameters = function->getChildren()[0];
+    if (parameters->getChildrenNumber() != arguments.size() || frames.size() == maxCallDepth) return false;
+    onFunctionCall(functionName, arguments);
+
+    // Parameters and body of the function share the same scope
+    frames.emplace_back();
+    enterScope();
+    bool isSuccessful = true;
+    for (size_t i = 0; i < arguments.size() && isSuccessful; ++i) {
+        isSuccessful = declareVariable(getIdentifierName(parameters->getChildren()[i].get()), arguments[i]);
+    }
+
+    ExecutionResult executionResult = FAILED;
+    if (isSuccessful) executionResult = execute(function->getChildren()[1]->getChildren()[0]);
+    leaveScope();
+    frames.pop_back();
+
+    if (executionResult == FAILED) return false;
+    // Function without return in the end returns 0
+    result = (executionResult == RETURNED) ? returnedValue : 0;
+    return isAcceptableResult(result);
+}
+
+Interpreter::ExecutionResult Interpreter::execute(const std::shared_ptr<ASTNode>& statement) {
+    if (!makeStep()) return FAILED;
+
+    const auto children = statement->getChildren();
+    double value = 0;
+    switch (statement->getType()) {
+        case STATEMENTS_NODE:
+            for (size_t i = 0; i < statement->getChildrenNumber(); ++i) {
+                const ExecutionResult result = execute(children[i]);
+                if (result != NORMAL) return result;
+            }
+            return NORMAL;
+        case BLOCK_NODE: {
+            enterScope();
+            const ExecutionResult result = execute(children[0]);
+            leaveScope();
+            return result;
+        }
+        case VARIABLE_DECLARATION_NODE:
+        case VALUE_DECLARATION_NODE:
+            // Variable without initial value is zero, like in the compiled code
+            if (statement->getChildrenNumber() == 2 && !evaluate(children[1], value)) return FAILED;
+            return declareVariable(getIdentifierName(children[0].get()), value) ? NORMAL : FAILED;
+        case ASSIGNMENT_OPERATOR_NODE: {
+            if (!evaluate(children[1], value)) return FAILED;
+            Variable* variable = findVariable(getIdentifierName(children[0].get()));
+            if (variable == nullptr) return FAILED;
+            variable->value = value;
+            return NORMAL;
+        }
+        case IF_NODE:
+            if (!evaluate(children[0], value)) return FAILED;
+            onBranch(statement.get(), value > 0);
+            return (value > 0) ? execute(children[1]) : NORMAL;
+        case IF_ELSE_NODE:
+            if (!evaluate(children[0], value)) return FAILED;
+            onBranch(statement.get(), value > 0);
+            return execute((value > 0) ? children[1] : children[2]);
+        case WHILE_NODE: {
+            size_t tripCount = 0;
+            while (true) {
+                if (!evaluate(children[0], value)) return FAILED;
+                if (value <= 0) break;
+
+                const ExecutionResult result = execute(children[1]);
+                ++tripCount;
+                if (result != NORMAL) {
+                    if (result == RETURNED) onLoopExit(statement.get(), tripCount);
+                    return result;
+                }
+            }
+            onLoopExit(statement.get(), tripCount);
+            return NORMAL;
+        }
+        case RETURN_STATEMENT_NODE:
+            if (!evaluate(children[0], returnedValue)) return FAILED;
+            return RETURNED;
+        default:
+            // Expression statement, its value is dropped
+            return evaluate(statement, value) ? NORMAL : FAILED;
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @brief Definition of tree-walking interpreter of the program AST
+ */
+#ifndef COMPILER_INTERPRETER_H
+#define COMPILER_INTERPRETER_H
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "call-graph.h"
+#include "../frontend/ast.h"
+
+/**
+ * Tree-walking interpreter of the program AST. It's used to evaluate calls at compile time and to collect execution profiles.
+ *
+ * Variables are stored the same way as in the stack machine RAM, so the evaluation fails, if they don't fit in it.
+ * Any unsupported or unknown situation (unknown function, exceeded limits, wrong arguments number) fails the evaluation too.
+ * Derived interpreters can restrict called functions, implement other internal functions and observe the execution.
+ */
+class Interpreter {
+
+private:
+    enum ExecutionResult {
+        NORMAL,
+        RETURNED,
+        FAILED,
+    };
+
+    struct Variable {
+        const char* name;
+        double value;
+    };
+
+    typedef std::vector<Variable> Scope;
+
+    const CallGraph& callGraph;
+    const size_t maxSteps;
+    const size_t maxCallDepth;
+
+    size_t steps = 0;
+    size_t variablesNumber = 0;
+    std::vector<std::vector<Scope>> frames; // Scopes of the called functions, the last one is the current
+    double returnedValue = 0;
+
+    bool makeStep() {
+        return ++steps <= maxSteps;
+    }
+
+    Variable* findVariable(const char* name);
+    bool declareVariable(const char* name, double value);
+    void enterScope();
+    void leaveScope();
+
+    bool evaluateCall(const std::shared_ptr<ASTNode>& call, double& result);
+    ExecutionResult execute(const std::shared_ptr<ASTNode>& statement);
+
+protected:
+    /**
+     * Checks if the function can be called. Any function can be called by default.
+     */
+    virtual bool canCall(const char* /* functionName */) const {
+        return true;
+    }
+
+    /**
+     * Calls internal function (the one, that is not defined in the program). Only 'sqrt' and 'pow' are supported by default.
+     * @return false, if the call failed.
+     */
+    virtual bool callInternalFunction(const char* functionName, const std::vector<double>& arguments, double& result);
+
+    /**
+     * Checks if the result of the function call is acceptable. Not finite results (like results of division by zero) fail the evaluation by default.
+     */
+    virtual bool isAcceptableResult(double result) const {
+        return std::isfinite(result);
+    }
+
+    /** Is called before the execution of each user function */
+    virtual void onFunctionCall(const char* /* functionName */, const std::vector<double>& /* arguments */) { }
+    /** Is called after the condition of if statement is evaluated */
+    virtual void onBranch(const ASTNode* /* statement */, bool /* isTaken */) { }
+    /** Is called after the while loop is finished (by its condition or by return) */
+    virtual void onLoopExit(const ASTNode* /* loop */, size_t /* tripCount */) { }
+
+public:
+    Interpreter(const CallGraph& callGraph_, size_t maxSteps_, size_t maxCallDepth_) :
+        callGraph(callGraph_), maxSteps(maxSteps_), maxCallDepth(maxCallDepth_) { }
+
+    virtual ~Interpreter() = default;
+
+    /**
+     * Evaluates the expression in the current scope (or without variables, if nothing is called).
+     * @return false, if evaluation failed.
+     */
+    bool evaluate(const std::shared_ptr<ASTNode>& expression, double& result);
+
+    /**
+     * Calls the function with the given arguments.
+     * @return false, if evaluation failed.
+     */
+    bool call(const char* functionName, const std::vector<double>& arguments, double& result);
+};
+
+#endif // COMPILER_INTERPRETER_H
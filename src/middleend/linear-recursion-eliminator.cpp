@@ -0,0 +1,261 @@
+/**
+ * @file
+ * @brief Implementation of linear recursion eliminator
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "call-graph.h"
+#include "effect-analysis.h"
+#include "linear-recursion-eliminator.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+/**
+ * Return statement of the linear recursive function: `return f(...)` or `return f(...) op a` (`return a op f(...)`).
+ */
+struct RecursiveReturn {
+    std::shared_ptr<ASTNode> call;
+    std::shared_ptr<ASTNode> operand;  // nullptr for the tail call
+    OperatorType operatorType;         // Operator, that combines the result with the accumulator
+};
+
+static inline bool isSelfCall(const std::shared_ptr<ASTNode>& node, const char* name, size_t parametersNumber) {
+    if (node->getType() != FUNCTION_CALL_NODE) return false;
+
+    return strcmp(dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName(), name) == 0 &&
+           node->getChildren()[0]->getChildrenNumber() == parametersNumber;
+}
+
+static size_t countCalls(const std::shared_ptr<ASTNode>& node, const char* name) {
+    size_t callsNumber = 0;
+    if (node->getType() == FUNCTION_CALL_NODE && strcmp(dynamic_cast<FunctionCallNode*>(node.get())->getFunctionName()->getName(), name) == 0) {
+        ++callsNumber;
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        callsNumber += countCalls(node->getChildren()[i], name);
+    }
+    return callsNumber;
+}
+
+/**
+ * Checks if the returned expression is the self call combined with the side effect free operand.
+ */
+static bool matchRecursiveReturn(
+    const std::shared_ptr<ASTNode>& expression,
+    const char* name,
+    size_t parametersNumber,
+    const EffectAnalysis& effects,
+    RecursiveReturn& recursiveReturn
+) {
+    if (isSelfCall(expression, name, parametersNumber)) {
+        recursiveReturn = { expression, nullptr, ADDITION };
+        return countCalls(expression->getChildren()[0], name) == 0;
+    }
+    if (expression->getType() != OPERATOR_NODE || expression->getChildrenNumber() != 2) return false;
+
+    const auto operatorType = dynamic_cast<OperatorNode*>(expression.get())->getToken()->getOperatorType();
+    const auto& left = expression->getChildren()[0];
+    const auto& right = expression->getChildren()[1];
+    const bool isCommutative = operatorType == ADDITION || operatorType == MULTIPLICATION;
+    if (isSelfCall(left, name, parametersNumber)) {
+        recursiveReturn = { left, right, operatorType };
+    } else if (isCommutative && isSelfCall(right, name, parametersNumber)) {
+        recursiveReturn = { right, left, operatorType };
+    } else {
+        return false;
+    }
+
+    return countCalls(recursiveReturn.call->getChildren()[0], name) == 0 &&
+           countCalls(recursiveReturn.operand, name) == 0 &&
+           effects.isSideEffectFree(recursiveReturn.operand);
+}
+
+static inline bool isSum(OperatorType operatorType) {
+    return operatorType == ADDITION || operatorType == SUBTRACTION;
+}
+
+/**
+ * Collects the recursive returns outside of the while loops.
+ * @return false, if some return combines the result differently from the others.
+ */
+static bool collectRecursiveReturns(
+    const std::shared_ptr<ASTNode>& node,
+    const char* name,
+    size_t parametersNumber,
+    const EffectAnalysis& effects,
+    bool& isSumAccumulator,
+    bool& hasCombiningReturns,
+    size_t& returnsNumber
+) {
+    if (node->getType() == WHILE_NODE) return true;
+    if (node->getType() == RETURN_STATEMENT_NODE) {
+        RecursiveReturn recursiveReturn;
+        if (!matchRecursiveReturn(node->getChildren()[0], name, parametersNumber, effects, recursiveReturn)) return true;
+
+        ++returnsNumber;
+        if (recursiveReturn.operand == nullptr) return true;
+        if (hasCombiningReturns && isSumAccumulator != isSum(recursiveReturn.operatorType)) return false;
+        isSumAccumulator = isSum(recursiveReturn.operatorType);
+        hasCombiningReturns = true;
+        return true;
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (!collectRecursiveReturns(node->getChildren()[i], name, parametersNumber, effects, isSumAccumulator, hasCombiningReturns, returnsNumber)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::shared_ptr<ASTNode> makeCall(TokenOrigin originPos, const char* name, const std::vector<std::shared_ptr<ASTNode>>& arguments) {
+    return std::make_shared<FunctionCallNode>(
+        std::make_shared<IdToken>(originPos, name),
+        std::make_shared<ArgumentsListNode>(originPos, arguments)
+    );
+}
+
+/**
+ * Replaces recursive returns with tail calls of the accumulating function and combines other returned values with the accumulator.
+ */
+static void accumulateReturns(
+    std::shared_ptr<ASTNode>& node,
+    const char* name,
+    const char* newName,
+    size_t parametersNumber,
+    const char* accumulatorName,
+    OperatorType accumulatorOperator,
+    const EffectAnalysis& effects
+) {
+    if (node->getType() == RETURN_STATEMENT_NODE) {
+        const TokenOrigin originPos = node->getOriginPos();
+        const auto accumulator = std::make_shared<ValueNode>(originPos, accumulatorName);
+        const auto& expression = node->getChildren()[0];
+
+        RecursiveReturn recursiveReturn;
+        if (matchRecursiveReturn(expression, name, parametersNumber, effects, recursiveReturn)) {
+            const auto& arguments = recursiveReturn.call->getChildren()[0];
+            std::vector<std::shared_ptr<ASTNode>> newArguments;
+            for (size_t i = 0; i < arguments->getChildrenNumber(); ++i) {
+                newArguments.push_back(arguments->getChildren()[i]);
+            }
+            if (recursiveReturn.operand == nullptr) {
+                newArguments.push_back(accumulator);
+            } else {
+                newArguments.push_back(makeBinaryOperatorNode(recursiveReturn.operatorType, accumulator, recursiveReturn.operand));
+            }
+            node = std::make_shared<ReturnStatementNode>(originPos, makeCall(originPos, newName, newArguments));
+        } else {
+            node = std::make_shared<ReturnStatementNode>(originPos, makeBinaryOperatorNode(accumulatorOperator, accumulator, expression));
+        }
+        return;
+    }
+
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        accumulateReturns(children[i], name, newName, parametersNumber, accumulatorName, accumulatorOperator, effects);
+    }
+}
+
+/**
+ * Moves body of the linear recursive function into the new accumulating function.
+ * @return accumulating function or nullptr, if the function is not linear recursive.
+ */
+static std::shared_ptr<ASTNode> introduceAccumulator(std::shared_ptr<ASTNode>& function, const EffectAnalysis& effects) {
+    const char* name = dynamic_cast<FunctionDefinitionNode*>(function.get())->getFunctionName()->getName();
+    const auto& parameters = function->getChildren()[0];
+    const size_t parametersNumber = parameters->getChildrenNumber();
+    const auto& body = function->getChildren()[1];
+
+    bool isSumAccumulator = false;
+    bool hasCombiningReturns = false;
+    size_t returnsNumber = 0;
+    if (!collectRecursiveReturns(body, name, parametersNumber, effects, isSumAccumulator, hasCombiningReturns, returnsNumber)) return nullptr;
+    // Other calls can't be made tail calls, and tail recursive functions don't need the accumulator
+    if (!hasCombiningReturns || returnsNumber != countCalls(body, name)) return nullptr;
+
+    const TokenOrigin originPos = function->getOriginPos();
+    char newName[MAX_ID_LENGTH + 1];
+    generateUniqueFunctionName(newName, name);
+    char accumulatorName[MAX_ID_LENGTH + 1];
+    generateUniqueName(accumulatorName, "acc");
+    const OperatorType accumulatorOperator = isSumAccumulator ? ADDITION : MULTIPLICATION;
+
+    auto newBody = copyAST(body);
+    accumulateReturns(newBody, name, newName, parametersNumber, accumulatorName, accumulatorOperator, effects);
+    if (!alwaysReturns(newBody)) {
+        // Function returns 0, if its end is reached
+        const auto returnedValue = makeBinaryOperatorNode(
+            accumulatorOperator,
+            std::make_shared<ValueNode>(originPos, accumulatorName),
+            std::make_shared<ConstantValueNode>(originPos, 0)
+        );
+        std::vector<std::shared_ptr<ASTNode>> statements;
+        const auto& bodyStatements = newBody->getChildren()[0];
+        for (size_t i = 0; i < bodyStatements->getChildrenNumber(); ++i) {
+            statements.push_back(bodyStatements->getChildren()[i]);
+        }
+        statements.push_back(std::make_shared<ReturnStatementNode>(originPos, returnedValue));
+        newBody = makeBlockNode(newBody->getOriginPos(), statements);
+    }
+
+    std::vector<std::shared_ptr<ASTNode>> newParameters;
+    std::vector<std::shared_ptr<ASTNode>> arguments;
+    for (size_t i = 0; i < parametersNumber; ++i) {
+        const auto& parameter = parameters->getChildren()[i];
+        newParameters.push_back(copyAST(parameter));
+        arguments.push_back(std::make_shared<ValueNode>(originPos, getIdentifierName(parameter.get())));
+    }
+    newParameters.push_back(std::make_shared<VariableNode>(originPos, accumulatorName));
+    arguments.push_back(std::make_shared<ConstantValueNode>(originPos, isSumAccumulator ? 0 : 1));
+
+    const auto wrapperBody = std::make_shared<ReturnStatementNode>(originPos, makeCall(originPos, newName, arguments));
+    function = std::make_shared<FunctionDefinitionNode>(
+        dynamic_cast<FunctionDefinitionNode*>(function.get())->getFunctionName(),
+        std::dynamic_pointer_cast<ParametersListNode>(parameters),
+        makeBlockNode(body->getOriginPos(), { wrapperBody })
+    );
+    return std::make_shared<FunctionDefinitionNode>(
+        std::make_shared<IdToken>(originPos, newName),
+        std::make_shared<ParametersListNode>(parameters->getOriginPos(), newParameters),
+        std::dynamic_pointer_cast<BlockNode>(newBody)
+    );
+}
+
+std::shared_ptr<ASTNode>& LinearRecursionEliminator::optimize(std::shared_ptr<ASTNode>& node) const {
+    effects = std::make_shared<EffectAnalysis>(node);
+    node = optimizeCurrent(node);
+    effects = nullptr;
+    return node;
+}
+
+std::shared_ptr<ASTNode>& LinearRecursionEliminator::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != STATEMENTS_NODE || fpMode == FP_STRICT) return node;
+
+    const CallGraph& callGraph = effects->getCallGraph();
+    bool hasChanges = false;
+    std::vector<std::shared_ptr<ASTNode>> functions;
+    for (size_t i = 0; i < node->getChildrenNumber(); ++i) {
+        auto function = node->getChildren()[i];
+        const bool isKnownFunction = function->getType() == FUNCTION_DEFINITION_NODE &&
+            callGraph.hasFunction(dynamic_cast<FunctionDefinitionNode*>(function.get())->getFunctionName()->getName());
+        // Redefined functions are errors, that shouldn't be hidden
+        if (isKnownFunction) {
+            const auto accumulatingFunction = introduceAccumulator(function, *effects);
+            if (accumulatingFunction != nullptr) {
+                functions.push_back(accumulatingFunction);
+                hasChanges = true;
+            }
+        }
+        functions.push_back(function);
+    }
+
+    if (hasChanges) node = std::make_shared<StatementsNode>(node->getOriginPos(), functions);
+    return node;
+}
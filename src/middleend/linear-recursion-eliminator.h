@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @brief Definition of linear recursion eliminator
+ */
+#ifndef COMPILER_LINEAR_RECURSION_ELIMINATOR_H
+#define COMPILER_LINEAR_RECURSION_ELIMINATOR_H
+
+#include <memory>
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Makes linear recursive functions tail recursive by introducing the accumulator. Should be applied to the root of the program.
+ *
+ * Function is transformed, if each call of itself is in the return statement like `return a + f(...)`, `return f(...) * a`,
+ * `return f(...) - a` or `return f(...) / a` (all of them must combine results the same way: by addition or by multiplication),
+ * where 'a' is side effect free (see EffectAnalysis) and calls are not inside of while loops.
+ * Function body is moved into the new function with additional accumulator parameter, where such returns become tail calls:
+ *
+ *     func fact(n) {                      --->      func fact_1(n, acc.1) {
+ *         if (n <= 1) return 1;                         if (n <= 1) return acc.1 * 1;
+ *         return n * fact(n - 1);                       return fact_1(n - 1, acc.1 * n);
+ *     }                                             }
+ *                                                   func fact(n) {
+ *                                                       return fact_1(n, 1);
+ *                                                   }
+ *
+ * So TailCallEliminator can replace the recursion with the loop (and FunctionInliner can inline the wrapper).
+ *
+ * Results are combined in the reverse order, so it's a reassociation of the floating point operations,
+ * that's applied only in fast floating-point mode.
+ */
+class LinearRecursionEliminator : public EffectAwareOptimizer {
+
+private:
+    const FloatingPointMode fpMode;
+
+public:
+    explicit LinearRecursionEliminator(FloatingPointMode fpMode_) : EffectAwareOptimizer(false), fpMode(fpMode_) { }
+
+    std::shared_ptr<ASTNode>& optimize(std::shared_ptr<ASTNode>& node) const override;
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_LINEAR_RECURSION_ELIMINATOR_H
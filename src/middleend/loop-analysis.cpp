@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @brief Implementation of helper functions for analysis of while loops (invariants, counters)
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "loop-analysis.h"
+#include "../frontend/ast.h"
+
+static inline bool containsName(const std::vector<const char*>& names, const char* name) {
+    for (const char* other : names) {
+        if (strcmp(other, name) == 0) return true;
+    }
+    return false;
+}
+
+static inline bool isVariableRead(const std::shared_ptr<ASTNode>& node, const char* name) {
+    return node->getType() == VALUE_NODE && strcmp(getIdentifierName(node.get()), name) == 0;
+}
+
+static inline ComparisonOperatorType mirrorComparison(ComparisonOperatorType comparison) {
+    switch (comparison) {
+        case LESS:             return GREATER;
+        case LESS_OR_EQUAL:    return GREATER_OR_EQUAL;
+        case GREATER:          return LESS;
+        case GREATER_OR_EQUAL: return LESS_OR_EQUAL;
+        default:               return comparison;
+    }
+}
+
+size_t countAssignments(const std::shared_ptr<ASTNode>& node, const char* name) {
+    size_t assignmentsNumber = 0;
+    if (node->getType() == VARIABLE_NODE && strcmp(getIdentifierName(node.get()), name) == 0) ++assignmentsNumber;
+    if (node->getType() == VALUE_DECLARATION_NODE && strcmp(getIdentifierName(node->getChildren()[0].get()), name) == 0) ++assignmentsNumber;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        assignmentsNumber += countAssignments(node->getChildren()[i], name);
+    }
+    return assignmentsNumber;
+}
+
+size_t countReads(const std::shared_ptr<ASTNode>& node, const char* name) {
+    size_t readsNumber = isVariableRead(node, name) ? 1 : 0;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        readsNumber += countReads(node->getChildren()[i], name);
+    }
+    return readsNumber;
+}
+
+/**
+ * Checks if the statement is `name = name + c`, `name = c + name` or `name = name - c`.
+ */
+static bool isCounterIncrement(const std::shared_ptr<ASTNode>& statement, const char* name, LoopCounter& counter) {
+    if (statement->getType() != ASSIGNMENT_OPERATOR_NODE) return false;
+    if (strcmp(getIdentifierName(statement->getChildren()[0].get()), name) != 0) return false;
+
+    const auto& value = statement->getChildren()[1];
+    if (value->getType() != OPERATOR_NODE || value->getChildrenNumber() != 2) return false;
+
+    const auto operatorType = dynamic_cast<OperatorNode*>(value.get())->getToken()->getOperatorType();
+    const auto& left = value->getChildren()[0];
+    const auto& right = value->getChildren()[1];
+    std::shared_ptr<ASTNode> constant = nullptr;
+    if (operatorType == ADDITION && isVariableRead(left, name)) constant = right;
+    if (operatorType == ADDITION && isVariableRead(right, name)) constant = left;
+    if (operatorType == SUBTRACTION && isVariableRead(left, name)) constant = right;
+    if (constant == nullptr || constant->getType() != CONSTANT_VALUE_NODE) return false;
+
+    counter.increment = dynamic_cast<ConstantValueNode*>(constant.get())->getValue();
+    counter.isDecrement = operatorType == SUBTRACTION;
+    return counter.increment < 0 || counter.increment > 0;
+}
+
+bool isMonotonicCounter(const LoopCounter& counter) {
+    const double step = counter.getStep();
+    if (step > 0) return counter.comparison == LESS || counter.comparison == LESS_OR_EQUAL;
+    return counter.comparison == GREATER || counter.comparison == GREATER_OR_EQUAL;
+}
+
+void collectVariantNames(const std::shared_ptr<ASTNode>& node, std::vector<const char*>& variantNames) {
+    if (node->getType() == VARIABLE_NODE) variantNames.push_back(getIdentifierName(node.get()));
+    if (node->getType() == VALUE_DECLARATION_NODE) variantNames.push_back(getIdentifierName(node->getChildren()[0].get()));
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        collectVariantNames(node->getChildren()[i], variantNames);
+    }
+}
+
+bool isLoopInvariant(const std::shared_ptr<ASTNode>& expression, const std::vector<const char*>& variantNames) {
+    if (expression->getType() == VALUE_NODE) return !containsName(variantNames, getIdentifierName(expression.get()));
+    if (!isSideEffectFree(expression)) return false;
+
+    const size_t childrenNumber = expression->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (!isLoopInvariant(expression->getChildren()[i], variantNames)) return false;
+    }
+    return true;
+}
+
+bool findLoopCounter(const std::shared_ptr<ASTNode>& loop, LoopCounter& counter) {
+    if (loop->getType() != WHILE_NODE) return false;
+
+    const auto& condition = loop->getChildren()[0];
+    const auto& statements = loop->getChildren()[1]->getChildren()[0];
+    std::vector<const char*> variantNames;
+    collectVariantNames(loop, variantNames);
+
+    const auto comparison = dynamic_cast<ComparisonOperatorNode*>(condition.get())->getToken()->getOperatorType();
+    for (size_t side = 0; side < 2; ++side) {
+        const auto& counterNode = condition->getChildren()[side];
+        const auto& boundNode = condition->getChildren()[1 - side];
+        if (counterNode->getType() != VALUE_NODE || !isLoopInvariant(boundNode, variantNames)) continue;
+
+        const char* name = getIdentifierName(counterNode.get());
+        if (countAssignments(loop->getChildren()[1], name) != 1) continue;
+
+        for (size_t i = 0; i < statements->getChildrenNumber(); ++i) {
+            if (isCounterIncrement(statements->getChildren()[i], name, counter)) {
+                counter.name = name;
+                counter.incrementIndex = i;
+                counter.comparison = (side == 0) ? comparison : mirrorComparison(comparison);
+                counter.bound = boundNode;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool findConstantValueBefore(const std::shared_ptr<ASTNode>& statements, size_t index, const char* name, double& value) {
+    for (size_t i = index; i > 0; --i) {
+        const auto& statement = statements->getChildren()[i - 1];
+        const NodeType type = statement->getType();
+        const bool isDefinition = (type == ASSIGNMENT_OPERATOR_NODE || type == VARIABLE_DECLARATION_NODE || type == VALUE_DECLARATION_NODE) &&
+                                  strcmp(getIdentifierName(statement->getChildren()[0].get()), name) == 0;
+        if (isDefinition) {
+            if (statement->getChildrenNumber() != 2 || statement->getChildren()[1]->getType() != CONSTANT_VALUE_NODE) return false;
+            value = dynamic_cast<ConstantValueNode*>(statement->getChildren()[1].get())->getValue();
+            return true;
+        }
+        if (countAssignments(statement, name) != 0) return false;
+    }
+    return false;
+}
+
+bool findConstantBoundBefore(const std::shared_ptr<ASTNode>& statements, size_t index, const LoopCounter& counter, double& bound) {
+    if (counter.bound->getType() == CONSTANT_VALUE_NODE) {
+        bound = dynamic_cast<ConstantValueNode*>(counter.bound.get())->getValue();
+        return true;
+    }
+    if (counter.bound->getType() == VALUE_NODE) {
+        return findConstantValueBefore(statements, index, getIdentifierName(counter.bound.get()), bound);
+    }
+    return false;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @brief Definition of helper functions for analysis of while loops (invariants, counters)
+ */
+#ifndef COMPILER_LOOP_ANALYSIS_H
+#define COMPILER_LOOP_ANALYSIS_H
+
+#include <memory>
+#include <vector>
+#include "../frontend/ast.h"
+
+/**
+ * Counter of the loop like `while (i < n) { ...; i = i + 1; ... }`:
+ * it's compared with the loop-invariant bound in the condition and is changed by a constant only once per iteration,
+ * by the assignment at the top level of the loop body.
+ */
+struct LoopCounter {
+    const char* name;
+    double increment;                   // Constant, that is added to (or subtracted from) the counter on each iteration
+    bool isDecrement;                   // Counter is changed as `i = i - c`
+    size_t incrementIndex;              // Index of the assignment in the statements of the loop body
+    ComparisonOperatorType comparison;  // Comparison of the counter with the bound, when the counter is on the left side
+    std::shared_ptr<ASTNode> bound;
+
+    /** Returns the value, that is added to the counter on each iteration */
+    inline double getStep() const {
+        return isDecrement ? -increment : increment;
+    }
+
+    /** Returns the counter value after the next iteration, computed exactly as in the loop */
+    inline double advance(double value) const {
+        return isDecrement ? value - increment : value + increment;
+    }
+};
+
+/**
+ * Checks if the loop only moves counter towards the bound (e.g. increasing counter compared with `<` or `<=`),
+ * so if the condition is true for some counter value, it's true for all previous values too.
+ */
+bool isMonotonicCounter(const LoopCounter& counter);
+
+/**
+ * Counts assignments and declarations of the variable or value with the given name in the subtree.
+ */
+size_t countAssignments(const std::shared_ptr<ASTNode>& node, const char* name);
+
+/**
+ * Counts reads of the variable or value with the given name in the subtree.
+ */
+size_t countReads(const std::shared_ptr<ASTNode>& node, const char* name);
+
+/**
+ * Collects names of the variables and values, that are assigned or declared in the subtree.
+ */
+void collectVariantNames(const std::shared_ptr<ASTNode>& node, std::vector<const char*>& variantNames);
+
+/**
+ * Checks if the expression has no side effects and doesn't read the variant variables.
+ */
+bool isLoopInvariant(const std::shared_ptr<ASTNode>& expression, const std::vector<const char*>& variantNames);
+
+/**
+ * Finds the counter of the while loop.
+ * @return false, if the loop has no counter.
+ */
+bool findLoopCounter(const std::shared_ptr<ASTNode>& loop, LoopCounter& counter);
+
+/**
+ * Finds constant value of the variable before the statement with the given index: the last assignment or declaration of
+ * the variable before it must assign a constant.
+ * @return false, if the value is unknown.
+ */
+bool findConstantValueBefore(const std::shared_ptr<ASTNode>& statements, size_t index, const char* name, double& value);
+
+/**
+ * Finds constant value of the loop counter bound before the loop with the given index in the statements:
+ * the bound must be either a constant or a variable with constant value (see findConstantValueBefore).
+ * @return false, if the value is unknown.
+ */
+bool findConstantBoundBefore(const std::shared_ptr<ASTNode>& statements, size_t index, const LoopCounter& counter, double& bound);
+
+#endif // COMPILER_LOOP_ANALYSIS_H
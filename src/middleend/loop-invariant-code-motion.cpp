@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @brief Implementation of loop-invariant code motion
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "effect-analysis.h"
+#include "loop-analysis.h"
+#include "loop-invariant-code-motion.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+static bool isInvariant(const std::shared_ptr<ASTNode>& node, const std::vector<const char*>& variantNames, const EffectAnalysis& effects) {
+    switch (node->getType()) {
+        case CONSTANT_VALUE_NODE:
+            return true;
+        case VALUE_NODE:
+            for (const char* variantName : variantNames) {
+                if (strcmp(getIdentifierName(node.get()), variantName) == 0) return false;
+            }
+            return true;
+        case FUNCTION_CALL_NODE:
+            return effects.isSideEffectFree(node) && isInvariant(node->getChildren()[0], variantNames, effects);
+        case OPERATOR_NODE:
+        case ARGUMENTS_LIST_NODE:
+            for (size_t i = 0; i < node->getChildrenNumber(); ++i) {
+                if (!isInvariant(node->getChildren()[i], variantNames, effects)) return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Replaces maximal invariant expressions in the subtree with reads of temporary variables.
+ * Declarations of the temporary variables are added to the hoisted declarations.
+ */
+static void hoistInvariants(
+    std::shared_ptr<ASTNode>& node,
+    const std::vector<const char*>& variantNames,
+    std::vector<std::shared_ptr<ASTNode>>& hoistedDeclarations,
+    const EffectAnalysis& effects
+) {
+    const bool isComputation = node->getType() == OPERATOR_NODE || node->getType() == FUNCTION_CALL_NODE;
+    if (isComputation && isInvariant(node, variantNames, effects)) {
+        const TokenOrigin originPos = node->getOriginPos();
+        for (const auto& declaration : hoistedDeclarations) {
+            if (isEqualAST(declaration->getChildren()[1], node)) {
+                node = std::make_shared<ValueNode>(originPos, getIdentifierName(declaration->getChildren()[0].get()));
+                return;
+            }
+        }
+
+        char temporaryName[MAX_ID_LENGTH + 1];
+        generateUniqueName(temporaryName, "invariant");
+        hoistedDeclarations.push_back(makeVariableDeclarationNode(originPos, temporaryName, node));
+        node = std::make_shared<ValueNode>(originPos, temporaryName);
+        return;
+    }
+
+    const auto children = node->getChildren();
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        hoistInvariants(children[i], variantNames, hoistedDeclarations, effects);
+    }
+}
+
+std::shared_ptr<ASTNode>& LoopInvariantCodeMotion::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != STATEMENTS_NODE) return node;
+
+    bool hasChanges = false;
+    std::vector<std::shared_ptr<ASTNode>> statements;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        auto& statement = node->getChildren()[i];
+        if (statement->getType() == WHILE_NODE) {
+            std::vector<const char*> variantNames;
+            collectVariantNames(statement, variantNames);
+
+            std::vector<std::shared_ptr<ASTNode>> hoistedDeclarations;
+            hoistInvariants(statement, variantNames, hoistedDeclarations, *effects);
+
+            statements.insert(statements.end(), hoistedDeclarations.begin(), hoistedDeclarations.end());
+            hasChanges = hasChanges || !hoistedDeclarations.empty();
+        }
+        statements.push_back(statement);
+    }
+
+    if (hasChanges) node = std::make_shared<StatementsNode>(node->getOriginPos(), statements);
+    return node;
+}
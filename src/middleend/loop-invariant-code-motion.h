@@ -0,0 +1,36 @@
+/**
+ * @file
+ * @brief Definition of loop-invariant code motion
+ */
+#ifndef COMPILER_LOOP_INVARIANT_CODE_MOTION_H
+#define COMPILER_LOOP_INVARIANT_CODE_MOTION_H
+
+#include <memory>
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Hoists loop-invariant expressions out of the while loops:
+ *
+ *     while (i < n * 2) {          --->      var invariant.1 = n * 2;
+ *         x = x + sqrt(d) * i;               var invariant.2 = sqrt(d);
+ *         i = i + 1;                         while (i < invariant.1) {
+ *     }                                          x = x + invariant.2 * i;
+ *                                                i = i + 1;
+ *                                            }
+ *
+ * Expression is invariant, if it consists of constants, reads of variables that are not assigned or declared in the loop,
+ * arithmetic operators and calls of pure functions without loops and recursion (like 'sqrt', 'pow' or user-defined
+ * functions, see EffectAnalysis). Only maximal invariant expressions are hoisted,
+ * equal expressions share the same temporary variable.
+ *
+ * Arithmetic never fails in the stack machine, so hoisted expressions are evaluated even if the loop is never executed.
+ */
+class LoopInvariantCodeMotion : public EffectAwareOptimizer {
+
+public:
+    LoopInvariantCodeMotion() : EffectAwareOptimizer(true) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_LOOP_INVARIANT_CODE_MOTION_H
@@ -0,0 +1,150 @@
+/**
+ * @file
+ * @brief Implementation of loop unroller
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "loop-analysis.h"
+#include "loop-unroller.h"
+#include "value-range-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Counts iterations of the loop, simulating its counter.
+ * @return false, if the loop is executed more than maxTripCount times.
+ */
+static bool countTrips(const LoopCounter& counter, double initialValue, double bound, size_t maxTripCount, size_t& tripCount) {
+    tripCount = 0;
+    double value = initialValue;
+    while (evaluateComparison(counter.comparison, value, bound)) {
+        if (++tripCount > maxTripCount) return false;
+        value = counter.advance(value);
+    }
+    return true;
+}
+
+/**
+ * Finds the maximal number of iterations of the loop with monotonic counter (see isMonotonicCounter): the counter makes
+ * the most iterations, when it starts from the farthest value and goes to the farthest bound.
+ * @return false, if the loop can be executed more than maxTripCount times.
+ */
+static bool findMaxTripCount(
+    const LoopCounter& counter,
+    const ValueRange& counterRange,
+    const ValueRange& boundRange,
+    size_t maxTripCount,
+    size_t& tripCount
+) {
+    if (!counterRange.hasNumbers() || !boundRange.hasNumbers()) return false;
+
+    const bool isIncreasing = counter.getStep() > 0;
+    const double initialValue = isIncreasing ? counterRange.min : counterRange.max;
+    const double bound = isIncreasing ? boundRange.max : boundRange.min;
+    if (!std::isfinite(initialValue) || !std::isfinite(bound)) return false;
+    return countTrips(counter, initialValue, bound, maxTripCount, tripCount);
+}
+
+static std::vector<std::shared_ptr<ASTNode>> repeatBody(const std::shared_ptr<ASTNode>& body, size_t times) {
+    std::vector<std::shared_ptr<ASTNode>> copies;
+    for (size_t i = 0; i < times; ++i) {
+        copies.push_back(copyAST(body));
+    }
+    return copies;
+}
+
+/**
+ * Builds condition, that is true only if the original condition is true for the next `iterations` counter values.
+ */
+static std::shared_ptr<ComparisonOperatorNode> makeUnrolledCondition(const std::shared_ptr<ASTNode>& loop, const LoopCounter& counter, size_t iterations) {
+    auto condition = dynamic_cast<ComparisonOperatorNode*>(loop->getChildren()[0].get());
+    const TokenOrigin originPos = condition->getOriginPos();
+
+    const double lookahead = counter.getStep() * (double) (iterations - 1);
+    const OperatorType operatorType = lookahead < 0 ? SUBTRACTION : ADDITION;
+    std::shared_ptr<ASTNode> children[2] = { copyAST(condition->getChildren()[0]), copyAST(condition->getChildren()[1]) };
+    for (auto& child : children) {
+        if (child->getType() == VALUE_NODE && strcmp(getIdentifierName(child.get()), counter.name) == 0) {
+            child = makeBinaryOperatorNode(operatorType, child, std::make_shared<ConstantValueNode>(originPos, fabs(lookahead)));
+            break;
+        }
+    }
+    return std::make_shared<ComparisonOperatorNode>(condition->getToken(), children[0], children[1]);
+}
+
+std::shared_ptr<ASTNode>& LoopUnroller::optimize(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != FUNCTION_DEFINITION_NODE) return Optimizer::optimize(node);
+
+    // Unrolling of the nested loops doesn't replace the outer loop nodes, so their ranges are still found
+    ranges = std::make_shared<ValueRangeAnalysis>(node);
+    node = Optimizer::optimize(node);
+    ranges = nullptr;
+    return node;
+}
+
+std::shared_ptr<ASTNode>& LoopUnroller::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != STATEMENTS_NODE) return node;
+
+    bool hasChanges = false;
+    std::vector<std::shared_ptr<ASTNode>> statements;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        const auto& statement = node->getChildren()[i];
+        LoopCounter counter;
+        if (!findLoopCounter(statement, counter)) {
+            statements.push_back(statement);
+            continue;
+        }
+
+        const auto& body = statement->getChildren()[1];
+        const size_t bodySize = countASTNodes(body);
+        const TokenOrigin originPos = statement->getOriginPos();
+
+        const ValueRange counterRange = (ranges != nullptr) ? ranges->getRangeBeforeLoop(statement.get(), counter.name) : ValueRange::makeUnknown();
+        const ValueRange boundRange = (ranges != nullptr) ? ranges->getRangeBeforeLoop(statement.get(), counter.bound) : ValueRange::makeUnknown();
+
+        double initialValue = 0;
+        double bound = 0;
+        size_t tripCount = 0;
+        const bool isFullyUnrollable =
+            (findConstantValueBefore(node, i, counter.name, initialValue) || counterRange.isConstant(initialValue)) &&
+            (findConstantBoundBefore(node, i, counter, bound) || boundRange.isConstant(bound)) &&
+            countTrips(counter, initialValue, bound, MAX_FULL_UNROLL_TRIP_COUNT, tripCount) &&
+            tripCount * bodySize <= MAX_UNROLLED_SIZE;
+        if (isFullyUnrollable) {
+            if (tripCount != 0) statements.push_back(makeBlockNode(originPos, repeatBody(body, tripCount)));
+            hasChanges = true;
+            continue;
+        }
+
+        // Unrolled condition is checked once for several iterations, so it must imply conditions of the skipped checks,
+        // and counter values must be computed exactly in both ways
+        const double step = counter.getStep();
+        const bool isIntegerStep = !(std::floor(step) < step);
+        if (!isMonotonicCounter(counter) || !isIntegerStep) {
+            statements.push_back(statement);
+            continue;
+        }
+
+        size_t maxUnrollFactor = MAX_UNROLL_FACTOR;
+        const LoopProfile* loopProfile = (profile != nullptr) ? profile->getLoop(originPos) : nullptr;
+        if (loopProfile != nullptr) maxUnrollFactor = std::min(maxUnrollFactor, loopProfile->getTypicalTripCount());
+        size_t maxTripCount = 0;
+        if (findMaxTripCount(counter, counterRange, boundRange, maxUnrollFactor, maxTripCount)) maxUnrollFactor = maxTripCount;
+
+        size_t unrollFactor = MAX_UNROLL_FACTOR;
+        while (unrollFactor > 1 && (unrollFactor > maxUnrollFactor || unrollFactor * bodySize > MAX_UNROLLED_SIZE)) unrollFactor /= 2;
+        if (unrollFactor > 1) {
+            const auto unrolledBody = makeBlockNode(originPos, repeatBody(body, unrollFactor));
+            statements.push_back(std::make_shared<WhileNode>(originPos, makeUnrolledCondition(statement, counter, unrollFactor), unrolledBody));
+            hasChanges = true;
+        }
+        statements.push_back(statement);
+    }
+
+    if (hasChanges) node = std::make_shared<StatementsNode>(node->getOriginPos(), statements);
+    return node;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief Definition of loop unroller
+ */
+#ifndef COMPILER_LOOP_UNROLLER_H
+#define COMPILER_LOOP_UNROLLER_H
+
+#include <memory>
+#include "ast-optimizers.h"
+#include "profile.h"
+#include "value-range-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Unrolls while loops with counters (see LoopCounter), so fewer conditions and jumps are executed.
+ *
+ * If both the initial value of the counter and the bound are known constants, and the loop is executed at most
+ * MAX_FULL_UNROLL_TRIP_COUNT times, the loop is replaced with the copies of its body:
+ *
+ *     var i = 0;                    --->      var i = 0;
+ *     while (i < 3) {                         { x = x + i; i = i + 1; }
+ *         x = x + i;                          { x = x + i; i = i + 1; }
+ *         i = i + 1;                          { x = x + i; i = i + 1; }
+ *     }
+ *
+ * Otherwise, if the counter is changed by an integer step and only moves towards the bound, the loop body is repeated
+ * 8, 4 or 2 times (the most, that fits into MAX_UNROLLED_SIZE nodes), and the original loop handles the remaining iterations:
+ *
+ *     while (i < n) {               --->      while (i + 1 < n) {
+ *         x = x + i;                              { x = x + i; i = i + 1; }
+ *         i = i + 1;                              { x = x + i; i = i + 1; }
+ *     }                                       }
+ *                                             while (i < n) {
+ *                                                 x = x + i;
+ *                                                 i = i + 1;
+ *                                             }
+ *
+ * Initial value of the counter and the bound may also be known from the value ranges of the variables before the loop
+ * (see ValueRangeAnalysis). Ranges also limit the unroll factor by the maximal trip count of the loop.
+ *
+ * If the profile is given, the unroll factor doesn't exceed the typical trip count of the loop (see LoopProfile),
+ * so loops, that are never executed or make few iterations, are not partially unrolled.
+ */
+class LoopUnroller : public Optimizer {
+
+private:
+    static constexpr size_t MAX_FULL_UNROLL_TRIP_COUNT = 16;
+    static constexpr size_t MAX_UNROLLED_SIZE = 128;
+    static constexpr size_t MAX_UNROLL_FACTOR = 8;
+
+    const std::shared_ptr<const Profile> profile;
+    mutable std::shared_ptr<const ValueRangeAnalysis> ranges = nullptr; // Ranges of the currently optimized function
+
+public:
+    explicit LoopUnroller(const std::shared_ptr<const Profile>& profile_ = nullptr) : Optimizer(true), profile(profile_) { }
+
+    std::shared_ptr<ASTNode>& optimize(std::shared_ptr<ASTNode>& node) const override;
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_LOOP_UNROLLER_H
@@ -0,0 +1,152 @@
+/**
+ * @file
+ * @brief Implementation of optimization levels and pass pipelines
+ */
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ast-optimizers.h"
+#include "branch-layout-optimizer.h"
+#include "common-subexpression-eliminator.h"
+#include "compile-time-evaluator.h"
+#include "dead-code-eliminator.h"
+#include "dead-store-eliminator.h"
+#include "function-inliner.h"
+#include "function-specializer.h"
+#include "induction-variable-optimizer.h"
+#include "linear-recursion-eliminator.h"
+#include "loop-invariant-code-motion.h"
+#include "loop-unroller.h"
+#include "pass-pipeline.h"
+#include "tail-call-eliminator.h"
+#include "value-range-optimizer.h"
+
+typedef std::shared_ptr<Optimizer> (*PassFactory)(const PipelineOptions& options);
+
+struct Pass {
+    const char* name;
+    PassFactory create;
+};
+
+static const Pass passes[] = {
+    { "unary-addition",                  [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<UnaryAdditionOptimizer>(); } },
+    { "arithmetic-negation",             [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<ArithmeticNegationOptimizer>(); } },
+    { "arithmetic-reassociation",        [](const PipelineOptions& options) -> std::shared_ptr<Optimizer> { return std::make_shared<ArithmeticReassociationOptimizer>(options.fpMode); } },
+    { "trivial-operations",              [](const PipelineOptions& options) -> std::shared_ptr<Optimizer> { return std::make_shared<TrivialOperationsOptimizer>(options.fpMode); } },
+    { "dead-code-eliminator",            [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<DeadCodeEliminator>(); } },
+    { "linear-recursion-eliminator",     [](const PipelineOptions& options) -> std::shared_ptr<Optimizer> { return std::make_shared<LinearRecursionEliminator>(options.fpMode); } },
+    { "function-inliner",                [](const PipelineOptions& options) -> std::shared_ptr<Optimizer> { return std::make_shared<FunctionInliner>(options.profile); } },
+    { "function-specializer",            [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<FunctionSpecializer>(); } },
+    { "tail-call-eliminator",            [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<TailCallEliminator>(); } },
+    { "compile-time-evaluator",          [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<CompileTimeEvaluator>(); } },
+    { "loop-invariant-code-motion",      [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<LoopInvariantCodeMotion>(); } },
+    { "induction-variable-optimizer",    [](const PipelineOptions& options) -> std::shared_ptr<Optimizer> { return std::make_shared<InductionVariableOptimizer>(options.fpMode); } },
+    { "loop-unroller",                   [](const PipelineOptions& options) -> std::shared_ptr<Optimizer> { return std::make_shared<LoopUnroller>(options.profile); } },
+    { "common-subexpression-eliminator", [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<CommonSubexpressionEliminator>(); } },
+    { "dead-store-eliminator",           [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<DeadStoreEliminator>(); } },
+    { "branch-layout-optimizer",         [](const PipelineOptions& options) -> std::shared_ptr<Optimizer> { return std::make_shared<BranchLayoutOptimizer>(options.profile); } },
+    { "value-range-optimizer",           [](const PipelineOptions&) -> std::shared_ptr<Optimizer> { return std::make_shared<ValueRangeOptimizer>(); } },
+};
+
+static const char* const O1_PASSES[] = {
+    "unary-addition",
+    "arithmetic-negation",
+    "arithmetic-reassociation",
+    "trivial-operations",
+    "dead-code-eliminator",
+};
+
+static const char* const O2_PASSES[] = {
+    "unary-addition",
+    "arithmetic-negation",
+    "linear-recursion-eliminator",
+    "function-inliner",
+    "function-specializer",
+    "tail-call-eliminator",
+    "arithmetic-reassociation",
+    "compile-time-evaluator",
+    "trivial-operations",
+    "value-range-optimizer",
+    "dead-code-eliminator",
+    "loop-invariant-code-motion",
+    "induction-variable-optimizer",
+    "loop-unroller",
+    "common-subexpression-eliminator",
+    "dead-store-eliminator",
+    "dead-code-eliminator",
+};
+
+// Run after O2 passes, when loops are already transformed
+static const char* const O3_CLEANUP_PASSES[] = {
+    "arithmetic-reassociation",
+    "compile-time-evaluator",
+    "trivial-operations",
+    "value-range-optimizer",
+    "dead-code-eliminator",
+    "common-subexpression-eliminator",
+    "dead-store-eliminator",
+    "dead-code-eliminator",
+};
+
+static bool addPass(CompositeOptimizer& pipeline, const char* name, const PipelineOptions& options) {
+    for (const Pass& pass : passes) {
+        if (strcmp(pass.name, name) == 0) {
+            pipeline.addOptimizer(pass.create(options));
+            return true;
+        }
+    }
+    return false;
+}
+
+template <size_t N>
+static void addPasses(CompositeOptimizer& pipeline, const char* const (&names)[N], const PipelineOptions& options) {
+    for (const char* name : names) {
+        const bool isKnownPass = addPass(pipeline, name, options);
+        assert(isKnownPass);
+        (void) isKnownPass;
+    }
+}
+
+std::shared_ptr<CompositeOptimizer> buildPipeline(OptimizationLevel level, const PipelineOptions& options) {
+    auto pipeline = std::make_shared<CompositeOptimizer>();
+    switch (level) {
+        case O0:
+            break;
+        case O1:
+            addPasses(*pipeline, O1_PASSES, options);
+            break;
+        case O2:
+        case O3:
+            addPasses(*pipeline, O2_PASSES, options);
+            if (level == O3) addPasses(*pipeline, O3_CLEANUP_PASSES, options);
+            if (options.profile != nullptr) addPass(*pipeline, "branch-layout-optimizer", options);
+            break;
+        default:
+            assert(!"Optimization level not implemented");
+    }
+    return pipeline;
+}
+
+std::shared_ptr<CompositeOptimizer> buildPipeline(const char* passNames, const PipelineOptions& options) {
+    auto pipeline = std::make_shared<CompositeOptimizer>();
+    const char* begin = passNames;
+    while (*begin != '\0') {
+        const char* end = strchr(begin, ',');
+        if (end == nullptr) end = begin + strlen(begin);
+
+        const std::string name(begin, end);
+        if (!addPass(*pipeline, name.c_str(), options)) return nullptr;
+        begin = (*end == ',') ? end + 1 : end;
+    }
+    return pipeline;
+}
+
+std::vector<const char*> getPassNames() {
+    std::vector<const char*> names;
+    for (const Pass& pass : passes) {
+        names.push_back(pass.name);
+    }
+    return names;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Definition of optimization levels and pass pipelines
+ */
+#ifndef COMPILER_PASS_PIPELINE_H
+#define COMPILER_PASS_PIPELINE_H
+
+#include <memory>
+#include <vector>
+#include "ast-optimizers.h"
+#include "profile.h"
+
+/**
+ * Optimization levels. Each level includes the passes of the previous one.
+ *
+ *   - O0: no optimizations. The fastest compilation, the code follows the source exactly (useful for debugging the compiler).
+ *   - O1: local simplifications of expressions and removal of unreachable code. Linear compilation time, code never grows.
+ *   - O2: interprocedural and loop optimizations (inlining, specialization, tail calls, compile-time evaluation, value ranges,
+ *         loop-invariant code motion, induction variables, unrolling, common subexpressions, dead stores).
+ *         Compilation time depends on the number of calls and loops, code may grow because of inlining and unrolling.
+ *   - O3: O2 with the second round of the cleanup passes after loop transformations (they expose new constants and
+ *         common subexpressions). Almost twice slower compilation for a few more executed instructions saved.
+ *
+ * Profile-guided branch layout is added to O2 and O3, if the profile is given.
+ */
+enum OptimizationLevel {
+    O0,
+    O1,
+    O2,
+    O3,
+};
+
+struct PipelineOptions {
+    FloatingPointMode fpMode;
+    std::shared_ptr<const Profile> profile;
+};
+
+/**
+ * Builds the pipeline of the passes, that are run on the given optimization level.
+ */
+std::shared_ptr<CompositeOptimizer> buildPipeline(OptimizationLevel level, const PipelineOptions& options);
+
+/**
+ * Builds the pipeline of the passes with the given names (see getPassNames) separated by commas, like "function-inliner,dead-code-eliminator".
+ * Passes are run in the given order, the same pass can be given several times.
+ * @return pipeline or nullptr, if there is an unknown pass name.
+ */
+std::shared_ptr<CompositeOptimizer> buildPipeline(const char* passNames, const PipelineOptions& options);
+
+/**
+ * Returns names of all passes, that can be used in the pipeline.
+ */
+std::vector<const char*> getPassNames();
+
+#endif // COMPILER_PASS_PIPELINE_H
@@ -0,0 +1,309 @@
+/**
+ * @file
+ * @brief Implementation of execution profile of the program (calls, branches and loop trip counts)
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "call-graph.h"
+#include "interpreter.h"
+#include "profile.h"
+#include "../frontend/ast.h"
+#include "../util/comparison.h"
+#include "../util/constants.h"
+
+static constexpr size_t PROFILING_MAX_CALL_DEPTH = 4096;
+static constexpr size_t MAX_PROFILE_LINE_LENGTH = 1024;
+
+// Signs of the comparisons in the profile file in the order of ComparisonOperatorType
+static const char* const COMPARISON_SIGNS[] = { "<", "<=", ">", ">=", "==", "!=" };
+
+size_t LoopProfile::getBucket(size_t tripCount) {
+    size_t bucket = 0;
+    while (tripCount != 0 && bucket + 1 < BUCKETS_NUMBER) {
+        tripCount /= 2;
+        ++bucket;
+    }
+    return bucket;
+}
+
+size_t LoopProfile::getBucketLowerBound(size_t bucket) {
+    return (bucket == 0) ? 0 : ((size_t) 1 << (bucket - 1));
+}
+
+size_t LoopProfile::getExecutionsNumber() const {
+    size_t executionsNumber = 0;
+    for (size_t count : tripCountHistogram) executionsNumber += count;
+    return executionsNumber;
+}
+
+size_t LoopProfile::getTypicalTripCount() const {
+    const size_t executionsNumber = getExecutionsNumber();
+    size_t countedExecutions = 0;
+    for (size_t bucket = 0; bucket < BUCKETS_NUMBER; ++bucket) {
+        countedExecutions += tripCountHistogram[bucket];
+        if (2 * countedExecutions >= executionsNumber && countedExecutions != 0) return getBucketLowerBound(bucket);
+    }
+    return 0;
+}
+
+void Profile::addFunction(const char* name) {
+    functions.insert({ name, { 0, 0 } });
+}
+
+void Profile::addBranch(TokenOrigin originPos, ComparisonOperatorType conditionType) {
+    branches.insert({ getPosition(originPos), { conditionType, 0, 0 } });
+}
+
+void Profile::addLoop(TokenOrigin originPos) {
+    loops.insert({ getPosition(originPos), LoopProfile() });
+}
+
+void Profile::recordCall(const char* name, bool isRepeated) {
+    auto& function = functions[name];
+    ++function.callsNumber;
+    if (isRepeated) ++function.repeatedCallsNumber;
+}
+
+void Profile::recordBranch(TokenOrigin originPos, bool isTaken) {
+    auto& branch = branches[getPosition(originPos)];
+    if (isTaken) {
+        ++branch.takenNumber;
+    } else {
+        ++branch.notTakenNumber;
+    }
+}
+
+void Profile::recordLoop(TokenOrigin originPos, size_t tripCount) {
+    ++loops[getPosition(originPos)].tripCountHistogram[LoopProfile::getBucket(tripCount)];
+}
+
+const FunctionProfile* Profile::getFunction(const char* name) const {
+    const auto function = functions.find(name);
+    return (function != functions.end()) ? &function->second : nullptr;
+}
+
+bool Profile::getBranch(const ASTNode* statement, BranchProfile& branch) const {
+    const auto found = branches.find(getPosition(statement->getOriginPos()));
+    if (found == branches.end()) return false;
+
+    const auto condition = dynamic_cast<const ComparisonOperatorNode*>(statement->getChildren()[0].get());
+    if (condition == nullptr) return false;
+    const ComparisonOperatorType conditionType = condition->getToken()->getOperatorType();
+    branch = found->second;
+    if (conditionType == branch.conditionType) return true;
+    if (conditionType != negateComparison(branch.conditionType)) return false;
+
+    branch = { conditionType, branch.notTakenNumber, branch.takenNumber };
+    return true;
+}
+
+const LoopProfile* Profile::getLoop(TokenOrigin originPos) const {
+    const auto loop = loops.find(getPosition(originPos));
+    return (loop != loops.end()) ? &loop->second : nullptr;
+}
+
+bool Profile::isHotFunction(const char* name) const {
+    const FunctionProfile* function = getFunction(name);
+    if (function == nullptr || function->callsNumber < MIN_HOT_CALLS_NUMBER) return false;
+
+    size_t maxCallsNumber = 0;
+    for (const auto& other : functions) {
+        if (other.second.callsNumber > maxCallsNumber) maxCallsNumber = other.second.callsNumber;
+    }
+    return function->callsNumber * HOT_FUNCTION_CALLS_RATIO >= maxCallsNumber;
+}
+
+bool Profile::isColdFunction(const char* name) const {
+    const FunctionProfile* function = getFunction(name);
+    return function != nullptr && function->callsNumber == 0;
+}
+
+bool Profile::isMemoizationProfitable(const char* name) const {
+    const FunctionProfile* function = getFunction(name);
+    return function != nullptr &&
+           function->callsNumber >= MIN_MEMOIZED_CALLS_NUMBER &&
+           2 * function->repeatedCallsNumber >= function->callsNumber;
+}
+
+void Profile::dump(FILE* file) const {
+    for (const auto& function : functions) {
+        fprintf(file, "function %s %zu %zu\n", function.first.c_str(), function.second.callsNumber, function.second.repeatedCallsNumber);
+    }
+    for (const auto& branch : branches) {
+        fprintf(file, "branch %zu:%zu %s %zu %zu\n", branch.first.first, branch.first.second, COMPARISON_SIGNS[branch.second.conditionType],
+                branch.second.takenNumber, branch.second.notTakenNumber);
+    }
+    for (const auto& loop : loops) {
+        fprintf(file, "loop %zu:%zu", loop.first.first, loop.first.second);
+        size_t bucketsNumber = LoopProfile::BUCKETS_NUMBER;
+        while (bucketsNumber > 0 && loop.second.tripCountHistogram[bucketsNumber - 1] == 0) --bucketsNumber;
+        for (size_t bucket = 0; bucket < bucketsNumber; ++bucket) {
+            fprintf(file, " %zu", loop.second.tripCountHistogram[bucket]);
+        }
+        fprintf(file, "\n");
+    }
+}
+
+static bool parseNumber(const char* token, size_t& value) {
+    if (token == nullptr || *token < '0' || *token > '9') return false;
+
+    char* end = nullptr;
+    value = strtoull(token, &end, 10);
+    return *end == '\0';
+}
+
+static bool parseComparison(const char* token, ComparisonOperatorType& operatorType) {
+    if (token == nullptr) return false;
+
+    for (size_t i = 0; i < sizeof(COMPARISON_SIGNS) / sizeof(COMPARISON_SIGNS[0]); ++i) {
+        if (strcmp(token, COMPARISON_SIGNS[i]) == 0) {
+            operatorType = (ComparisonOperatorType) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parsePosition(const char* token, TokenOrigin& originPos) {
+    if (token == nullptr) return false;
+
+    const char* separator = strchr(token, ':');
+    if (separator == nullptr) return false;
+    const std::string line(token, separator);
+    return parseNumber(line.c_str(), originPos.line) && parseNumber(separator + 1, originPos.column);
+}
+
+bool Profile::load(FILE* file) {
+    const char* const delimiters = " \t\r\n";
+    char line[MAX_PROFILE_LINE_LENGTH];
+    while (fgets(line, MAX_PROFILE_LINE_LENGTH, file) != nullptr) {
+        const char* kind = strtok(line, delimiters);
+        if (kind == nullptr) continue;
+
+        if (strcmp(kind, "function") == 0) {
+            const char* name = strtok(nullptr, delimiters);
+            FunctionProfile function = { 0, 0 };
+            if (name == nullptr ||
+                !parseNumber(strtok(nullptr, delimiters), function.callsNumber) ||
+                !parseNumber(strtok(nullptr, delimiters), function.repeatedCallsNumber)) return false;
+            functions[name] = function;
+        } else if (strcmp(kind, "branch") == 0) {
+            TokenOrigin originPos = { 0, 0 };
+            BranchProfile branch = { LESS, 0, 0 };
+            if (!parsePosition(strtok(nullptr, delimiters), originPos) ||
+                !parseComparison(strtok(nullptr, delimiters), branch.conditionType) ||
+                !parseNumber(strtok(nullptr, delimiters), branch.takenNumber) ||
+                !parseNumber(strtok(nullptr, delimiters), branch.notTakenNumber)) return false;
+            branches[getPosition(originPos)] = branch;
+        } else if (strcmp(kind, "loop") == 0) {
+            TokenOrigin originPos = { 0, 0 };
+            if (!parsePosition(strtok(nullptr, delimiters), originPos)) return false;
+            LoopProfile loop = LoopProfile();
+            size_t bucket = 0;
+            for (const char* token = strtok(nullptr, delimiters); token != nullptr; token = strtok(nullptr, delimiters)) {
+                if (bucket == LoopProfile::BUCKETS_NUMBER || !parseNumber(token, loop.tripCountHistogram[bucket])) return false;
+                ++bucket;
+            }
+            loops[getPosition(originPos)] = loop;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Interpreter, that executes the whole program with input and output, and records its profile.
+ */
+class ProfilingInterpreter : public Interpreter {
+
+private:
+    Profile& profile;
+    std::map<std::string, std::deque<std::vector<double>>> memoizationTables; // Simulated tables of the memoized calls
+
+protected:
+    bool callInternalFunction(const char* functionName, const std::vector<double>& arguments, double& result) override {
+        if (strcmp(functionName, "read") == 0 && arguments.empty()) {
+            return scanf("%lf", &result) == 1;
+        }
+        if (strcmp(functionName, "print") == 0 && arguments.size() == 1) {
+            printf("%lg\n", arguments[0]);
+            result = 0;
+            return true;
+        }
+        return Interpreter::callInternalFunction(functionName, arguments, result);
+    }
+
+    bool isAcceptableResult(double /* result */) const override {
+        return true;
+    }
+
+    void onFunctionCall(const char* functionName, const std::vector<double>& arguments) override {
+        // The oldest entry of the table is replaced, when it's full
+        auto& table = memoizationTables[functionName];
+        const bool isRepeated = std::find(table.begin(), table.end(), arguments) != table.end();
+        if (!isRepeated) {
+            if (table.size() == MEMOIZATION_TABLE_CAPACITY) table.pop_front();
+            table.push_back(arguments);
+        }
+        profile.recordCall(functionName, isRepeated);
+    }
+
+    void onBranch(const ASTNode* statement, bool isTaken) override {
+        profile.recordBranch(statement->getOriginPos(), isTaken);
+    }
+
+    void onLoopExit(const ASTNode* loop, size_t tripCount) override {
+        profile.recordLoop(loop->getOriginPos(), tripCount);
+    }
+
+public:
+    ProfilingInterpreter(const CallGraph& callGraph_, Profile& profile_) :
+        Interpreter(callGraph_, SIZE_MAX, PROFILING_MAX_CALL_DEPTH), profile(profile_) { }
+};
+
+/**
+ * Adds all functions, branches and loops of the subtree to the profile, so the never executed ones are known too.
+ */
+static void addStatements(Profile& profile, const std::shared_ptr<ASTNode>& node) {
+    switch (node->getType()) {
+        case FUNCTION_DEFINITION_NODE:
+            profile.addFunction(dynamic_cast<FunctionDefinitionNode*>(node.get())->getFunctionName()->getName());
+            break;
+        case IF_NODE:
+        case IF_ELSE_NODE:
+            profile.addBranch(node->getOriginPos(), dynamic_cast<ComparisonOperatorNode*>(node->getChildren()[0].get())->getToken()->getOperatorType());
+            break;
+        case WHILE_NODE:
+            profile.addLoop(node->getOriginPos());
+            break;
+        default:
+            break;
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        addStatements(profile, node->getChildren()[i]);
+    }
+}
+
+std::shared_ptr<Profile> collectProfile(const std::shared_ptr<ASTNode>& program) {
+    const CallGraph callGraph(program);
+    if (!callGraph.hasFunction("main")) return nullptr;
+
+    auto profile = std::make_shared<Profile>();
+    addStatements(*profile, program);
+
+    ProfilingInterpreter interpreter(callGraph, *profile);
+    double result = 0;
+    if (!interpreter.call("main", { }, result)) return nullptr;
+    return profile;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @brief Definition of execution profile of the program (calls, branches and loop trip counts)
+ */
+#ifndef COMPILER_PROFILE_H
+#define COMPILER_PROFILE_H
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../frontend/ast.h"
+#include "../util/TokenOrigin.h"
+
+struct FunctionProfile {
+    size_t callsNumber;
+    size_t repeatedCallsNumber; // Calls, whose arguments would be found in the memoization table of MEMOIZATION_TABLE_CAPACITY entries
+};
+
+struct BranchProfile {
+    ComparisonOperatorType conditionType; // Comparison of the condition, the counts refer to
+    size_t takenNumber;                   // Condition is true
+    size_t notTakenNumber;                // Condition is false
+};
+
+/**
+ * Histogram of loop trip counts. Bucket 0 counts loops that were not entered, bucket k > 0 counts trip counts in [2^(k-1), 2^k).
+ * The last bucket also counts all greater trip counts.
+ */
+struct LoopProfile {
+    static constexpr size_t BUCKETS_NUMBER = 16;
+
+    size_t tripCountHistogram[BUCKETS_NUMBER];
+
+    static size_t getBucket(size_t tripCount);
+    static size_t getBucketLowerBound(size_t bucket);
+
+    size_t getExecutionsNumber() const;
+
+    /**
+     * Returns the lower bound of the bucket, that contains median trip count, or 0, if the loop was never executed.
+     */
+    size_t getTypicalTripCount() const;
+};
+
+/**
+ * Execution profile of the program. Functions are identified by names, branches and loops by the origin position of
+ * their statements in the source code, so the profile collected on the original program can be applied to the optimized one.
+ * Copies of the statement, made by inlining or unrolling, keep its origin position, so they share its counts.
+ * Branch counts also remember the comparison of the condition, so they stay right for the copies and statements,
+ * whose condition was negated (e.g. by the branch layout optimizer), and aren't applied to the rewritten conditions.
+ * Statements and functions, that are unknown to the profile (e.g. generated by optimizations), have no profile data.
+ *
+ * Profile is stored in the text file, that consists of the lines like:
+ *
+ *     function fib 177 160         (calls number, repeated calls number)
+ *     branch 12:5 < 100 3          (comparison of the condition, taken number, not taken number)
+ *     loop 7:5 0 1 0 4             (trip count histogram, trailing zero buckets are omitted)
+ */
+class Profile {
+
+private:
+    typedef std::pair<size_t, size_t> Position;
+
+    static constexpr size_t HOT_FUNCTION_CALLS_RATIO = 10;
+    static constexpr size_t MIN_HOT_CALLS_NUMBER = 64;
+    static constexpr size_t MIN_MEMOIZED_CALLS_NUMBER = 16;
+
+    std::map<std::string, FunctionProfile> functions;
+    std::map<Position, BranchProfile> branches;
+    std::map<Position, LoopProfile> loops;
+
+    static Position getPosition(TokenOrigin originPos) {
+        return { originPos.line, originPos.column };
+    }
+
+public:
+    void addFunction(const char* name);
+    void addBranch(TokenOrigin originPos, ComparisonOperatorType conditionType);
+    void addLoop(TokenOrigin originPos);
+
+    void recordCall(const char* name, bool isRepeated);
+    void recordBranch(TokenOrigin originPos, bool isTaken);
+    void recordLoop(TokenOrigin originPos, size_t tripCount);
+
+    /** @return profile of the function or nullptr, if the function is unknown */
+    const FunctionProfile* getFunction(const char* name) const;
+    /**
+     * Finds counts of the if statement by its origin position. They are swapped, if the condition of the statement is
+     * the negated condition of the profiled one.
+     * @return false, if the statement is unknown or its condition is neither the profiled one, nor its negation.
+     */
+    bool getBranch(const ASTNode* statement, BranchProfile& branch) const;
+    /** @return profile of the while loop at the given position or nullptr, if it's unknown */
+    const LoopProfile* getLoop(TokenOrigin originPos) const;
+
+    /**
+     * Checks if the function is called at least MIN_HOT_CALLS_NUMBER times and at least 1/HOT_FUNCTION_CALLS_RATIO times
+     * as often as the most called function.
+     */
+    bool isHotFunction(const char* name) const;
+
+    /**
+     * Checks if the function is known, but never called.
+     */
+    bool isColdFunction(const char* name) const;
+
+    /**
+     * Checks if memoization of the function pays off: it's called at least MIN_MEMOIZED_CALLS_NUMBER times and
+     * at least half of its calls repeat the previous ones.
+     */
+    bool isMemoizationProfitable(const char* name) const;
+
+    void dump(FILE* file) const;
+
+    /**
+     * Reads profile written by dump.
+     * @return false, if the file is malformed.
+     */
+    bool load(FILE* file);
+};
+
+/**
+ * Runs the main function of the program by the profiling interpreter (see Interpreter) and collects its profile.
+ * 'read' and 'print' read from the standard input and write to the standard output, like in the stack machine.
+ * The stack machine is an external submodule without instrumentation hooks, so the profile is collected on the AST
+ * instead of the bytecode run: the interpreter prints the same output as the compiled program, and the counts
+ * refer to the source statements, not to the instructions.
+ * @return profile or nullptr, if the program failed (e.g. RAM overflow or too deep recursion).
+ */
+std::shared_ptr<Profile> collectProfile(const std::shared_ptr<ASTNode>& program);
+
+#endif // COMPILER_PROFILE_H
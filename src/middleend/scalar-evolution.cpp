@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @brief Implementation of scalar evolution analysis (affine functions of loop counters and accumulators)
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "loop-analysis.h"
+#include "scalar-evolution.h"
+#include "../frontend/ast.h"
+
+static inline bool isOne(const InvariantValue& value) {
+    return value.isConstant() && !(value.constant < 1 || value.constant > 1);
+}
+
+std::shared_ptr<ASTNode> InvariantValue::toExpression(TokenOrigin originPos) const {
+    if (isConstant()) return std::make_shared<ConstantValueNode>(originPos, constant);
+    return expression;
+}
+
+InvariantValue operator+(const InvariantValue& left, const InvariantValue& right) {
+    if (left.isConstant() && right.isConstant()) return InvariantValue(left.constant + right.constant);
+    if (left.isZero()) return right;
+    if (right.isZero()) return left;
+
+    const TokenOrigin originPos = left.isConstant() ? right.expression->getOriginPos() : left.expression->getOriginPos();
+    return InvariantValue(makeBinaryOperatorNode(ADDITION, left.toExpression(originPos), right.toExpression(originPos)));
+}
+
+InvariantValue operator-(const InvariantValue& left, const InvariantValue& right) {
+    if (left.isConstant() && right.isConstant()) return InvariantValue(left.constant - right.constant);
+    if (right.isZero()) return left;
+
+    const TokenOrigin originPos = left.isConstant() ? right.expression->getOriginPos() : left.expression->getOriginPos();
+    return InvariantValue(makeBinaryOperatorNode(SUBTRACTION, left.toExpression(originPos), right.toExpression(originPos)));
+}
+
+InvariantValue operator*(const InvariantValue& left, const InvariantValue& right) {
+    if (left.isConstant() && right.isConstant()) return InvariantValue(left.constant * right.constant);
+    if (left.isZero() || right.isZero()) return InvariantValue(0.0);
+    if (isOne(left)) return right;
+    if (isOne(right)) return left;
+
+    const TokenOrigin originPos = left.isConstant() ? right.expression->getOriginPos() : left.expression->getOriginPos();
+    return InvariantValue(makeBinaryOperatorNode(MULTIPLICATION, left.toExpression(originPos), right.toExpression(originPos)));
+}
+
+InvariantValue operator/(const InvariantValue& left, const InvariantValue& right) {
+    if (left.isConstant() && right.isConstant()) return InvariantValue(left.constant / right.constant);
+    if (isOne(right)) return left;
+
+    const TokenOrigin originPos = left.isConstant() ? right.expression->getOriginPos() : left.expression->getOriginPos();
+    return InvariantValue(makeBinaryOperatorNode(DIVISION, left.toExpression(originPos), right.toExpression(originPos)));
+}
+
+InvariantValue operator-(const InvariantValue& value) {
+    if (value.isConstant()) return InvariantValue(-value.constant);
+
+    const TokenOrigin originPos = value.expression->getOriginPos();
+    return InvariantValue(std::make_shared<OperatorNode>(std::make_shared<ArithmeticNegationOperator>(originPos), value.expression));
+}
+
+bool findAffineForm(
+    const std::shared_ptr<ASTNode>& expression,
+    const LoopCounter& counter,
+    const std::vector<const char*>& variantNames,
+    AffineForm& form
+) {
+    if (expression->getType() == CONSTANT_VALUE_NODE) {
+        form = { InvariantValue(0.0), InvariantValue(dynamic_cast<ConstantValueNode*>(expression.get())->getValue()) };
+        return true;
+    }
+    if (expression->getType() == VALUE_NODE && strcmp(getIdentifierName(expression.get()), counter.name) == 0) {
+        form = { InvariantValue(1.0), InvariantValue(0.0) };
+        return true;
+    }
+
+    if (expression->getType() == OPERATOR_NODE) {
+        const auto operatorType = dynamic_cast<OperatorNode*>(expression.get())->getToken()->getOperatorType();
+        AffineForm left;
+        if (!findAffineForm(expression->getChildren()[0], counter, variantNames, left)) return false;
+        if (expression->getChildrenNumber() == 1) {
+            form = (operatorType == ARITHMETIC_NEGATION) ? AffineForm { -left.coefficient, -left.offset } : left;
+            return true;
+        }
+
+        AffineForm right;
+        if (!findAffineForm(expression->getChildren()[1], counter, variantNames, right)) return false;
+        switch (operatorType) {
+            case ADDITION:
+                form = { left.coefficient + right.coefficient, left.offset + right.offset };
+                return true;
+            case SUBTRACTION:
+                form = { left.coefficient - right.coefficient, left.offset - right.offset };
+                return true;
+            case MULTIPLICATION:
+                if (left.coefficient.isZero()) {
+                    form = { left.offset * right.coefficient, left.offset * right.offset };
+                    return true;
+                }
+                if (right.coefficient.isZero()) {
+                    form = { left.coefficient * right.offset, left.offset * right.offset };
+                    return true;
+                }
+                return false;
+            case DIVISION:
+                if (!right.coefficient.isZero()) return false;
+                form = { left.coefficient / right.offset, left.offset / right.offset };
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    if (!isLoopInvariant(expression, variantNames)) return false;
+    form = { InvariantValue(0.0), InvariantValue(expression) };
+    return true;
+}
+
+/**
+ * Splits the sum into the single read of the accumulator and the affine function of the counter.
+ */
+static bool splitAccumulation(
+    const std::shared_ptr<ASTNode>& expression,
+    bool isNegated,
+    const char* name,
+    const LoopCounter& counter,
+    const std::vector<const char*>& variantNames,
+    bool& hasAccumulator,
+    AffineForm& increment
+) {
+    if (expression->getType() == VALUE_NODE && strcmp(getIdentifierName(expression.get()), name) == 0) {
+        if (isNegated || hasAccumulator) return false;
+        hasAccumulator = true;
+        return true;
+    }
+
+    if (expression->getType() == OPERATOR_NODE && expression->getChildrenNumber() == 2) {
+        const auto operatorType = dynamic_cast<OperatorNode*>(expression.get())->getToken()->getOperatorType();
+        if (operatorType == ADDITION || operatorType == SUBTRACTION) {
+            return splitAccumulation(expression->getChildren()[0], isNegated, name, counter, variantNames, hasAccumulator, increment) &&
+                   splitAccumulation(expression->getChildren()[1], isNegated != (operatorType == SUBTRACTION), name, counter, variantNames, hasAccumulator, increment);
+        }
+    }
+
+    AffineForm term;
+    if (!findAffineForm(expression, counter, variantNames, term)) return false;
+    if (isNegated) {
+        increment = { increment.coefficient - term.coefficient, increment.offset - term.offset };
+    } else {
+        increment = { increment.coefficient + term.coefficient, increment.offset + term.offset };
+    }
+    return true;
+}
+
+bool findAccumulator(const std::shared_ptr<ASTNode>& loop, size_t index, const LoopCounter& counter, Accumulator& accumulator) {
+    const auto& statement = loop->getChildren()[1]->getChildren()[0]->getChildren()[index];
+    if (statement->getType() != ASSIGNMENT_OPERATOR_NODE) return false;
+
+    const char* name = getIdentifierName(statement->getChildren()[0].get());
+    if (strcmp(name, counter.name) == 0) return false;
+    if (countAssignments(loop, name) != 1 || countReads(loop, name) != 1) return false;
+
+    std::vector<const char*> variantNames;
+    collectVariantNames(loop, variantNames);
+
+    bool hasAccumulator = false;
+    AffineForm increment = { InvariantValue(0.0), InvariantValue(0.0) };
+    if (!splitAccumulation(statement->getChildren()[1], false, name, counter, variantNames, hasAccumulator, increment)) return false;
+    if (!hasAccumulator) return false;
+
+    accumulator = { name, increment, index };
+    return true;
+}
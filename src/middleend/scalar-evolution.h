@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Definition of scalar evolution analysis (affine functions of loop counters and accumulators)
+ */
+#ifndef COMPILER_SCALAR_EVOLUTION_H
+#define COMPILER_SCALAR_EVOLUTION_H
+
+#include <memory>
+#include <vector>
+#include "loop-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Loop-invariant value, that is either a known constant or an invariant expression.
+ */
+struct InvariantValue {
+    std::shared_ptr<ASTNode> expression;  // nullptr, if the value is the constant
+    double constant;
+
+    explicit InvariantValue(double constant_ = 0) : expression(nullptr), constant(constant_) { }
+    explicit InvariantValue(const std::shared_ptr<ASTNode>& expression_) : expression(expression_), constant(0) { }
+
+    inline bool isConstant() const {
+        return expression == nullptr;
+    }
+
+    inline bool isZero() const {
+        return isConstant() && !(constant < 0 || constant > 0);
+    }
+
+    /** Builds the expression, that evaluates the value. The result shares nodes with this value */
+    std::shared_ptr<ASTNode> toExpression(TokenOrigin originPos) const;
+};
+
+InvariantValue operator+(const InvariantValue& left, const InvariantValue& right);
+InvariantValue operator-(const InvariantValue& left, const InvariantValue& right);
+InvariantValue operator*(const InvariantValue& left, const InvariantValue& right);
+InvariantValue operator/(const InvariantValue& left, const InvariantValue& right);
+InvariantValue operator-(const InvariantValue& value);
+
+/**
+ * Value of the expression in terms of the loop counter: `coefficient * i + offset`.
+ */
+struct AffineForm {
+    InvariantValue coefficient;
+    InvariantValue offset;
+};
+
+/**
+ * Finds the affine form of the expression in terms of the loop counter.
+ * The expression may contain only the counter, reads of loop-invariant variables (not in variantNames),
+ * side effect free calls that don't depend on the counter, and arithmetic operators, where multiplication and division
+ * keep the expression affine.
+ * @return false, if the expression is not an affine function of the counter.
+ */
+bool findAffineForm(
+    const std::shared_ptr<ASTNode>& expression,
+    const LoopCounter& counter,
+    const std::vector<const char*>& variantNames,
+    AffineForm& form
+);
+
+/**
+ * Variable, that is changed by the affine function of the counter on each iteration: `s = s + f(i)` or `s = s - f(i)`.
+ */
+struct Accumulator {
+    const char* name;
+    AffineForm increment;  // Value added to the accumulator (negated for `s = s - f(i)`)
+    size_t index;          // Index of the assignment in the statements of the loop body
+};
+
+/**
+ * Checks if the statement of the loop body updates the accumulator, that is not used by the rest of the loop.
+ * @param loop       while loop, which body contains the statement
+ * @param index      index of the statement in the statements of the loop body
+ */
+bool findAccumulator(const std::shared_ptr<ASTNode>& loop, size_t index, const LoopCounter& counter, Accumulator& accumulator);
+
+#endif // COMPILER_SCALAR_EVOLUTION_H
@@ -0,0 +1,216 @@
+/**
+ * @file
+ * @brief Implementation of tail call eliminator
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "tail-call-eliminator.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+static inline bool isSelfTailCall(const std::shared_ptr<ASTNode>& statement, const FunctionDefinitionNode* function) {
+    if (statement->getType() != RETURN_STATEMENT_NODE) return false;
+
+    const auto& returnedExpression = statement->getChildren()[0];
+    if (returnedExpression->getType() != FUNCTION_CALL_NODE) return false;
+
+    const auto call = dynamic_cast<FunctionCallNode*>(returnedExpression.get());
+    return strcmp(call->getFunctionName()->getName(), function->getFunctionName()->getName()) == 0 &&
+           call->getChildren()[0]->getChildrenNumber() == function->getChildren()[0]->getChildrenNumber();
+}
+
+/**
+ * Checks if there is a self tail call in the statement, that is not inside of the while loop.
+ */
+static bool containsSelfTailCall(const std::shared_ptr<ASTNode>& statement, const FunctionDefinitionNode* function) {
+    if (isSelfTailCall(statement, function)) return true;
+    if (statement->getType() == WHILE_NODE) return false;
+
+    const size_t childrenNumber = statement->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (containsSelfTailCall(statement->getChildren()[i], function)) return true;
+    }
+    return false;
+}
+
+static bool readsIdentifier(const std::shared_ptr<ASTNode>& node, const char* name) {
+    if (node->getType() == VALUE_NODE && strcmp(getIdentifierName(node.get()), name) == 0) return true;
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (readsIdentifier(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+/**
+ * Builds block, that assigns arguments of the tail call to the parameters.
+ * Argument is assigned directly, if it has no side effects and its parameter is not read by other arguments, that are
+ * not assigned yet (so `acc = acc * n; n = n - 1;` needs no temporary variables).
+ * Otherwise argument is saved to the temporary variable first (in the order of evaluation: from right to left).
+ */
+static std::shared_ptr<ASTNode> makeParametersReassignment(const std::shared_ptr<ASTNode>& tailCall, const FunctionDefinitionNode* function) {
+    const auto& parameters = function->getChildren()[0];
+    const auto& arguments = tailCall->getChildren()[0]->getChildren()[0];
+    const size_t parametersNumber = parameters->getChildrenNumber();
+
+    // Parameters are pending, until they are assigned
+    std::vector<bool> isPending(parametersNumber);
+    for (size_t i = 0; i < parametersNumber; ++i) {
+        const auto& argument = arguments->getChildren()[i];
+        const char* parameterName = getIdentifierName(parameters->getChildren()[i].get());
+        isPending[i] = argument->getType() != VALUE_NODE || strcmp(getIdentifierName(argument.get()), parameterName) != 0;
+    }
+
+    // Direct assignments can read only parameters, that are saved to the temporary variables, so they go first
+    std::vector<std::shared_ptr<ASTNode>> directAssignments;
+    bool hasChanges = true;
+    while (hasChanges) {
+        hasChanges = false;
+        for (size_t i = parametersNumber; i > 0; --i) {
+            const auto& argument = arguments->getChildren()[i - 1];
+            if (!isPending[i - 1] || !isSideEffectFree(argument)) continue;
+
+            const char* parameterName = getIdentifierName(parameters->getChildren()[i - 1].get());
+            bool isReadByOtherArguments = false;
+            for (size_t j = 0; j < parametersNumber; ++j) {
+                if (j != i - 1 && isPending[j] && readsIdentifier(arguments->getChildren()[j], parameterName)) isReadByOtherArguments = true;
+            }
+            if (isReadByOtherArguments) continue;
+
+            directAssignments.push_back(makeAssignmentNode(parameterName, argument));
+            isPending[i - 1] = false;
+            hasChanges = true;
+        }
+    }
+
+    std::vector<std::shared_ptr<ASTNode>> temporaryDeclarations;
+    std::vector<std::shared_ptr<ASTNode>> temporaryAssignments;
+    for (size_t i = parametersNumber; i > 0; --i) {
+        if (!isPending[i - 1]) continue;
+
+        const auto& argument = arguments->getChildren()[i - 1];
+        const char* parameterName = getIdentifierName(parameters->getChildren()[i - 1].get());
+        char temporaryName[MAX_ID_LENGTH + 1];
+        generateUniqueName(temporaryName, parameterName);
+        temporaryDeclarations.push_back(makeVariableDeclarationNode(argument->getOriginPos(), temporaryName, argument));
+        temporaryAssignments.push_back(makeAssignmentNode(parameterName, std::make_shared<ValueNode>(argument->getOriginPos(), temporaryName)));
+    }
+
+    temporaryDeclarations.insert(temporaryDeclarations.end(), directAssignments.begin(), directAssignments.end());
+    temporaryDeclarations.insert(temporaryDeclarations.end(), temporaryAssignments.begin(), temporaryAssignments.end());
+    return makeBlockNode(tailCall->getOriginPos(), temporaryDeclarations);
+}
+
+static bool declaresIdentifier(const std::shared_ptr<ASTNode>& node, const char* name) {
+    if (node->getType() == VARIABLE_DECLARATION_NODE || node->getType() == VALUE_DECLARATION_NODE) {
+        if (strcmp(getIdentifierName(node->getChildren()[0].get()), name) == 0) return true;
+    }
+
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (declaresIdentifier(node->getChildren()[i], name)) return true;
+    }
+    return false;
+}
+
+static inline std::vector<std::shared_ptr<ASTNode>> getStatements(const std::shared_ptr<ASTNode>& block) {
+    const auto& statements = block->getChildren()[0];
+    return std::vector<std::shared_ptr<ASTNode>>(statements->getChildren(), statements->getChildren() + statements->getChildrenNumber());
+}
+
+/**
+ * Replaces self tail calls in the statements with reassignments of the parameters.
+ * Statements, that follow the branch with a tail call, are moved into the other branch.
+ * @return false, if tail calls can't be replaced.
+ */
+static bool rewriteTailCalls(std::vector<std::shared_ptr<ASTNode>>& statements, const FunctionDefinitionNode* function) {
+    std::vector<std::shared_ptr<ASTNode>> rewrittenStatements;
+    for (size_t i = 0; i < statements.size(); ++i) {
+        const auto& statement = statements[i];
+        if (!containsSelfTailCall(statement, function)) {
+            rewrittenStatements.push_back(statement);
+            continue;
+        }
+
+        std::vector<std::shared_ptr<ASTNode>> restStatements(statements.begin() + i + 1, statements.end());
+        switch (statement->getType()) {
+            case RETURN_STATEMENT_NODE:
+                rewrittenStatements.push_back(makeParametersReassignment(statement, function));
+                break;
+            case BLOCK_NODE: {
+                if (!alwaysReturns(statement)) return false;
+
+                auto blockStatements = getStatements(statement);
+                if (!rewriteTailCalls(blockStatements, function)) return false;
+                rewrittenStatements.push_back(makeBlockNode(statement->getOriginPos(), blockStatements));
+                break;
+            }
+            case IF_NODE:
+            case IF_ELSE_NODE: {
+                std::shared_ptr<ASTNode> branches[2];
+                for (size_t j = 0; j < 2; ++j) {
+                    std::vector<std::shared_ptr<ASTNode>> branchStatements;
+                    if (j + 1 < statement->getChildrenNumber()) {
+                        const auto& branch = statement->getChildren()[j + 1];
+                        branchStatements.push_back(branch);
+                        if (!alwaysReturns(branch)) {
+                            if (containsSelfTailCall(branch, function)) return false;
+                            branchStatements.insert(branchStatements.end(), restStatements.begin(), restStatements.end());
+                        }
+                    } else {
+                        branchStatements = restStatements;
+                    }
+                    if (!rewriteTailCalls(branchStatements, function)) return false;
+                    branches[j] = makeBlockNode(statement->getOriginPos(), branchStatements);
+                }
+
+                rewrittenStatements.push_back(std::make_shared<IfElseNode>(
+                    statement->getOriginPos(),
+                    std::dynamic_pointer_cast<ComparisonOperatorNode>(statement->getChildren()[0]),
+                    branches[0],
+                    branches[1]
+                ));
+                break;
+            }
+            default:
+                return false;
+        }
+        statements = rewrittenStatements;
+        return true;
+    }
+    return true;
+}
+
+std::shared_ptr<ASTNode>& TailCallEliminator::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != FUNCTION_DEFINITION_NODE) return node;
+
+    const auto function = dynamic_cast<FunctionDefinitionNode*>(node.get());
+    auto& body = node->getChildren()[1];
+    if (!containsSelfTailCall(body, function)) return node;
+
+    // Parameters, shadowed in the nested blocks, can't be reassigned there
+    const auto& parameters = node->getChildren()[0];
+    for (size_t i = 0; i < parameters->getChildrenNumber(); ++i) {
+        if (declaresIdentifier(body, getIdentifierName(parameters->getChildren()[i].get()))) return node;
+    }
+
+    const TokenOrigin originPos = body->getOriginPos();
+    auto statements = getStatements(body);
+    if (!alwaysReturns(body)) {
+        // Implicit 'return 0' should be explicit, otherwise loop will be continued instead of returning
+        statements.push_back(std::make_shared<ReturnStatementNode>(originPos, std::make_shared<ConstantValueNode>(originPos, 0)));
+    }
+    if (!rewriteTailCalls(statements, function)) return node;
+
+    auto endlessCondition = std::make_shared<ComparisonOperatorNode>(
+        std::make_shared<LessComparisonOperator>(originPos),
+        std::make_shared<ConstantValueNode>(originPos, 0),
+        std::make_shared<ConstantValueNode>(originPos, 1)
+    );
+    auto loop = std::make_shared<WhileNode>(originPos, endlessCondition, makeBlockNode(originPos, statements));
+    body = makeBlockNode(originPos, { loop });
+    return node;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @brief Definition of tail call eliminator
+ */
+#ifndef COMPILER_TAIL_CALL_ELIMINATOR_H
+#define COMPILER_TAIL_CALL_ELIMINATOR_H
+
+#include <memory>
+#include "ast-optimizers.h"
+#include "../frontend/ast.h"
+
+/**
+ * Replaces self tail calls (`return f(...)` inside of the function 'f') with reassignment of the parameters and a jump
+ * to the beginning of the function. Function body is wrapped into the endless loop, so the jump is just the end of the iteration:
+ *
+ *     func fact(n, acc) {                 --->      func fact(n, acc) {
+ *         if (n <= 1) return acc;                       while (0 < 1) {
+ *         return fact(n - 1, acc * n);                      if (n <= 1) {
+ *     }                                                         return acc;
+ *                                                           } else {
+ *                                                               var n.1 = n - 1;
+ *                                                               acc = acc * n;
+ *                                                               n = n.1;
+ *                                                           }
+ *                                                       }
+ *                                                   }
+ *
+ * Statements after the conditional tail calls are moved into the 'else' branches, so they are not executed after the reassignment.
+ * Arguments, that are needed to compute other arguments, are saved into the temporary variables first.
+ * Tail calls inside of the nested while loops are left as is.
+ */
+class TailCallEliminator : public Optimizer {
+
+public:
+    TailCallEliminator() : Optimizer(false) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_TAIL_CALL_ELIMINATOR_H
@@ -0,0 +1,539 @@
+/**
+ * @file
+ * @brief Implementation of value range analysis of the local variables
+ */
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "ast-utils.h"
+#include "value-range-analysis.h"
+#include "../frontend/ast.h"
+#include "../util/constants.h"
+
+static constexpr size_t MAX_BOUND_SEARCH_STEPS = 16;
+
+ValueRange ValueRange::makeUnknown() {
+    return { -INFINITY, INFINITY, true, { } };
+}
+
+ValueRange ValueRange::makeConstant(double value) {
+    return { value, value, false, { } };
+}
+
+bool ValueRange::isConstant(double& value) const {
+    if (mayBeNaN || min < max || min > max) return false;
+    value = min;
+    return true;
+}
+
+static inline bool isPositiveInfinity(double value) {
+    return std::isinf(value) && value > 0;
+}
+
+static inline bool isNegativeInfinity(double value) {
+    return std::isinf(value) && value < 0;
+}
+
+static inline bool containsZero(const ValueRange& range) {
+    return range.min <= 0 && range.max >= 0;
+}
+
+static inline bool containsInfinity(const ValueRange& range) {
+    return std::isinf(range.min) || std::isinf(range.max);
+}
+
+static inline void removeNumbers(ValueRange& range) {
+    range.min = INFINITY;
+    range.max = -INFINITY;
+    range.excludedValues.clear();
+}
+
+static inline bool isSameValue(double first, double second) {
+    return !(first < second || first > second);
+}
+
+static bool isSameRange(const ValueRange& first, const ValueRange& second) {
+    if (first.mayBeNaN != second.mayBeNaN || first.hasNumbers() != second.hasNumbers()) return false;
+    if (!first.hasNumbers()) return true;
+    return isSameValue(first.min, second.min) && isSameValue(first.max, second.max) &&
+           first.excludedValues.size() == second.excludedValues.size() &&
+           std::equal(first.excludedValues.begin(), first.excludedValues.end(), second.excludedValues.begin(), isSameValue);
+}
+
+static inline ComparisonOperatorType swapOperands(ComparisonOperatorType operatorType) {
+    switch (operatorType) {
+        case LESS:             return GREATER;
+        case LESS_OR_EQUAL:    return GREATER_OR_EQUAL;
+        case GREATER:          return LESS;
+        case GREATER_OR_EQUAL: return LESS_OR_EQUAL;
+        default:               return operatorType;
+    }
+}
+
+/**
+ * Finds possible results of the jump by the comparison of the numbers from the given ranges (see isJumpTaken).
+ *
+ * Ordering jumps compare the numbers exactly, so only the bounds are compared. `JMPE` and `JMPNE` compare the difference
+ * `left - right` with COMPARE_EPS. Rounding is monotonic, so differences of all pairs of numbers are between
+ * the differences of the opposite bounds of the ranges.
+ * @return outcome, which is true, if the jump is taken
+ */
+static ConditionOutcome compareRangesByJump(ComparisonOperatorType operatorType, const ValueRange& left, const ValueRange& right) {
+    ConditionOutcome outcome = { false, false };
+    bool canBeNaN = left.mayBeNaN || right.mayBeNaN;
+    if (left.hasNumbers() && right.hasNumbers()) {
+        // Difference of the equal infinities is NaN
+        const bool differenceCanBeNaN = (isPositiveInfinity(left.max) && isPositiveInfinity(right.max)) ||
+                                        (isNegativeInfinity(left.min) && isNegativeInfinity(right.min));
+        double minDifference = left.min - right.max;
+        double maxDifference = left.max - right.min;
+        if (std::isnan(minDifference)) minDifference = -INFINITY;
+        if (std::isnan(maxDifference)) maxDifference = INFINITY;
+
+        const bool canBeFar = maxDifference >= COMPARE_EPS || minDifference <= -COMPARE_EPS;
+        bool canBeClose = minDifference < COMPARE_EPS && maxDifference > -COMPARE_EPS;
+        double constant = 0;
+        if ((left.isConstant(constant) && right.excludedValues.count(constant) != 0) ||
+            (right.isConstant(constant) && left.excludedValues.count(constant) != 0)) canBeClose = false;
+
+        switch (operatorType) {
+            case LESS:             outcome = { left.min < right.max, left.max >= right.min };  break;
+            case LESS_OR_EQUAL:    outcome = { left.min <= right.max, left.max > right.min };  break;
+            case GREATER:          outcome = { left.max > right.min, left.min <= right.max };  break;
+            case GREATER_OR_EQUAL: outcome = { left.max >= right.min, left.min < right.max };  break;
+            case EQUAL:            outcome = { canBeClose, canBeFar };                         break;
+            case NOT_EQUAL:        outcome = { canBeFar, canBeClose };                         break;
+            default:               assert(!"Unknown comparison operator");
+        }
+        if (differenceCanBeNaN && (operatorType == EQUAL || operatorType == NOT_EQUAL)) outcome.canBeFalse = true;
+    }
+
+    // No jump is taken for NaN
+    if (canBeNaN) outcome.canBeFalse = true;
+    return outcome;
+}
+
+/**
+ * Finds possible results of the condition with the numbers from the given ranges. Condition is true, if the jump by
+ * the negated comparison over the body isn't taken (see evaluateComparison).
+ */
+static ConditionOutcome compareRanges(ComparisonOperatorType operatorType, const ValueRange& left, const ValueRange& right) {
+    const ConditionOutcome jumpOutcome = compareRangesByJump(negateComparison(operatorType), left, right);
+    return { jumpOutcome.canBeFalse, jumpOutcome.canBeTrue };
+}
+
+/**
+ * Checks if some numbers of the range can be equal to the value in the stack machine comparison.
+ */
+static bool hasNumbersEqualTo(const ValueRange& range, double value) {
+    ValueRange numbers = range;
+    numbers.mayBeNaN = false;
+    return compareRanges(EQUAL, numbers, ValueRange::makeConstant(value)).canBeTrue;
+}
+
+/**
+ * Removes excluded values, that are not in the range anyway, and numbers, if all of them are excluded.
+ */
+static void normalize(ValueRange& range) {
+    if (!range.hasNumbers()) {
+        removeNumbers(range);
+        return;
+    }
+
+    ValueRange interval = { range.min, range.max, false, { } };
+    const std::vector<double> excludedValues(range.excludedValues.begin(), range.excludedValues.end());
+    for (double value : excludedValues) {
+        const ConditionOutcome outcome = compareRanges(EQUAL, interval, ValueRange::makeConstant(value));
+        if (!outcome.canBeFalse) {
+            removeNumbers(range);
+            return;
+        }
+        if (!outcome.canBeTrue) range.excludedValues.erase(value);
+    }
+}
+
+static ValueRange join(const ValueRange& first, const ValueRange& second) {
+    const bool mayBeNaN = first.mayBeNaN || second.mayBeNaN;
+    if (!first.hasNumbers() || !second.hasNumbers()) {
+        ValueRange result = first.hasNumbers() ? first : second;
+        result.mayBeNaN = mayBeNaN;
+        return result;
+    }
+
+    ValueRange result = { std::min(first.min, second.min), std::max(first.max, second.max), mayBeNaN, { } };
+    for (double value : first.excludedValues) {
+        if (!hasNumbersEqualTo(second, value)) result.excludedValues.insert(value);
+    }
+    for (double value : second.excludedValues) {
+        if (!hasNumbersEqualTo(first, value)) result.excludedValues.insert(value);
+    }
+    normalize(result);
+    return result;
+}
+
+/**
+ * Widens bounds of the previous range, that were extended by the next one, to the infinities.
+ * @param next range, that includes the previous one
+ */
+static ValueRange widen(const ValueRange& previous, const ValueRange& next) {
+    ValueRange result = next;
+    if (!next.hasNumbers()) return result;
+    if (!previous.hasNumbers() || next.min < previous.min) result.min = -INFINITY;
+    if (!previous.hasNumbers() || next.max > previous.max) result.max = INFINITY;
+    normalize(result);
+    return result;
+}
+
+static ValueRange negate(const ValueRange& range) {
+    ValueRange result = { -range.max, -range.min, range.mayBeNaN, { } };
+    for (double value : range.excludedValues) result.excludedValues.insert(-value);
+    return result;
+}
+
+static ValueRange add(const ValueRange& left, const ValueRange& right) {
+    ValueRange result = { INFINITY, -INFINITY, left.mayBeNaN || right.mayBeNaN, { } };
+    if (!left.hasNumbers() || !right.hasNumbers()) return result;
+
+    // Sum of the opposite infinities is NaN
+    if ((isPositiveInfinity(left.max) && isNegativeInfinity(right.min)) ||
+        (isNegativeInfinity(left.min) && isPositiveInfinity(right.max))) result.mayBeNaN = true;
+    result.min = left.min + right.min;
+    result.max = left.max + right.max;
+    if (std::isnan(result.min)) result.min = -INFINITY;
+    if (std::isnan(result.max)) result.max = INFINITY;
+    return result;
+}
+
+/**
+ * Computes range of the operation, that is monotonic in each operand, when the signs of the operands are fixed
+ * (like multiplication), by its results on the bounds. NaN results of the bounds must be taken into account by the caller.
+ * NaN result on the bounds (like `0 * inf`) can hide zero results on the nearby numbers (like `0 * 1`), so zero is added.
+ */
+template <typename Operation>
+static ValueRange applyToBounds(const ValueRange& left, const ValueRange& right, bool mayBeNaN, Operation operation) {
+    ValueRange result = { INFINITY, -INFINITY, mayBeNaN || left.mayBeNaN || right.mayBeNaN, { } };
+    if (!left.hasNumbers() || !right.hasNumbers()) return result;
+
+    for (double leftBound : { left.min, left.max }) {
+        for (double rightBound : { right.min, right.max }) {
+            double value = operation(leftBound, rightBound);
+            if (std::isnan(value)) value = 0;
+            result.min = std::min(result.min, value);
+            result.max = std::max(result.max, value);
+        }
+    }
+    return result;
+}
+
+static ValueRange multiply(const ValueRange& left, const ValueRange& right) {
+    // Zero multiplied by infinity is NaN
+    const bool mayBeNaN = (containsZero(left) && containsInfinity(right)) || (containsInfinity(left) && containsZero(right));
+    return applyToBounds(left, right, mayBeNaN, [](double first, double second) { return first * second; });
+}
+
+static ValueRange divide(const ValueRange& left, const ValueRange& right) {
+    if (!right.hasNumbers() || containsZero(right)) return ValueRange::makeUnknown();
+
+    // Infinity divided by infinity is NaN
+    const bool mayBeNaN = containsInfinity(left) && containsInfinity(right);
+    return applyToBounds(left, right, mayBeNaN, [](double first, double second) { return first / second; });
+}
+
+/**
+ * Finds the greatest number x, for which `x - bound` is less than COMPARE_EPS.
+ * All smaller numbers satisfy this condition too, because rounding is monotonic.
+ * @return false, if the number isn't found in a few steps (e.g. the bound is infinite).
+ */
+static bool findCloseUpperBound(double bound, double& result) {
+    if (!std::isfinite(bound)) return false;
+
+    const auto isSatisfied = [bound](double x) { return x - bound < COMPARE_EPS; };
+    double x = bound + COMPARE_EPS;
+    for (size_t i = 0; i < MAX_BOUND_SEARCH_STEPS && !isSatisfied(x); ++i) x = nextafter(x, -INFINITY);
+    if (!isSatisfied(x)) return false;
+
+    for (size_t i = 0; isSatisfied(nextafter(x, INFINITY)); ++i) {
+        if (i == MAX_BOUND_SEARCH_STEPS) return false;
+        x = nextafter(x, INFINITY);
+    }
+    result = x;
+    return true;
+}
+
+/**
+ * Narrows numbers of the range to the ones, that satisfy comparison with some number of the other range
+ * (exactly for the ordering comparisons and with COMPARE_EPS precision for EQUAL and NOT_EQUAL, see isJumpTaken).
+ */
+static void narrow(ValueRange& range, ComparisonOperatorType operatorType, const ValueRange& other) {
+    double bound = 0;
+    switch (operatorType) {
+        case LESS:
+            if (isNegativeInfinity(other.max)) {
+                removeNumbers(range);
+            } else {
+                range.max = std::min(range.max, nextafter(other.max, -INFINITY));
+            }
+            break;
+        case LESS_OR_EQUAL:
+            range.max = std::min(range.max, other.max);
+            break;
+        case GREATER:
+            if (isPositiveInfinity(other.min)) {
+                removeNumbers(range);
+            } else {
+                range.min = std::max(range.min, nextafter(other.min, INFINITY));
+            }
+            break;
+        case GREATER_OR_EQUAL:
+            range.min = std::max(range.min, other.min);
+            break;
+        case EQUAL:
+            if (findCloseUpperBound(other.max, bound)) range.max = std::min(range.max, bound);
+            // `bound - x` is the same as `-x - -bound`, so the lower bound is the negated upper bound for the negated numbers
+            if (findCloseUpperBound(-other.min, bound)) range.min = std::max(range.min, -bound);
+            break;
+        case NOT_EQUAL:
+            // Difference with the same infinity is NaN, so infinities are never excluded
+            if (other.isConstant(bound) && std::isfinite(bound)) range.excludedValues.insert(bound);
+            break;
+        default:
+            assert(!"Unknown comparison operator");
+    }
+}
+
+static ValueRange& getRange(std::map<std::string, ValueRange>& ranges, const char* name) {
+    auto range = ranges.find(name);
+    if (range == ranges.end()) range = ranges.insert({ name, ValueRange::makeUnknown() }).first;
+    return range->second;
+}
+
+ValueRange ValueRangeAnalysis::evaluate(const std::shared_ptr<ASTNode>& expression, const State& state) const {
+    switch (expression->getType()) {
+        case CONSTANT_VALUE_NODE:
+            return ValueRange::makeConstant(dynamic_cast<ConstantValueNode*>(expression.get())->getValue());
+        case VALUE_NODE: {
+            const auto range = state.ranges.find(getIdentifierName(expression.get()));
+            return (range != state.ranges.end()) ? range->second : ValueRange::makeUnknown();
+        }
+        case OPERATOR_NODE: {
+            const auto operatorType = dynamic_cast<OperatorNode*>(expression.get())->getToken()->getOperatorType();
+            const ValueRange left = evaluate(expression->getChildren()[0], state);
+            if (expression->getChildrenNumber() == 1) return (operatorType == ARITHMETIC_NEGATION) ? negate(left) : left;
+
+            const ValueRange right = evaluate(expression->getChildren()[1], state);
+            switch (operatorType) {
+                case ADDITION:       return add(left, right);
+                case SUBTRACTION:    return add(left, negate(right));
+                case MULTIPLICATION: return multiply(left, right);
+                case DIVISION:       return divide(left, right);
+                default:             return ValueRange::makeUnknown();
+            }
+        }
+        case COMPARISON_OPERATOR_NODE:
+            return { 0, 1, false, { } };
+        default:
+            return ValueRange::makeUnknown();
+    }
+}
+
+ConditionOutcome ValueRangeAnalysis::evaluateCondition(const std::shared_ptr<ASTNode>& condition, const State& state) const {
+    if (condition->getType() != COMPARISON_OPERATOR_NODE) return { true, true };
+
+    const auto operatorType = dynamic_cast<ComparisonOperatorNode*>(condition.get())->getToken()->getOperatorType();
+    return compareRanges(operatorType, evaluate(condition->getChildren()[0], state), evaluate(condition->getChildren()[1], state));
+}
+
+/**
+ * Narrows ranges of the variables, that are compared in the condition, to the values, for which the condition has
+ * the given result. State becomes unreachable, if the condition never has this result.
+ */
+void ValueRangeAnalysis::refine(const std::shared_ptr<ASTNode>& condition, bool isTrue, State& state) const {
+    if (!state.isReachable) return;
+
+    const ConditionOutcome outcome = evaluateCondition(condition, state);
+    if (isTrue ? !outcome.canBeTrue : !outcome.canBeFalse) {
+        state.isReachable = false;
+        return;
+    }
+    if (condition->getType() != COMPARISON_OPERATOR_NODE) return;
+
+    const auto operatorType = dynamic_cast<ComparisonOperatorNode*>(condition.get())->getToken()->getOperatorType();
+    const std::shared_ptr<ASTNode> operands[2] = { condition->getChildren()[0], condition->getChildren()[1] };
+    const ValueRange operandRanges[2] = { evaluate(operands[0], state), evaluate(operands[1], state) };
+    for (size_t i = 0; i < 2; ++i) {
+        if (operands[i]->getType() != VALUE_NODE) continue;
+
+        const ComparisonOperatorType variableOperatorType = (i == 0) ? operatorType : swapOperands(operatorType);
+        const ValueRange& other = operandRanges[1 - i];
+        // Condition is true, if the negated jump isn't taken, and no jump is taken for NaN. So nothing is known
+        // in the true branch, if the other operand can be NaN, while the false branch excludes NaN
+        if (isTrue && other.mayBeNaN) continue;
+
+        ValueRange& range = getRange(state.ranges, getIdentifierName(operands[i].get()));
+        if (!isTrue) range.mayBeNaN = false;
+        narrow(range, isTrue ? variableOperatorType : negateComparison(variableOperatorType), other);
+        normalize(range);
+        if (!range.hasNumbers() && !range.mayBeNaN) state.isReachable = false;
+    }
+}
+
+void ValueRangeAnalysis::recordCondition(const ASTNode* statement, const ConditionOutcome& outcome) {
+    auto recordedOutcome = conditionOutcomes.find(statement);
+    if (recordedOutcome == conditionOutcomes.end()) {
+        conditionOutcomes.insert({ statement, outcome });
+        return;
+    }
+    recordedOutcome->second.canBeTrue = recordedOutcome->second.canBeTrue || outcome.canBeTrue;
+    recordedOutcome->second.canBeFalse = recordedOutcome->second.canBeFalse || outcome.canBeFalse;
+}
+
+ValueRangeAnalysis::State ValueRangeAnalysis::join(const State& first, const State& second) {
+    if (!first.isReachable) return second;
+    if (!second.isReachable) return first;
+
+    State result = { true, { } };
+    for (const auto& range : first.ranges) {
+        const auto otherRange = second.ranges.find(range.first);
+        if (otherRange != second.ranges.end()) result.ranges.insert({ range.first, ::join(range.second, otherRange->second) });
+    }
+    return result;
+}
+
+ValueRangeAnalysis::State ValueRangeAnalysis::widen(const State& previous, const State& next) {
+    State result = next;
+    for (auto& range : result.ranges) {
+        const auto previousRange = previous.ranges.find(range.first);
+        if (previousRange != previous.ranges.end()) range.second = ::widen(previousRange->second, range.second);
+    }
+    return result;
+}
+
+bool ValueRangeAnalysis::isSameState(const State& first, const State& second) {
+    if (first.isReachable != second.isReachable || first.ranges.size() != second.ranges.size()) return false;
+
+    for (const auto& range : first.ranges) {
+        const auto otherRange = second.ranges.find(range.first);
+        if (otherRange == second.ranges.end() || !isSameRange(range.second, otherRange->second)) return false;
+    }
+    return true;
+}
+
+void ValueRangeAnalysis::analyzeLoop(const std::shared_ptr<ASTNode>& loop, State& state) {
+    auto entryState = loopEntryStates.find(loop.get());
+    if (entryState == loopEntryStates.end()) {
+        loopEntryStates.insert({ loop.get(), state });
+    } else {
+        entryState->second = join(entryState->second, state);
+    }
+
+    // Ranges only grow and growing bounds are widened to infinities, so the fixed point is reached in a few iterations
+    const auto& condition = loop->getChildren()[0];
+    State headState = state;
+    while (true) {
+        recordCondition(loop.get(), evaluateCondition(condition, headState));
+        State bodyState = headState;
+        refine(condition, true, bodyState);
+        analyzeStatement(loop->getChildren()[1], bodyState);
+
+        const State nextHeadState = join(headState, bodyState);
+        if (isSameState(nextHeadState, headState)) break;
+        headState = widen(headState, nextHeadState);
+    }
+
+    state = headState;
+    refine(condition, false, state);
+}
+
+void ValueRangeAnalysis::analyzeStatement(const std::shared_ptr<ASTNode>& statement, State& state) {
+    if (!state.isReachable) return;
+
+    const auto children = statement->getChildren();
+    switch (statement->getType()) {
+        case VARIABLE_DECLARATION_NODE:
+        case VALUE_DECLARATION_NODE:
+            // Variable without initial value is zero
+            state.ranges[getIdentifierName(children[0].get())] =
+                (statement->getChildrenNumber() == 2) ? evaluate(children[1], state) : ValueRange::makeConstant(0);
+            return;
+        case ASSIGNMENT_OPERATOR_NODE:
+            state.ranges[getIdentifierName(children[0].get())] = evaluate(children[1], state);
+            return;
+        case RETURN_STATEMENT_NODE:
+            state.isReachable = false;
+            return;
+        case IF_NODE:
+        case IF_ELSE_NODE: {
+            recordCondition(statement.get(), evaluateCondition(children[0], state));
+            State thenState = state;
+            refine(children[0], true, thenState);
+            analyzeStatement(children[1], thenState);
+            refine(children[0], false, state);
+            if (statement->getType() == IF_ELSE_NODE) analyzeStatement(children[2], state);
+            state = join(thenState, state);
+            return;
+        }
+        case WHILE_NODE:
+            analyzeLoop(statement, state);
+            return;
+        case BLOCK_NODE: {
+            // Variables declared in the block shadow the outer ones, so ranges of the outer variables are restored after it
+            Ranges shadowedRanges;
+            const auto& statements = children[0];
+            for (size_t i = 0; i < statements->getChildrenNumber() && state.isReachable; ++i) {
+                const auto& nested = statements->getChildren()[i];
+                if (nested->getType() == VARIABLE_DECLARATION_NODE || nested->getType() == VALUE_DECLARATION_NODE) {
+                    const char* name = getIdentifierName(nested->getChildren()[0].get());
+                    const auto shadowedRange = state.ranges.find(name);
+                    if (shadowedRanges.count(name) == 0) {
+                        shadowedRanges.insert({ name, (shadowedRange != state.ranges.end()) ? shadowedRange->second : ValueRange::makeUnknown() });
+                    }
+                }
+                analyzeStatement(nested, state);
+            }
+            for (const auto& range : shadowedRanges) {
+                state.ranges[range.first] = range.second;
+            }
+            return;
+        }
+        case STATEMENTS_NODE:
+            for (size_t i = 0; i < statement->getChildrenNumber(); ++i) {
+                analyzeStatement(children[i], state);
+            }
+            return;
+        default:
+            // Expressions can't change local variables, functions have no access to them
+            return;
+    }
+}
+
+ValueRangeAnalysis::ValueRangeAnalysis(const std::shared_ptr<ASTNode>& function) {
+    assert(function != nullptr && function->getType() == FUNCTION_DEFINITION_NODE);
+
+    // Parameters can take any value
+    State state = { true, { } };
+    analyzeStatement(function->getChildren()[1], state);
+}
+
+ConditionOutcome ValueRangeAnalysis::getConditionOutcome(const ASTNode* statement) const {
+    const auto outcome = conditionOutcomes.find(statement);
+    return (outcome != conditionOutcomes.end()) ? outcome->second : ConditionOutcome { true, true };
+}
+
+ValueRange ValueRangeAnalysis::getRangeBeforeLoop(const ASTNode* loop, const std::shared_ptr<ASTNode>& expression) const {
+    const auto state = loopEntryStates.find(loop);
+    return (state != loopEntryStates.end()) ? evaluate(expression, state->second) : ValueRange::makeUnknown();
+}
+
+ValueRange ValueRangeAnalysis::getRangeBeforeLoop(const ASTNode* loop, const char* name) const {
+    const auto state = loopEntryStates.find(loop);
+    if (state == loopEntryStates.end()) return ValueRange::makeUnknown();
+
+    const auto range = state->second.ranges.find(name);
+    return (range != state->second.ranges.end()) ? range->second : ValueRange::makeUnknown();
+}
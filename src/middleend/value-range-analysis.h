@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @brief Definition of value range analysis of the local variables
+ */
+#ifndef COMPILER_VALUE_RANGE_ANALYSIS_H
+#define COMPILER_VALUE_RANGE_ANALYSIS_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include "../frontend/ast.h"
+
+/**
+ * Set of values, that the expression can take: numbers in [min, max] (bounds are included), except the numbers, that are
+ * equal to any of excludedValues (in terms of the stack machine comparison, see evaluateComparison), and possibly NaN.
+ * Range without numbers has min > max.
+ */
+struct ValueRange {
+    double min;
+    double max;
+    bool mayBeNaN;
+    std::set<double> excludedValues;
+
+    /** Returns range of any value, including infinities and NaN */
+    static ValueRange makeUnknown();
+    static ValueRange makeConstant(double value);
+
+    inline bool hasNumbers() const {
+        return !(min > max);
+    }
+
+    /**
+     * Checks if the range consists of the only number.
+     * @param value the number
+     */
+    bool isConstant(double& value) const;
+};
+
+/**
+ * Possible results of the condition over all its evaluations.
+ */
+struct ConditionOutcome {
+    bool canBeTrue;
+    bool canBeFalse;
+
+    inline bool isAlwaysTrue() const {
+        return canBeTrue && !canBeFalse;
+    }
+
+    inline bool isAlwaysFalse() const {
+        return !canBeTrue && canBeFalse;
+    }
+};
+
+/**
+ * Computes ranges of the local variables of the function and outcomes of the 'if' and 'while' conditions.
+ *
+ * Ranges are propagated forward over the function body. Assignments and declarations compute ranges of the assigned
+ * expressions (sums, differences, products and quotients of ranges are computed exactly like in the stack machine,
+ * results of the function calls and parameters are unknown). Comparisons of variables in conditions narrow their ranges
+ * in the branches:
+ *
+ *     if (n > 0) {
+ *         ...                       // n is in (0, +inf] or NaN (any condition with NaN is true, see evaluateComparison)
+ *     } else if (n != -1) {
+ *         ...                       // n is in [-inf, 0] and isn't equal to -1
+ *     }
+ *
+ * Ranges from both branches of 'if' are merged, while loops are iterated until the fixed point, and bounds that keep
+ * growing are widened to infinities, so the analysis always terminates.
+ */
+class ValueRangeAnalysis {
+
+private:
+    typedef std::map<std::string, ValueRange> Ranges; // Variables without range can take any value
+
+    struct State {
+        bool isReachable;
+        Ranges ranges;
+    };
+
+    std::map<const ASTNode*, ConditionOutcome> conditionOutcomes;
+    std::map<const ASTNode*, State> loopEntryStates;
+
+    static State join(const State& first, const State& second);
+    /** Widens ranges of the previous state, that were extended in the next state (see ValueRangeAnalysis) */
+    static State widen(const State& previous, const State& next);
+    static bool isSameState(const State& first, const State& second);
+
+    ValueRange evaluate(const std::shared_ptr<ASTNode>& expression, const State& state) const;
+    ConditionOutcome evaluateCondition(const std::shared_ptr<ASTNode>& condition, const State& state) const;
+    void refine(const std::shared_ptr<ASTNode>& condition, bool isTrue, State& state) const;
+
+    void recordCondition(const ASTNode* statement, const ConditionOutcome& outcome);
+    void analyzeStatement(const std::shared_ptr<ASTNode>& statement, State& state);
+    void analyzeLoop(const std::shared_ptr<ASTNode>& loop, State& state);
+
+public:
+    /**
+     * Analyses the given function.
+     * @param function function definition node
+     */
+    explicit ValueRangeAnalysis(const std::shared_ptr<ASTNode>& function);
+
+    /**
+     * Returns outcome of the condition of the 'if' or 'while' statement over all its executions.
+     * Both results are possible for the statements, that were not analysed (e.g. unreachable).
+     */
+    ConditionOutcome getConditionOutcome(const ASTNode* statement) const;
+
+    /**
+     * Returns range of the expression right before the while loop (before the first evaluation of its condition).
+     * Range is unknown for the loops, that were not analysed.
+     */
+    ValueRange getRangeBeforeLoop(const ASTNode* loop, const std::shared_ptr<ASTNode>& expression) const;
+
+    /** Returns range of the variable or value right before the while loop (see the overload for expressions) */
+    ValueRange getRangeBeforeLoop(const ASTNode* loop, const char* name) const;
+};
+
+#endif // COMPILER_VALUE_RANGE_ANALYSIS_H
@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief Implementation of value range optimizer (removal of redundant conditions)
+ */
+#include <memory>
+#include <vector>
+#include "ast-utils.h"
+#include "effect-analysis.h"
+#include "value-range-analysis.h"
+#include "value-range-optimizer.h"
+#include "../frontend/ast.h"
+
+static void simplifyStatements(std::shared_ptr<ASTNode>& statements, const ValueRangeAnalysis& ranges, const EffectAnalysis& effects);
+
+/**
+ * Replaces statements with the known conditions by the executed branch.
+ * @return statement to keep or nullptr, if statement is never executed.
+ */
+static std::shared_ptr<ASTNode> simplifyStatement(
+    const std::shared_ptr<ASTNode>& statement,
+    const ValueRangeAnalysis& ranges,
+    const EffectAnalysis& effects
+) {
+    const auto children = statement->getChildren();
+    switch (statement->getType()) {
+        case BLOCK_NODE:
+            simplifyStatements(children[0], ranges, effects);
+            return statement;
+        case IF_NODE:
+        case IF_ELSE_NODE:
+        case WHILE_NODE:
+            break;
+        default:
+            return statement;
+    }
+
+    for (size_t i = 1; i < statement->getChildrenNumber(); ++i) {
+        children[i] = simplifyStatement(children[i], ranges, effects);
+        if (children[i] == nullptr) children[i] = makeBlockNode(statement->getOriginPos(), { });
+    }
+
+    if (!effects.isSideEffectFree(children[0])) return statement;
+    const ConditionOutcome outcome = ranges.getConditionOutcome(statement.get());
+    switch (statement->getType()) {
+        case IF_NODE:
+            if (outcome.isAlwaysTrue()) return children[1];
+            return outcome.isAlwaysFalse() ? nullptr : statement;
+        case IF_ELSE_NODE:
+            if (outcome.isAlwaysTrue()) return children[1];
+            return outcome.isAlwaysFalse() ? children[2] : statement;
+        default:
+            return outcome.isAlwaysFalse() ? nullptr : statement;
+    }
+}
+
+static void simplifyStatements(std::shared_ptr<ASTNode>& statements, const ValueRangeAnalysis& ranges, const EffectAnalysis& effects) {
+    bool hasChanges = false;
+    std::vector<std::shared_ptr<ASTNode>> simplifiedStatements;
+    const size_t childrenNumber = statements->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        const auto& statement = statements->getChildren()[i];
+        const auto simplifiedStatement = simplifyStatement(statement, ranges, effects);
+        if (simplifiedStatement != statement) hasChanges = true;
+        if (simplifiedStatement != nullptr) simplifiedStatements.push_back(simplifiedStatement);
+    }
+
+    if (hasChanges) statements = std::make_shared<StatementsNode>(statements->getOriginPos(), simplifiedStatements);
+}
+
+std::shared_ptr<ASTNode>& ValueRangeOptimizer::optimizeCurrent(std::shared_ptr<ASTNode>& node) const {
+    if (node->getType() != FUNCTION_DEFINITION_NODE) return node;
+
+    const ValueRangeAnalysis ranges(node);
+    simplifyStatement(node->getChildren()[1], ranges, *effects);
+    return node;
+}
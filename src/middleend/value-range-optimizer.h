@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @brief Definition of value range optimizer (removal of redundant conditions)
+ */
+#ifndef COMPILER_VALUE_RANGE_OPTIMIZER_H
+#define COMPILER_VALUE_RANGE_OPTIMIZER_H
+
+#include <memory>
+#include "effect-analysis.h"
+#include "../frontend/ast.h"
+
+/**
+ * Removes 'if' and 'while' statements, whose conditions are always true or always false according to the value ranges
+ * of the variables (see ValueRangeAnalysis), like the checks, that are already made by the enclosing statements:
+ *
+ *     if (a == 0) {                         if (a == 0) {
+ *         return 1;                             return 1;
+ *     }                             --->    }
+ *     if (a != 0) {                         {
+ *         print(1 / a);                         print(1 / a);
+ *     }                                     }
+ *
+ *     var i = 0;                            var i = 0;
+ *     while (i < n) {                       while (i < n) {
+ *         if (i >= 0) { ... }       --->        { ... }
+ *         i = i + 1;                            i = i + 1;
+ *     }                                     }
+ *
+ * 'if' statement is replaced with the executed branch, 'while' loop with always false condition is removed.
+ * Conditions with side effects (see EffectAnalysis) are kept.
+ */
+class ValueRangeOptimizer : public EffectAwareOptimizer {
+
+public:
+    ValueRangeOptimizer() : EffectAwareOptimizer(false) { }
+    std::shared_ptr<ASTNode>& optimizeCurrent(std::shared_ptr<ASTNode>& node) const override;
+};
+
+#endif // COMPILER_VALUE_RANGE_OPTIMIZER_H
@@ -0,0 +1,36 @@
+/**
+ * @file
+ * @brief Implementation of the comparison of numbers, that is done by the stack machine
+ */
+#include <cmath>
+#include <stdexcept>
+#include "comparison.h"
+#include "constants.h"
+
+bool isJumpTaken(ComparisonOperatorType operatorType, double left, double right) {
+    switch (operatorType) {
+        case LESS:             return left < right;
+        case LESS_OR_EQUAL:    return left <= right;
+        case GREATER:          return left > right;
+        case GREATER_OR_EQUAL: return left >= right;
+        case EQUAL:            return fabs(left - right) < COMPARE_EPS;
+        case NOT_EQUAL:        return fabs(left - right) >= COMPARE_EPS;
+        default:               throw std::logic_error("Unknown comparison operator");
+    }
+}
+
+bool evaluateComparison(ComparisonOperatorType operatorType, double left, double right) {
+    return !isJumpTaken(negateComparison(operatorType), left, right);
+}
+
+ComparisonOperatorType negateComparison(ComparisonOperatorType operatorType) {
+    switch (operatorType) {
+        case LESS:             return GREATER_OR_EQUAL;
+        case LESS_OR_EQUAL:    return GREATER;
+        case GREATER:          return LESS_OR_EQUAL;
+        case GREATER_OR_EQUAL: return LESS;
+        case EQUAL:            return NOT_EQUAL;
+        case NOT_EQUAL:        return EQUAL;
+        default:               throw std::logic_error("Unknown comparison operator");
+    }
+}
@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @brief Definition of the comparison of numbers, that is done by the stack machine
+ */
+#ifndef COMPILER_COMPARISON_H
+#define COMPILER_COMPARISON_H
+
+#include "../frontend/tokenizer.h"
+
+/**
+ * Checks if the conditional jump of the stack machine is taken (`JMPL` for LESS, `JMPE` for EQUAL and so on).
+ * `JMPE` and `JMPNE` compare numbers with COMPARE_EPS precision (numbers are equal, if `|left - right| < COMPARE_EPS`),
+ * other jumps compare them exactly. No jump is taken, if the operand or their difference (for `JMPE` and `JMPNE`) is NaN.
+ */
+bool isJumpTaken(ComparisonOperatorType operatorType, double left, double right);
+
+/**
+ * Evaluates condition of 'if' or 'while' the same way as the compiled program does. Body is skipped by the jump with
+ * the negated comparison, so the condition is true, if that jump isn't taken (e.g. `x < y` is `!(x >= y)`).
+ * So any condition with NaN operand is true.
+ */
+bool evaluateComparison(ComparisonOperatorType operatorType, double left, double right);
+
+/**
+ * @return comparison, that is taken as the jump, when the given one is false (e.g. GREATER_OR_EQUAL for LESS).
+ */
+ComparisonOperatorType negateComparison(ComparisonOperatorType operatorType);
+
+#endif // COMPILER_COMPARISON_H
@@ -9,5 +9,8 @@ constexpr unsigned char  VARIABLE_SIZE_IN_BYTES = 8u;
 constexpr unsigned char  MAX_INT_LENGTH = 10u;
 constexpr unsigned char  MAX_LONG_LENGTH = 19u;
 constexpr unsigned short MAX_ID_LENGTH = 256u;
+constexpr unsigned short RAM_SIZE = 1024u; // Number of cells in the stack machine RAM
+constexpr unsigned char  MEMOIZATION_TABLE_CAPACITY = 8u; // Number of the remembered calls of each memoized function
+constexpr double         COMPARE_EPS = 1e-9; // Numbers, that differ by less, are equal in the stack machine comparisons
 
 #endif // COMPILER_CONSTANTS_H
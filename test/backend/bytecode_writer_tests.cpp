@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @brief Tests for writer of IR in the binary format of the stack machine
+ */
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/backend/bytecode-writer.h"
+#include "../../src/backend/Label.h"
+#include "../../src/stack-machine/src/stack-machine.h"
+
+static std::string makeTemporaryFile() {
+    char fileName[] = "/tmp/compiler-test-XXXXXX";
+    const int file = mkstemp(fileName);
+    if (file >= 0) close(file);
+    return fileName;
+}
+
+static std::string readFile(const std::string& fileName) {
+    std::string content;
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (file == nullptr) return content;
+    for (int c = fgetc(file); c != EOF; c = fgetc(file)) {
+        content.push_back((char) c);
+    }
+    fclose(file);
+    return content;
+}
+
+/**
+ * Writes the program by the bytecode writer and by the stack machine assembler from the text dump.
+ * @return true, if both binaries are the same
+ */
+static bool isSameAsAssembled(const IRProgram& program) {
+    const std::string textFileName = makeTemporaryFile();
+    const std::string assembledFileName = makeTemporaryFile();
+    const std::string writtenFileName = makeTemporaryFile();
+
+    FILE* textFile = fopen(textFileName.c_str(), "w");
+    program.dump(textFile);
+    fclose(textFile);
+    const bool isWritten = assemble(textFileName.c_str(), assembledFileName.c_str()) == 0 &&
+                           writeBytecode(program, writtenFileName.c_str()) == 0;
+    const bool isSame = isWritten && readFile(assembledFileName) == readFile(writtenFileName);
+
+    remove(textFileName.c_str());
+    remove(assembledFileName.c_str());
+    remove(writtenFileName.c_str());
+    return isSame;
+}
+
+TEST(bytecodeWriter, jumpOffsetsAreRelative) {
+    const Label loop("loop");
+    const Label end("end");
+    IRProgram program;
+    program.addLabel(&loop);
+    program.addLabel(&end);
+    program.append(Instruction(IR_LABEL, AX, 0, loop.id));
+    program.append(Instruction(IR_PUSH_REG, CX));
+    program.append(Instruction(IR_JMP, AX, 0, end.id));
+    program.append(Instruction(IR_JMP, AX, 0, loop.id));
+    program.append(Instruction(IR_LABEL, AX, 0, end.id));
+    program.append(Instruction(IR_HLT));
+
+    const std::string fileName = makeTemporaryFile();
+    ASSERT_EQUALS(writeBytecode(program, fileName.c_str()), 0);
+    const std::string bytecode = readFile(fileName);
+    remove(fileName.c_str());
+
+    // PUSH CX (2 bytes), JMP end (5 bytes), JMP loop (5 bytes), HLT
+    ASSERT_EQUALS(bytecode.size(), (size_t) 13);
+    int forwardOffset = 0;
+    int backwardOffset = 0;
+    memcpy(&forwardOffset, bytecode.data() + 3, sizeof(int));
+    memcpy(&backwardOffset, bytecode.data() + 8, sizeof(int));
+    ASSERT_EQUALS(forwardOffset, 12 - 3);
+    ASSERT_EQUALS(backwardOffset, 0 - 8);
+    ASSERT_TRUE(isSameAsAssembled(program));
+}
+
+TEST(bytecodeWriter, unknownLabelIsError) {
+    const Label missing("missing");
+    IRProgram program;
+    program.addLabel(&missing);
+    program.append(Instruction(IR_CALL, AX, 0, missing.id));
+
+    const std::string fileName = makeTemporaryFile();
+    ASSERT_EQUALS(writeBytecode(program, fileName.c_str()), (int) ERR_INVALID_LABEL);
+    remove(fileName.c_str());
+}
+
+static const char* const quadraticProgram = R"(
+func solve(a, b, c) {
+    var d = b * b - 4 * a * c;
+    if (d < 0) return 0;
+    print((0 - b + sqrt(d)) / (2 * a));
+    print((0 - b - sqrt(d)) / (2 * a));
+    return 2;
+}
+
+func main() {
+    var a = read();
+    var b = read();
+    var c = read();
+    var count = solve(a, b, c);
+    print(count);
+    print(0.1 + 0.2);
+}
+)";
+
+TEST(bytecodeWriter, sameAsAssembledTextIR) {
+    ASSERT_SAME_OUTPUT(quadraticProgram, "1 -3 2", withLevel(O2), "2\n1\n2\n0.3\n");
+    ASSERT_TRUE(isSameAsAssembled(compileProgram(quadraticProgram, withoutOptimizations())));
+    ASSERT_TRUE(isSameAsAssembled(compileProgram(quadraticProgram, withLevel(O2))));
+    ASSERT_TRUE(isSameAsAssembled(compileProgram(quadraticProgram, withMemoization(withLevel(O2)))));
+}
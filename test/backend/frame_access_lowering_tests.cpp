@@ -0,0 +1,150 @@
+/**
+ * @file
+ * @brief Tests for lowering of frame-relative variable accesses
+ */
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/backend/frame-access-lowering.h"
+#include "../../src/backend/Label.h"
+
+static std::string dumpToString(const IRProgram& program) {
+    FILE* file = tmpfile();
+    program.dump(file);
+    rewind(file);
+    std::string text;
+    for (int c = fgetc(file); c != EOF; c = fgetc(file)) {
+        text.push_back((char) c);
+    }
+    fclose(file);
+    return text;
+}
+
+/**
+ * Lowers frame accesses of the code.
+ * @return text dump of the lowered code
+ */
+static std::string lower(const std::vector<Instruction>& code, const Label* label = nullptr) {
+    IRProgram program;
+    if (label != nullptr) program.addLabel(label);
+    for (const Instruction& instruction : code) program.append(instruction);
+    lowerFrameAccesses(program);
+    return dumpToString(program);
+}
+
+TEST(frameAccessLowering, zeroOffsetIsAccessedByAX) {
+    ASSERT_EQUALS(lower({ Instruction(IR_PUSH_FRAME, AX, 0), Instruction(IR_POP_FRAME, AX, 0) }),
+R"(PUSH [AX]
+POP [AX]
+)");
+}
+
+TEST(frameAccessLowering, addressInBXIsReused) {
+    // n = n - 1
+    ASSERT_EQUALS(lower({
+        Instruction(IR_PUSH_FRAME, AX, 16),
+        Instruction(IR_PUSH, AX, 1),
+        Instruction(IR_SUB),
+        Instruction(IR_POP_FRAME, AX, 16),
+    }),
+R"(PUSH AX
+PUSH 16
+SUB
+POP BX
+PUSH [BX]
+PUSH 1
+SUB
+POP [BX]
+)");
+}
+
+TEST(frameAccessLowering, constantChangeOfAXShiftsAddress) {
+    // After AX = AX + 8 the slot at AX-24 is the one, that was at AX-16
+    ASSERT_EQUALS(lower({
+        Instruction(IR_PUSH_FRAME, AX, 16),
+        Instruction(IR_PUSH_REG, AX),
+        Instruction(IR_PUSH, AX, 8),
+        Instruction(IR_ADD),
+        Instruction(IR_POP_REG, AX),
+        Instruction(IR_POP_FRAME, AX, 24),
+    }),
+R"(PUSH AX
+PUSH 16
+SUB
+POP BX
+PUSH [BX]
+PUSH AX
+PUSH 8
+ADD
+POP AX
+POP [BX]
+)");
+}
+
+TEST(frameAccessLowering, addressIsForgottenAtLabelsAndCalls) {
+    const Label label("label");
+    ASSERT_EQUALS(lower({
+        Instruction(IR_PUSH_FRAME, AX, 16),
+        Instruction(IR_LABEL, AX, 0, label.id),
+        Instruction(IR_PUSH_FRAME, AX, 16),
+        Instruction(IR_CALL, AX, 0, label.id),
+        Instruction(IR_PUSH_FRAME, AX, 16),
+        Instruction(IR_POP_REG, BX),
+        Instruction(IR_PUSH_FRAME, AX, 16),
+    }, &label),
+R"(PUSH AX
+PUSH 16
+SUB
+POP BX
+PUSH [BX]
+label:
+PUSH AX
+PUSH 16
+SUB
+POP BX
+PUSH [BX]
+CALL label
+PUSH AX
+PUSH 16
+SUB
+POP BX
+PUSH [BX]
+POP BX
+PUSH AX
+PUSH 16
+SUB
+POP BX
+PUSH [BX]
+)");
+}
+
+static const char* const countDownProgram = R"(
+func sumDown(n) {
+    var sum = 0;
+    while (n > 0) {
+        sum = sum + n;
+        n = n - 1;
+    }
+    return sum;
+}
+
+func main() {
+    var first = read();
+    var second = read();
+    print(sumDown(first) + sumDown(second));
+}
+)";
+
+TEST(frameAccessLowering, loweredProgramKeepsOutput) {
+    ASSERT_SAME_OUTPUT(countDownProgram, "10 4", withLevel(O1), "65\n");
+    ASSERT_SAME_OUTPUT(countDownProgram, "10 4", withLevel(O2), "65\n");
+
+    const IRProgram program = compileProgram(countDownProgram, withoutOptimizations());
+    ASSERT_EQUALS(countInstructions(program, IR_PUSH_FRAME) + countInstructions(program, IR_POP_FRAME), 0);
+
+    // n is kept in DX by the register allocator, sum is the last variable at [AX]
+    const std::string optimized = dumpToString(compileProgram(countDownProgram, withLevel(O1)));
+    ASSERT_TRUE(optimized.find("PUSH [AX]\nPUSH DX\nADD\nPOP [AX]\nPUSH DX\nPUSH 1\nSUB\nPOP DX\n") != std::string::npos);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @brief Tests for the function frame layout: allocation of the whole frame in the prolog
+ */
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "../testlib.h"
+#include "../program-runner.h"
+
+/**
+ * Finds the frame size, that the prolog of the function adds to AX (`PUSH AX; PUSH AX; PUSH size; ADD; POP AX`).
+ * @return frame size or -1, if there is no such prolog
+ */
+static double findFrameSize(const IRProgram& program, const char* functionName) {
+    const auto& code = program.getInstructions();
+    for (size_t i = 0; i + 5 < code.size(); ++i) {
+        if (code[i].opcode != IR_LABEL || strcmp(program.getLabelName(code[i].labelId), functionName) != 0) continue;
+
+        const bool isProlog = code[i + 1].opcode == IR_PUSH_REG && code[i + 2].opcode == IR_PUSH_REG &&
+                              code[i + 3].opcode == IR_PUSH && code[i + 4].opcode == IR_ADD &&
+                              code[i + 5].opcode == IR_POP_REG && code[i + 5].reg == AX;
+        return isProlog ? code[i + 3].immediate : -1;
+    }
+    return -1;
+}
+
+static std::string dumpToString(const IRProgram& program) {
+    FILE* file = tmpfile();
+    program.dump(file);
+    rewind(file);
+    std::string text;
+    for (int c = fgetc(file); c != EOF; c = fgetc(file)) {
+        text.push_back((char) c);
+    }
+    fclose(file);
+    return text;
+}
+
+static const char* const blocksProgram = R"(
+func pick(a, b) {
+    var x = a;
+    if (x > 0) {
+        var y = b;
+        var z = 2;
+        print(y + z);
+    } else {
+        var w = 3;
+        print(w);
+    }
+    return x;
+}
+
+func main() {
+    print(pick(read(), 5));
+}
+)";
+
+TEST(frameLayout, siblingBlocksShareSlots) {
+    ASSERT_SAME_OUTPUT(blocksProgram, "1", withLevel(O2), "7\n1\n");
+    ASSERT_SAME_OUTPUT(blocksProgram, "-1", withLevel(O2), "3\n-1\n");
+
+    // Parameters a, b, variable x and the larger block (y, z)
+    const IRProgram program = compileProgram(blocksProgram, withoutOptimizations());
+    ASSERT_DOUBLE_EQUALS(findFrameSize(program, "pick"), 5 * 8);
+}
+
+static const char* const mainProgram = R"(
+func main() {
+    var x = read();
+    var y = x * 2;
+    print(y);
+}
+)";
+
+TEST(frameLayout, mainFrameStartsFromZero) {
+    // AX points to the last variable of the frame, so the frame of 'main' is allocated from -8 + 8 = 0
+    ASSERT_EQUALS(dumpToString(compileProgram(mainProgram, withoutOptimizations())),
+R"(PUSH -8
+POP AX
+CALL main
+HLT
+main:
+PUSH AX
+PUSH AX
+PUSH 16
+ADD
+POP AX
+IN
+PUSH AX
+PUSH 8
+SUB
+POP BX
+POP [BX]
+PUSH [BX]
+PUSH 2
+MUL
+POP [AX]
+PUSH [AX]
+OUT
+POP AX
+PUSH 0
+RET
+)");
+}
+
+// Variables of the nested blocks must survive recursive calls, so frames must not overlap
+static const char* const recursiveBlocksProgram = R"(
+func walk(n) {
+    if (n <= 0) return 0;
+    var result = 0;
+    if (n > 2) {
+        var left = n * 10;
+        var right = walk(n - 1);
+        result = left + right;
+    } else {
+        var only = walk(n - 1);
+        result = only + n;
+    }
+    return result;
+}
+
+func main() {
+    var n = read();
+    print(walk(n));
+    print(n);
+}
+)";
+
+TEST(frameLayout, recursiveFramesDontOverlap) {
+    ASSERT_SAME_OUTPUT(recursiveBlocksProgram, "5", withLevel(O1), "123\n5\n");
+    ASSERT_SAME_OUTPUT(recursiveBlocksProgram, "5", withLevel(O2), "123\n5\n");
+
+    const IRProgram program = compileProgram(recursiveBlocksProgram, withoutOptimizations());
+    ASSERT_DOUBLE_EQUALS(findFrameSize(program, "walk"), 4 * 8);
+}
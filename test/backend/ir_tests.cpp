@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Tests for in-memory IR and its text dump
+ */
+#include <cstdio>
+#include <string>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/backend/Label.h"
+
+static std::string dumpToString(const IRProgram& program) {
+    FILE* file = tmpfile();
+    program.dump(file);
+    rewind(file);
+
+    std::string text;
+    for (int c = fgetc(file); c != EOF; c = fgetc(file)) {
+        text.push_back((char) c);
+    }
+    fclose(file);
+    return text;
+}
+
+TEST(ir, jumpsAndTerminators) {
+    const Label label("loop");
+    ASSERT_TRUE(Instruction(IR_JMP, AX, 0, label.id).isJump());
+    ASSERT_TRUE(Instruction(IR_JMPNE, AX, 0, label.id).isJump());
+    ASSERT_TRUE(!Instruction(IR_CALL, AX, 0, label.id).isJump());
+    ASSERT_TRUE(!Instruction(IR_RET).isJump());
+
+    ASSERT_TRUE(Instruction(IR_JMP, AX, 0, label.id).isTerminator());
+    ASSERT_TRUE(Instruction(IR_RET).isTerminator());
+    ASSERT_TRUE(Instruction(IR_HLT).isTerminator());
+    ASSERT_TRUE(!Instruction(IR_JMPL, AX, 0, label.id).isTerminator());
+    ASSERT_TRUE(!Instruction(IR_CALL, AX, 0, label.id).isTerminator());
+}
+
+TEST(ir, dumpUsesAssemblerSyntax) {
+    const Label function("square");
+    const Label loop;
+    IRProgram program;
+    program.addLabel(&function);
+    program.addFunction(&function);
+    program.addLabel(&loop);
+
+    program.append(Instruction(IR_LABEL, AX, 0, function.id));
+    program.append(Instruction(IR_PUSH, AX, 0.1));
+    program.append(Instruction(IR_POP_REG, BX));
+    program.append(Instruction(IR_PUSH_RAM_BY_REG, BX));
+    program.append(Instruction(IR_POP_RAM, AX, 16));
+    program.append(Instruction(IR_PUSH_FRAME, AX, 8));
+    program.append(Instruction(IR_LABEL, AX, 0, loop.id));
+    program.append(Instruction(IR_DUP));
+    program.append(Instruction(IR_JMPNE, AX, 0, loop.id));
+    program.append(Instruction(IR_CALL, AX, 0, function.id));
+    program.append(Instruction(IR_RET));
+
+    ASSERT_TRUE(program.isFunction(function.id));
+    ASSERT_TRUE(!program.isFunction(loop.id));
+    ASSERT_EQUALS(dumpToString(program), std::string("square:\n") +
+        "PUSH 0.10000000000000001\n"
+        "POP BX\n"
+        "PUSH [BX]\n"
+        "POP [16]\n"
+        "PUSH [AX-8]\n" +
+        loop.getName() + ":\n" +
+        "DUP\n"
+        "JMPNE " + loop.getName() + "\n" +
+        "CALL square\n"
+        "RET\n");
+}
+
+static const char* const minimalProgram = R"(
+func main() {
+    print(read());
+}
+)";
+
+TEST(ir, codegenBuildsProgram) {
+    ASSERT_SAME_OUTPUT(minimalProgram, "7", withLevel(O2), "7\n");
+
+    // Entry code sets the frame of 'main', calls it and stops
+    const IRProgram program = compileProgram(minimalProgram, withoutOptimizations());
+    ASSERT_EQUALS(dumpToString(program),
+R"(PUSH -8
+POP AX
+CALL main
+HLT
+main:
+PUSH AX
+IN
+OUT
+POP AX
+PUSH 0
+RET
+)");
+}
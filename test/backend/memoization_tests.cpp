@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief Tests for memoization of pure recursive functions
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+
+static const char* const fibonacciProgram = R"(
+func fib(n) {
+    if (n <= 2) return 1;
+    return fib(n - 1) + fib(n - 2);
+}
+
+func main() {
+    var n = read();
+    while (n > 0) {
+        print(fib(n));
+        n = read();
+    }
+}
+)";
+
+TEST(memoization, sameOutputAsWithoutMemoization) {
+    ASSERT_SAME_OUTPUT(fibonacciProgram, "1 2 10 25 0", withMemoization(withoutOptimizations()), "1\n1\n55\n75025\n");
+    ASSERT_SAME_OUTPUT(fibonacciProgram, "1 2 10 25 0", withMemoization(withLevel(O2)), "1\n1\n55\n75025\n");
+
+    // Only the table lookup uses DX (as the counter of the checked entries)
+    ASSERT_EQUALS(countInstructions(compileProgram(fibonacciProgram, withoutOptimizations()), IR_POP_REG, DX), 0);
+    ASSERT_TRUE(countInstructions(compileProgram(fibonacciProgram, withMemoization(withoutOptimizations())), IR_POP_REG, DX) > 0);
+}
+
+static const char* const closeArgumentsProgram = R"(
+func scaled(x, k) {
+    if (k <= 0) return x * 1000000000000;
+    return scaled(x, k - 1);
+}
+
+func main() {
+    var x = read();
+    var y = read();
+    var zero = 0;
+    print(scaled(0, 1));
+    print(scaled(x, 1));
+    print(scaled(x, 1));
+    if (scaled(y, 1) > scaled(x, 1)) {
+        print(1);
+    } else {
+        print(0);
+    }
+    print(scaled(zero * -1, 1));
+    print(1 / scaled(zero * -1, 1));
+    print(1 / scaled(zero, 1));
+}
+)";
+
+TEST(memoization, argumentsAreComparedExactly) {
+    // Close arguments are read, so the calls are not evaluated at compile time
+    ASSERT_SAME_OUTPUT(closeArgumentsProgram, "0.0000000001 0.00000000010000000001", withMemoization(withoutOptimizations()), "0\n100\n100\n1\n-0\n-inf\ninf\n");
+    ASSERT_SAME_OUTPUT(closeArgumentsProgram, "0.0000000001 0.00000000010000000001", withMemoization(withLevel(O2)), "0\n100\n100\n1\n-0\n-inf\ninf\n");
+}
+
+static const char* const deepCallProgram = R"(
+func count(n) {
+    if (n <= 0) return 0;
+    return count(n - 1) + 1;
+}
+
+func fill(value, depth) {
+    if (depth <= 0) return value;
+    return fill(value, depth - 1);
+}
+
+func main() {
+    print(count(read()));
+    print(fill(77, read()));
+    print(count(77));
+}
+)";
+
+TEST(memoization, deepCallsDontOverwriteTables) {
+    // Frames of the deep recursion reach the end of RAM, tables must stay intact anyway
+    ASSERT_SAME_OUTPUT(deepCallProgram, "3 63", withMemoization(withoutOptimizations()), "3\n77\n77\n");
+    ASSERT_SAME_OUTPUT(deepCallProgram, "3 63", withMemoization(withLevel(O2)), "3\n77\n77\n");
+}
+
+static const char* const reciprocalProgram = R"(
+func reciprocal(x, k) {
+    if (k <= 0) return 1 / x;
+    return reciprocal(x, k - 1);
+}
+
+func main() {
+    var x = read();
+    var y = read();
+    print(reciprocal(x, 1));
+    print(reciprocal(y, 1));
+    print(reciprocal(x, 1));
+}
+)";
+
+TEST(memoization, zerosOfDifferentSignsAreDifferentArguments) {
+    ASSERT_SAME_OUTPUT(reciprocalProgram, "0 -0", withMemoization(withoutOptimizations()), "inf\n-inf\ninf\n");
+    ASSERT_SAME_OUTPUT(reciprocalProgram, "-0 0", withMemoization(withoutOptimizations()), "-inf\ninf\n-inf\n");
+}
+
+static const char* const halfProgram = R"(
+func half(x, k) {
+    if (k <= 0) return x / 2;
+    return half(x, k - 1);
+}
+
+func main() {
+    var x = read();
+    var nan = read();
+    print(half(nan, 1));
+    print(half(x, 1));
+    print(half(nan, 1));
+}
+)";
+
+TEST(memoization, nanArgumentsAreNotMemoized) {
+    // Exact comparisons are false for NaN, so NaN in the table would match any argument, and vice versa
+    ASSERT_SAME_OUTPUT(halfProgram, "4 nan", withMemoization(withoutOptimizations()), "nan\n2\nnan\n");
+    ASSERT_SAME_OUTPUT(halfProgram, "4 nan", withMemoization(withLevel(O2)), "nan\n2\nnan\n");
+}
@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @brief Tests for peephole optimizer of IR
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/backend/codegen.h"
+#include "../../src/backend/Label.h"
+#include "../../src/backend/peephole-optimizer.h"
+
+static std::vector<Instruction> optimizeCode(const std::vector<Instruction>& code) {
+    IRProgram program;
+    for (const Instruction& instruction : code) program.append(instruction);
+    PeepholeOptimizer().optimize(program);
+    return program.getInstructions();
+}
+
+static bool isSameCode(const std::vector<Instruction>& actual, const std::vector<Instruction>& expected) {
+    if (actual.size() != expected.size()) return false;
+    for (size_t i = 0; i < actual.size(); ++i) {
+        const bool isSame = actual[i].opcode == expected[i].opcode && actual[i].reg == expected[i].reg &&
+                            !(actual[i].immediate < expected[i].immediate || actual[i].immediate > expected[i].immediate) &&
+                            actual[i].labelId == expected[i].labelId;
+        if (!isSame) return false;
+    }
+    return true;
+}
+
+TEST(peepholeOptimizer, reloadAfterStoreBecomesDup) {
+    const std::vector<Instruction> code = {
+        Instruction(IR_IN),
+        Instruction(IR_POP_FRAME, AX, 16),
+        Instruction(IR_PUSH_FRAME, AX, 16),
+        Instruction(IR_OUT),
+    };
+    ASSERT_TRUE(isSameCode(optimizeCode(code), {
+        Instruction(IR_IN),
+        Instruction(IR_DUP),
+        Instruction(IR_POP_FRAME, AX, 16),
+        Instruction(IR_OUT),
+    }));
+
+    // Other slot is loaded
+    const std::vector<Instruction> otherSlotCode = {
+        Instruction(IR_POP_FRAME, AX, 16),
+        Instruction(IR_PUSH_FRAME, AX, 8),
+        Instruction(IR_OUT),
+    };
+    ASSERT_TRUE(isSameCode(optimizeCode(otherSlotCode), otherSlotCode));
+}
+
+TEST(peepholeOptimizer, uselessPushesAreRemoved) {
+    const std::vector<Instruction> code = {
+        Instruction(IR_PUSH_REG, AX),
+        Instruction(IR_POP_REG, AX),
+        Instruction(IR_PUSH_FRAME, AX, 8),
+        Instruction(IR_POP_FRAME, AX, 8),
+        Instruction(IR_PUSH, AX, 42),
+        Instruction(IR_POP),
+        Instruction(IR_IN),
+        Instruction(IR_DUP),
+        Instruction(IR_POP),
+        Instruction(IR_OUT),
+    };
+    ASSERT_TRUE(isSameCode(optimizeCode(code), { Instruction(IR_IN), Instruction(IR_OUT) }));
+
+    // Value is moved to the other register
+    const std::vector<Instruction> moveCode = { Instruction(IR_PUSH_REG, AX), Instruction(IR_POP_REG, CX) };
+    ASSERT_TRUE(isSameCode(optimizeCode(moveCode), moveCode));
+}
+
+TEST(peepholeOptimizer, jumpsAreFolded) {
+    const Label target;
+    const std::vector<Instruction> code = {
+        Instruction(IR_PUSH, AX, 0),
+        Instruction(IR_PUSH, AX, 1),
+        Instruction(IR_JMPGE, AX, 0, target.id), // Never taken
+        Instruction(IR_PUSH, AX, 2),
+        Instruction(IR_PUSH, AX, 1),
+        Instruction(IR_JMPG, AX, 0, target.id),  // Always taken
+        Instruction(IR_IN),                      // Unreachable
+        Instruction(IR_OUT),
+        Instruction(IR_LABEL, AX, 0, target.id),
+        Instruction(IR_RET),
+    };
+    ASSERT_TRUE(isSameCode(optimizeCode(code), { Instruction(IR_LABEL, AX, 0, target.id), Instruction(IR_RET) }));
+
+    // Values within COMPARE_EPS are equal for JMPE and JMPNE, but not for the ordering jumps
+    const std::vector<Instruction> closeValuesCode = {
+        Instruction(IR_PUSH, AX, 1),
+        Instruction(IR_PUSH, AX, 1.0000000001),
+        Instruction(IR_JMPNE, AX, 0, target.id), // Never taken
+        Instruction(IR_IN),
+        Instruction(IR_PUSH, AX, 1),
+        Instruction(IR_PUSH, AX, 1.0000000001),
+        Instruction(IR_JMPL, AX, 0, target.id),  // Always taken
+        Instruction(IR_OUT),
+        Instruction(IR_LABEL, AX, 0, target.id),
+        Instruction(IR_RET),
+    };
+    ASSERT_TRUE(isSameCode(optimizeCode(closeValuesCode), {
+        Instruction(IR_IN), Instruction(IR_LABEL, AX, 0, target.id), Instruction(IR_RET)
+    }));
+
+    // No jump is taken for NaN
+    const std::vector<Instruction> nanCode = {
+        Instruction(IR_PUSH, AX, NAN),
+        Instruction(IR_PUSH, AX, 0),
+        Instruction(IR_JMPNE, AX, 0, target.id),
+        Instruction(IR_IN),
+        Instruction(IR_PUSH, AX, NAN),
+        Instruction(IR_PUSH, AX, NAN),
+        Instruction(IR_JMPLE, AX, 0, target.id),
+        Instruction(IR_OUT),
+        Instruction(IR_LABEL, AX, 0, target.id),
+        Instruction(IR_RET),
+    };
+    ASSERT_TRUE(isSameCode(optimizeCode(nanCode), {
+        Instruction(IR_IN), Instruction(IR_OUT), Instruction(IR_LABEL, AX, 0, target.id), Instruction(IR_RET)
+    }));
+}
+
+TEST(peepholeOptimizer, statisticsCountRemovedInstructions) {
+    IRProgram program;
+    program.append(Instruction(IR_IN));
+    program.append(Instruction(IR_POP_FRAME, AX, 8));
+    program.append(Instruction(IR_PUSH_FRAME, AX, 8));
+    program.append(Instruction(IR_PUSH, AX, 1));
+    program.append(Instruction(IR_POP));
+    program.append(Instruction(IR_OUT));
+    PeepholeOptimizer optimizer;
+    optimizer.optimize(program);
+
+    FILE* file = tmpfile();
+    optimizer.dump(file);
+    rewind(file);
+    char name[32] = "";
+    size_t removedNumber = 0;
+    size_t totalRemovedNumber = 0;
+    while (fscanf(file, "%31s %zu", name, &removedNumber) == 2) {
+        if (strcmp(name, "push-drop") == 0) ASSERT_EQUALS(removedNumber, (size_t) 2);
+        if (strcmp(name, "reload-after-store") == 0) ASSERT_EQUALS(removedNumber, (size_t) 0); // DUP replaces the load
+        totalRemovedNumber += removedNumber;
+    }
+    fclose(file);
+    ASSERT_EQUALS(totalRemovedNumber, (size_t) 2);
+}
+
+static const char* const branchesProgram = R"(
+func sign(x) {
+    if (x > 0) return 1;
+    if (x < 0) return -1;
+    return 0;
+}
+
+func main() {
+    var x = read();
+    var y = x * 2;
+    print(y);
+    print(sign(x) + sign(0 - x) + sign(0));
+    if (1 > 2) print(100);
+    while (x > 0) {
+        x = x - 1;
+        y = y + x;
+    }
+    print(y);
+}
+)";
+
+TEST(peepholeOptimizer, optimizedProgramKeepsOutput) {
+    ASSERT_SAME_OUTPUT(branchesProgram, "4", withLevel(O1), "8\n0\n14\n");
+    ASSERT_SAME_OUTPUT(branchesProgram, "-2", withLevel(O1), "-4\n0\n-4\n");
+
+    IRProgram program = codegen(optimizeProgram(branchesProgram, withoutOptimizations()));
+    const size_t unoptimizedSize = program.getInstructions().size();
+    PeepholeOptimizer().optimize(program);
+    ASSERT_TRUE(program.getInstructions().size() < unoptimizedSize);
+    ASSERT_EQUALS(countInstructions(program, IR_OUT), 3);
+}
@@ -0,0 +1,173 @@
+/**
+ * @file
+ * @brief Tests for register allocator
+ */
+#include <cstdio>
+#include <string>
+#include "../testlib.h"
+#include "../program-runner.h"
+
+static std::string dumpToString(const IRProgram& program) {
+    FILE* file = tmpfile();
+    program.dump(file);
+    rewind(file);
+    std::string text;
+    for (int c = fgetc(file); c != EOF; c = fgetc(file)) {
+        text.push_back((char) c);
+    }
+    fclose(file);
+    return text;
+}
+
+static const char* const hotLoopProgram = R"(
+func main() {
+    var n = read();
+    var sum = 0;
+    var i = 0;
+    while (i < n) {
+        sum = sum + i * i;
+        i = i + 1;
+    }
+    print(sum);
+    print(i);
+}
+)";
+
+TEST(registerAllocator, hotVariableIsKeptInDX) {
+    ASSERT_SAME_OUTPUT(hotLoopProgram, "10", withLevel(O1), "285\n10\n");
+    ASSERT_SAME_OUTPUT(hotLoopProgram, "10", withLevel(O2), "285\n10\n");
+
+    ASSERT_EQUALS(countInstructions(compileProgram(hotLoopProgram, withoutOptimizations()), IR_PUSH_REG, DX), 0);
+
+    // sum is kept in DX, while i is the last variable, that is accessed by `PUSH [AX]` anyway
+    const std::string code = dumpToString(compileProgram(hotLoopProgram, withLevel(O1)));
+    ASSERT_TRUE(code.find("PUSH 0\nPOP DX\n") != std::string::npos);
+    ASSERT_TRUE(code.find("PUSH DX\nPUSH [AX]\nDUP\nMUL\nADD\nPOP DX\n") != std::string::npos);
+    ASSERT_TRUE(code.find("PUSH DX\nOUT\n") != std::string::npos);
+}
+
+/**
+ * Counts calls, after which DX is loaded back from the frame (before any other call or label).
+ */
+static size_t countSpilledCalls(const IRProgram& program) {
+    const auto& code = program.getInstructions();
+    size_t count = 0;
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (code[i].opcode != IR_CALL) continue;
+        for (size_t j = i + 1; j < code.size() && code[j].opcode != IR_CALL && code[j].opcode != IR_LABEL; ++j) {
+            if (code[j].opcode == IR_POP_REG && code[j].reg == DX) {
+                ++count;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+// Counter of the loop is live across the recursive call, so it's spilled around the call
+static const char* const recursiveProgram = R"(
+func tree(depth) {
+    if (depth <= 0) return 1;
+    var total = 0;
+    var i = 0;
+    while (i < 3) {
+        total = total + tree(depth - 1) * (i + 1);
+        i = i + 1;
+    }
+    return total;
+}
+
+func main() {
+    print(tree(read()));
+}
+)";
+
+TEST(registerAllocator, DXIsRestoredAfterRecursiveCalls) {
+    ASSERT_SAME_OUTPUT(recursiveProgram, "3", withLevel(O1), "216\n");
+    ASSERT_SAME_OUTPUT(recursiveProgram, "3", withLevel(O2), "216\n");
+    ASSERT_SAME_OUTPUT(recursiveProgram, "3", withLevel(O3), "216\n");
+
+    // AST is not optimized, so the loop with the call is kept
+    CompilationOptions options = withPasses("");
+    options.optimizationLevel = O1;
+    const IRProgram program = compileProgram(recursiveProgram, options);
+    ASSERT_TRUE(countSpilledCalls(program) > 0);
+}
+
+// Each function keeps its own loop counter in DX and calls the next one in the loop
+static const char* const nestedCallsProgram = R"(
+func inner(x) {
+    var s = 0;
+    var k = 0;
+    while (k < x) {
+        s = s + k;
+        k = k + 1;
+    }
+    return s;
+}
+
+func middle(x) {
+    var s = 0;
+    var j = 0;
+    while (j < x) {
+        s = s + inner(j) + j;
+        j = j + 1;
+    }
+    return s;
+}
+
+func outer(x) {
+    var s = 0;
+    var i = 0;
+    while (i < x) {
+        s = s + middle(i) * i;
+        i = i + 1;
+    }
+    return s;
+}
+
+func main() {
+    var n = read();
+    print(outer(n));
+    print(n);
+}
+)";
+
+TEST(registerAllocator, DXIsRestoredAfterNestedCalls) {
+    ASSERT_SAME_OUTPUT(nestedCallsProgram, "6", withLevel(O1), "154\n6\n");
+    ASSERT_SAME_OUTPUT(nestedCallsProgram, "6", withLevel(O2), "154\n6\n");
+    ASSERT_SAME_OUTPUT(nestedCallsProgram, "6", withLevel(O3), "154\n6\n");
+
+    // Counters of 'middle' and 'outer' are spilled around the calls in their loops
+    ASSERT_EQUALS(countSpilledCalls(compileProgram(nestedCallsProgram, withLevel(O1))), 2);
+}
+
+// Memoized 'fib' uses DX for the table lookup, so the counter of the caller's loop, that is kept in DX, must survive the calls
+static const char* const memoizedCalleeProgram = R"(
+func fib(n) {
+    if (n <= 2) return 1;
+    return fib(n - 1) + fib(n - 2);
+}
+
+func main() {
+    var n = read();
+    var i = 1;
+    var sum = 0;
+    while (i <= n) {
+        sum = sum + fib(i);
+        i = i + 1;
+    }
+    print(sum);
+    print(i);
+}
+)";
+
+TEST(registerAllocator, DXIsRestoredAfterMemoizedCalls) {
+    ASSERT_SAME_OUTPUT(memoizedCalleeProgram, "20", withMemoization(withoutOptimizations()), "17710\n21\n");
+    ASSERT_SAME_OUTPUT(memoizedCalleeProgram, "20", withMemoization(withLevel(O1)), "17710\n21\n");
+    ASSERT_SAME_OUTPUT(memoizedCalleeProgram, "20", withMemoization(withLevel(O2)), "17710\n21\n");
+    ASSERT_SAME_OUTPUT(memoizedCalleeProgram, "20", withMemoization(withLevel(O3)), "17710\n21\n");
+
+    const IRProgram program = compileProgram(memoizedCalleeProgram, withMemoization(withLevel(O1)));
+    ASSERT_TRUE(countSpilledCalls(program) > 0);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @brief Tests for forwarding of the stored values to the loads of the next statement
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/backend/codegen.h"
+
+static const char* const forwardingProgram = R"(
+func main() {
+    var a = read() * 2;
+    print(a);
+}
+)";
+
+TEST(storeForwarding, storedValueIsNotLoadedAgain) {
+    ASSERT_SAME_OUTPUT(forwardingProgram, "21", withLevel(O1), "42\n");
+
+    // Stored value is duplicated instead of reading the variable back, -O0 code reads it
+    ASSERT_EQUALS(countInstructions(codegen(optimizeProgram(forwardingProgram, withoutOptimizations())), IR_DUP), 1);
+    ASSERT_EQUALS(countInstructions(compileProgram(forwardingProgram, withoutOptimizations()), IR_DUP), 0);
+}
+
+// Both statements after the first one start by reading the variable, stored by the previous one. Only the first forward
+// is done: the second store happens while the forwarded value of 'a' is still on the stack.
+static const char* const chainedForwardingProgram = R"(
+func g(x) {
+    var a = x + 1;
+    var b = a;
+    print(b);
+    return 0;
+}
+
+func main() {
+    var i = 0;
+    while (i < 3) {
+        g(i);
+        i = i + 1;
+    }
+}
+)";
+
+TEST(storeForwarding, chainedForwardsKeepStackBalanced) {
+    ASSERT_SAME_OUTPUT(chainedForwardingProgram, "", withLevel(O1), "1\n2\n3\n");
+    ASSERT_EQUALS(countInstructions(codegen(optimizeProgram(chainedForwardingProgram, withoutOptimizations())), IR_DUP), 1);
+}
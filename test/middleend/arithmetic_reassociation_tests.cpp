@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief Tests for arithmetic reassociation and negation push-down
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+
+static const char* const arithmeticProgram = R"(
+func main() {
+    var x = read();
+    print(x - -3);
+    print((x + 1) + 2);
+    print(2 * x * 3);
+    print(x / 4 * 8);
+    print(-x * -x);
+    print(x - -4 * x);
+    print(read() - read() + 1);
+}
+)";
+
+static const char* const arithmeticProgramOutput = "8\n8\n30\n10\n25\n25\n0\n";
+
+TEST(arithmeticReassociation, strictModeKeepsResults) {
+    const auto strictOptimizer = std::make_shared<ArithmeticReassociationOptimizer>(FP_STRICT);
+    ASSERT_SAME_OUTPUT(arithmeticProgram, "5 3 4", withOptimizer(strictOptimizer), arithmeticProgramOutput);
+
+    // Only negations are pushed down
+    const auto root = optimizeProgram(arithmeticProgram, withOptimizer(strictOptimizer));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var x = read();
+    print(x + 3);
+    print(x + 1 + 2);
+    print(2 * x * 3);
+    print(x / 4 * 8);
+    print(x * x);
+    print(x - (-4) * x);
+    print(read() - read() + 1);
+}
+)");
+}
+
+TEST(arithmeticReassociation, fastModeFoldsConstants) {
+    const auto fastOptimizer = std::make_shared<ArithmeticReassociationOptimizer>(FP_FAST);
+    ASSERT_SAME_OUTPUT(arithmeticProgram, "5 3 4", withOptimizer(fastOptimizer), arithmeticProgramOutput);
+
+    // Reads keep their order
+    const auto root = optimizeProgram(arithmeticProgram, withOptimizer(fastOptimizer));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var x = read();
+    print(x + 3);
+    print(x + 3);
+    print(6 * x);
+    print(2 * x);
+    print(x * x);
+    print(5 * x);
+    print(read() - read() + 1);
+}
+)");
+}
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Tests for call graph and its strongly connected components
+ */
+#include <cstring>
+#include <vector>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/call-graph.h"
+
+// Program is only analyzed: 'isEven' calls 'isOdd' defined below it, that can't be compiled
+static const char* const mutualRecursionProgram = R"(
+func half(x) {
+    return x / 2;
+}
+
+func isEven(n) {
+    if (n == 0) return 1;
+    return isOdd(half(n * 2) - 1);
+}
+
+func isOdd(n) {
+    if (n == 0) return 0;
+    return isEven(n - 1);
+}
+
+func countDown(n) {
+    if (n <= 0) return 0;
+    return countDown(n - 1);
+}
+
+func main() {
+    print(isEven(read()));
+    print(countDown(3));
+}
+)";
+
+static bool isSameComponent(const std::vector<const char*>& component, const std::vector<const char*>& expectedNames) {
+    if (component.size() != expectedNames.size()) return false;
+    for (size_t i = 0; i < component.size(); ++i) {
+        if (strcmp(component[i], expectedNames[i]) != 0) return false;
+    }
+    return true;
+}
+
+TEST(callGraph, componentsAreOrderedBottomUp) {
+    const CallGraph callGraph(optimizeProgram(mutualRecursionProgram, withoutOptimizations()));
+    const auto& components = callGraph.getBottomUpComponents();
+    ASSERT_EQUALS(components.size(), (size_t) 4);
+
+    // Callees go before callers, functions of the same component are ordered by position
+    ASSERT_TRUE(isSameComponent(components[3], { "main" }));
+    ASSERT_TRUE(callGraph.getComponentIndex("half") < callGraph.getComponentIndex("isEven"));
+    ASSERT_EQUALS(callGraph.getComponentIndex("isEven"), callGraph.getComponentIndex("isOdd"));
+    ASSERT_TRUE(isSameComponent(components[callGraph.getComponentIndex("isOdd")], { "isEven", "isOdd" }));
+    ASSERT_TRUE(isSameComponent(components[callGraph.getComponentIndex("countDown")], { "countDown" }));
+}
+
+TEST(callGraph, recursionIsFoundByComponents) {
+    const CallGraph callGraph(optimizeProgram(mutualRecursionProgram, withoutOptimizations()));
+    ASSERT_TRUE(callGraph.isRecursive("isEven"));
+    ASSERT_TRUE(callGraph.isRecursive("isOdd"));
+    ASSERT_TRUE(callGraph.isRecursive("countDown"));
+    ASSERT_TRUE(!callGraph.isRecursive("half"));
+    ASSERT_TRUE(!callGraph.isRecursive("main"));
+    ASSERT_EQUALS(callGraph.getCallSitesNumber("isEven"), (size_t) 2);
+}
+
+// Each function is small enough to be inlined only after its own callee is inlined into it
+static const char* const callChainProgram = R"(
+func addOne(x) {
+    return x + 1;
+}
+
+func addTwo(x) {
+    return addOne(addOne(x));
+}
+
+func addFour(x) {
+    return addTwo(addTwo(x));
+}
+
+func main() {
+    var x = read();
+    print(addFour(x));
+    print(addFour(x * 2));
+}
+)";
+
+TEST(callGraph, inlinerProcessesCalleesFirst) {
+    ASSERT_SAME_OUTPUT(callChainProgram, "3", withPasses("function-inliner"), "7\n10\n");
+    ASSERT_SAME_OUTPUT(callChainProgram, "3", withLevel(O2), "7\n10\n");
+
+    const auto root = optimizeProgram(callChainProgram, withPasses("function-inliner"));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var x = read();
+    print(x + 1 + 1 + 1 + 1);
+    print(x * 2 + 1 + 1 + 1 + 1);
+}
+)");
+}
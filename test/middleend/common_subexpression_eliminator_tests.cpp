@@ -0,0 +1,65 @@
+/**
+ * @file
+ * @brief Tests for common subexpression eliminator
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/common-subexpression-eliminator.h"
+
+static const char* const repeatedExpressionsProgram = R"(
+func main() {
+    var a = read();
+    var b = read();
+    var c = read();
+    var x = (b * b - a * c) / 2;
+    var y = (b * b - a * c) / 4;
+    print(x);
+    print(y);
+    a = a + 1;
+    print(b * b - a * c);
+}
+)";
+
+TEST(commonSubexpressionEliminator, repeatedExpressionsAreReused) {
+    ASSERT_SAME_OUTPUT(repeatedExpressionsProgram, "1 4 2", withOptimizer(std::make_shared<CommonSubexpressionEliminator>()), "7\n3.5\n12\n");
+
+    // Expression is recomputed after 'a' is changed
+    const auto root = optimizeProgram(repeatedExpressionsProgram, withOptimizer(std::make_shared<CommonSubexpressionEliminator>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var a = read();
+    var b = read();
+    var c = read();
+    var cse.1 = b * b - a * c;
+    var x = cse.1 / 2;
+    var y = cse.1 / 4;
+    print(x);
+    print(y);
+    a = a + 1;
+    print(b * b - a * c);
+}
+)");
+}
+
+static const char* const loopProgram = R"(
+func main() {
+    var a = read();
+    var b = read();
+    var s = a * b + a * a;
+    var i = 0;
+    while (i < 3) {
+        s = s + (a * b + a * a);
+        a = a + 1;
+        i = i + 1;
+    }
+    print(s);
+    print(a * b + a * a);
+}
+)";
+
+TEST(commonSubexpressionEliminator, expressionsAssignedInLoopAreRecomputed) {
+    ASSERT_SAME_OUTPUT(loopProgram, "1 2", withOptimizer(std::make_shared<CommonSubexpressionEliminator>()), "29\n24\n");
+
+    const auto root = optimizeProgram(loopProgram, withOptimizer(std::make_shared<CommonSubexpressionEliminator>()));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(loopProgram, withoutOptimizations())));
+}
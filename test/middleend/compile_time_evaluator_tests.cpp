@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @brief Tests for compile-time evaluator of function calls
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/compile-time-evaluator.h"
+
+static const char* const constantCallsProgram = R"(
+func fib(n) {
+    if (n <= 2) return 1;
+    return fib(n - 1) + fib(n - 2);
+}
+
+func sumTo(n) {
+    var s = 0;
+    while (n > 0) {
+        s = s + n;
+        n = n - 1;
+    }
+    return s;
+}
+
+func inverse(x) {
+    return 1 / x;
+}
+
+func loud(x) {
+    print(x);
+    return x;
+}
+
+func main() {
+    print(fib(10));
+    print(sumTo(100) + sqrt(16));
+    print(inverse(sumTo(0)));
+    print(loud(3));
+    print(fib(read()));
+}
+)";
+
+TEST(compileTimeEvaluator, pureCallsWithConstantArgumentsAreEvaluated) {
+    ASSERT_SAME_OUTPUT(constantCallsProgram, "7", withOptimizer(std::make_shared<CompileTimeEvaluator>()), "55\n5054\ninf\n3\n3\n13\n");
+
+    // Calls with not finite result, impure calls and calls with unknown arguments are kept
+    const auto root = optimizeProgram(constantCallsProgram, withOptimizer(std::make_shared<CompileTimeEvaluator>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    print(55);
+    print(5050 + 4);
+    print(inverse(0));
+    print(loud(3));
+    print(fib(read()));
+}
+)");
+}
+
+static const char* const deepRecursionProgram = R"(
+func depth(n) {
+    if (n <= 0) return 0;
+    return 1 + depth(n - 1);
+}
+
+func main() {
+    print(depth(100000));
+}
+)";
+
+TEST(compileTimeEvaluator, tooDeepCallsAreKept) {
+    const auto root = optimizeProgram(deepRecursionProgram, withOptimizer(std::make_shared<CompileTimeEvaluator>()));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(deepRecursionProgram, withoutOptimizations())));
+}
@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @brief Tests for dead code eliminator
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/dead-code-eliminator.h"
+
+static const char* const deadCodeProgram = R"(
+func twice(x) {
+    return x * 2;
+}
+
+func main() {
+    var x = read();
+    var unused = x + 1;
+    var skipped = read();
+    x + 1;
+    twice(x);
+    if (1 < 2) {
+        print(x);
+    } else {
+        print(0);
+    }
+    while (2 < 1) {
+        print(100);
+    }
+    print(read());
+    return 0;
+    print(42);
+}
+)";
+
+TEST(deadCodeEliminator, sideEffectsAreKept) {
+    ASSERT_SAME_OUTPUT(deadCodeProgram, "4 7 9", withOptimizer(std::make_shared<DeadCodeEliminator>()), "4\n9\n");
+}
+
+TEST(deadCodeEliminator, deadStatementsAreRemoved) {
+    const auto root = optimizeProgram(deadCodeProgram, withOptimizer(std::make_shared<DeadCodeEliminator>()));
+    // Read of the unused variable is kept
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var x = read();
+    var skipped = read();
+    {
+        print(x);
+    }
+    print(read());
+    return 0;
+}
+)");
+}
+
+static const char* const endlessLoopProgram = R"(
+func firstAbove(limit) {
+    var i = 0;
+    while (0 < 1) {
+        if (i * i > limit) return i;
+        i = i + 1;
+    }
+    print(limit);
+    return 0 - 1;
+}
+
+func main() {
+    print(firstAbove(read()));
+}
+)";
+
+TEST(deadCodeEliminator, codeAfterEndlessLoopIsRemoved) {
+    ASSERT_SAME_OUTPUT(endlessLoopProgram, "10", withOptimizer(std::make_shared<DeadCodeEliminator>()), "4\n");
+
+    const auto root = optimizeProgram(endlessLoopProgram, withOptimizer(std::make_shared<DeadCodeEliminator>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "firstAbove")),
+R"(func firstAbove(limit) {
+    var i = 0;
+    while (0 < 1) {
+        if (i * i > limit) {
+            return i;
+        }
+        i = i + 1;
+    }
+}
+)");
+}
@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @brief Tests for dead store eliminator
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/dead-store-eliminator.h"
+
+static const char* const deadStoreProgram = R"(
+func main() {
+    var a = read();
+    var b = read();
+    var x = a * 2;
+    x = b;
+    print(x);
+    x = a + b;
+}
+)";
+
+TEST(deadStoreEliminator, overwrittenStoresAreRemoved) {
+    ASSERT_SAME_OUTPUT(deadStoreProgram, "3 4", withOptimizer(std::make_shared<DeadStoreEliminator>()), "4\n");
+
+    const auto root = optimizeProgram(deadStoreProgram, withOptimizer(std::make_shared<DeadStoreEliminator>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var a = read();
+    var b = read();
+    var x = a * 2;
+    x = b;
+    print(x);
+}
+)");
+}
+
+static const char* const loopCarriedProgram = R"(
+func main() {
+    var n = read();
+    var previous = 0;
+    var current = 1;
+    var i = 0;
+    while (i < n) {
+        var next = previous + current;
+        previous = current;
+        current = next;
+        i = i + 1;
+    }
+    print(current);
+}
+)";
+
+TEST(deadStoreEliminator, storesReadByNextIterationAreKept) {
+    ASSERT_SAME_OUTPUT(loopCarriedProgram, "10", withOptimizer(std::make_shared<DeadStoreEliminator>()), "89\n");
+
+    const auto root = optimizeProgram(loopCarriedProgram, withOptimizer(std::make_shared<DeadStoreEliminator>()));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(loopCarriedProgram, withoutOptimizations())));
+}
+
+static const char* const effectfulStoreProgram = R"(
+func traced(x) {
+    print(x);
+    return x;
+}
+
+func main() {
+    var x = 0;
+    x = traced(1);
+    x = traced(2);
+    print(x);
+}
+)";
+
+TEST(deadStoreEliminator, sideEffectsOfRemovedStoresAreKept) {
+    ASSERT_SAME_OUTPUT(effectfulStoreProgram, "", withOptimizer(std::make_shared<DeadStoreEliminator>()), "1\n2\n2\n");
+
+    const auto root = optimizeProgram(effectfulStoreProgram, withOptimizer(std::make_shared<DeadStoreEliminator>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var x = 0;
+    traced(1);
+    x = traced(2);
+    print(x);
+}
+)");
+}
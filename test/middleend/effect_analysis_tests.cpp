@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @brief Tests for effect analysis of the functions
+ */
+#include <cstring>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/dead-code-eliminator.h"
+#include "../../src/middleend/effect-analysis.h"
+
+static const char* const effectsProgram = R"(
+func square(x) {
+    return x * x;
+}
+
+func sumTo(n) {
+    var s = 0;
+    while (n > 0) {
+        s = s + square(n);
+        n = n - 1;
+    }
+    return s;
+}
+
+func fib(n) {
+    if (n <= 2) return 1;
+    return fib(n - 1) + fib(n - 2);
+}
+
+func countDown(n) {
+    if (n <= 0) return 0;
+    n = n - 1;
+    return countDown(n);
+}
+
+func report(x) {
+    print(square(x));
+}
+
+func ask() {
+    return read() + 1;
+}
+
+func main() {
+    report(ask());
+    print(sumTo(3) + fib(5) + countDown(2));
+}
+)";
+
+TEST(effectAnalysis, effectsArePropagatedToCallers) {
+    const EffectAnalysis effects(optimizeProgram(effectsProgram, withoutOptimizations()));
+
+    ASSERT_TRUE(effects.isPure("square"));
+    ASSERT_TRUE(!effects.getEffects("square").mayNotTerminate);
+    ASSERT_TRUE(effects.isPure("sumTo"));
+    ASSERT_TRUE(effects.getEffects("sumTo").mayNotTerminate);
+    ASSERT_TRUE(effects.isPure("fib"));
+    ASSERT_TRUE(effects.isRecursive("fib"));
+    ASSERT_TRUE(effects.writesOutput("report"));
+    ASSERT_TRUE(!effects.readsInput("report"));
+    ASSERT_TRUE(effects.readsInput("ask"));
+    ASSERT_TRUE(!effects.writesOutput("ask"));
+    ASSERT_TRUE(effects.readsInput("main") && effects.writesOutput("main"));
+    ASSERT_TRUE(effects.isPure("sqrt"));
+    ASSERT_TRUE(!effects.isPure("unknown"));
+}
+
+// Functions can't be called above their definitions, so it's only analysed, not compiled
+static const char* const mutualRecursionProgram = R"(
+func even(n) {
+    if (n <= 0) return 1;
+    return odd(n - 1);
+}
+
+func odd(n) {
+    if (n <= 0) {
+        print(n);
+        return 0;
+    }
+    return even(n - 1);
+}
+
+func main() {
+    print(even(4));
+}
+)";
+
+TEST(effectAnalysis, mutuallyRecursiveFunctionsShareEffects) {
+    const EffectAnalysis effects(optimizeProgram(mutualRecursionProgram, withoutOptimizations()));
+
+    ASSERT_TRUE(effects.isRecursive("even") && effects.isRecursive("odd"));
+    ASSERT_TRUE(effects.writesOutput("even") && effects.writesOutput("odd"));
+}
+
+TEST(effectAnalysis, onlyPureRecursiveFunctionsWithUnchangedParametersAreMemoizable) {
+    const EffectAnalysis effects(optimizeProgram(effectsProgram, withoutOptimizations()));
+
+    const auto memoizable = effects.getMemoizableFunctions();
+    ASSERT_EQUALS(memoizable.size(), 1);
+    ASSERT_TRUE(strcmp(memoizable[0], "fib") == 0);
+    ASSERT_TRUE(!effects.isMemoizable("countDown"));
+    ASSERT_TRUE(!effects.isMemoizable("square"));
+}
+
+static const char* const unusedCallsProgram = R"(
+func square(x) {
+    return x * x;
+}
+
+func report(x) {
+    print(x);
+    return x;
+}
+
+func main() {
+    var x = read();
+    square(x);
+    report(x);
+    var unused = square(x) + 1;
+    var kept = report(x + 1);
+}
+)";
+
+TEST(effectAnalysis, sideEffectFreeCallsAreRemoved) {
+    ASSERT_SAME_OUTPUT(unusedCallsProgram, "2", withOptimizer(std::make_shared<DeadCodeEliminator>()), "2\n3\n");
+
+    const auto root = optimizeProgram(unusedCallsProgram, withOptimizer(std::make_shared<DeadCodeEliminator>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var x = read();
+    report(x);
+    var kept = report(x + 1);
+}
+)");
+}
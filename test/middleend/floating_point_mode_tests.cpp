@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Tests for strict and fast floating-point modes of trivial operations optimizer
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+
+static CompilationOptions withFastMath(CompilationOptions options) {
+    options.fpMode = FP_FAST;
+    return options;
+}
+
+// Operands are read, so they are not known at compile time
+static const char* const trivialOperationsProgram = R"(
+func main() {
+    var x = read();
+    var zero = read();
+    var infinity = x / zero;
+    var negativeZero = read();
+    print(infinity * 0);
+    print(negativeZero + 0);
+    print(negativeZero - 0);
+    print(x * 0.0000000001);
+    print(x * 1);
+    print(x / 1);
+}
+)";
+
+TEST(floatingPointMode, strictModeKeepsSpecialValues) {
+    const std::string output = compileAndRun(trivialOperationsProgram, "5 0 -0", withoutOptimizations());
+    ASSERT_EQUALS(output.substr(output.find('\n') + 1), std::string("0\n-0\n5e-10\n5\n5\n"));
+    ASSERT_EQUALS(compileAndRun(trivialOperationsProgram, "5 0 -0", withPasses("trivial-operations")), output);
+    ASSERT_EQUALS(compileAndRun(trivialOperationsProgram, "5 0 -0", withLevel(O2)), output);
+    ASSERT_EQUALS(compileAndRun(trivialOperationsProgram, "5 0 -0", withLevel(O3)), output);
+
+    // Only `x - 0`, `x * 1` and `x / 1` are simplified
+    ASSERT_EQUALS(printCode(optimizeProgram(trivialOperationsProgram, withPasses("trivial-operations"))),
+R"(func main() {
+    var x = read();
+    var zero = read();
+    var infinity = x / zero;
+    var negativeZero = read();
+    print(infinity * 0);
+    print(negativeZero + 0);
+    print(negativeZero);
+    print(x * 1e-10);
+    print(x);
+    print(x);
+}
+)");
+}
+
+TEST(floatingPointMode, fastModeFoldsMultiplicationByZero) {
+    const auto options = withFastMath(withPasses("trivial-operations"));
+    const std::string output = compileAndRun(trivialOperationsProgram, "5 0 -0", options);
+    ASSERT_EQUALS(output, std::string("0\n-0\n-0\n5e-10\n5\n5\n"));
+
+    // `infinity * 0` and `negativeZero + 0` are simplified too
+    ASSERT_EQUALS(printCode(optimizeProgram(trivialOperationsProgram, options)),
+R"(func main() {
+    var x = read();
+    var zero = read();
+    var infinity = x / zero;
+    var negativeZero = read();
+    print(0);
+    print(negativeZero);
+    print(negativeZero);
+    print(x * 1e-10);
+    print(x);
+    print(x);
+}
+)");
+}
+
+static const char* const finiteProgram = R"(
+func main() {
+    var x = read();
+    var y = (x + 1) + 2;
+    print(0 * x + y * 1 - 0);
+    print(x / 4 * 8);
+}
+)";
+
+TEST(floatingPointMode, fastModeKeepsFiniteResults) {
+    ASSERT_SAME_OUTPUT(finiteProgram, "3", withFastMath(withLevel(O2)), "6\n6\n");
+    ASSERT_SAME_OUTPUT(finiteProgram, "3", withFastMath(withLevel(O3)), "6\n6\n");
+}
+
+// Sign of NaN depends on how the host computes `0 / 0`, so it's not compared
+static std::string withoutNaNSigns(std::string output) {
+    for (size_t position = output.find("-nan"); position != std::string::npos; position = output.find("-nan", position)) {
+        output.erase(position, 1);
+    }
+    return output;
+}
+
+// `0 / 0` is folded into NaN constant, that is neither zero, nor one
+static const char* const nanConstantProgram = R"(
+func main() {
+    var x = read();
+    print(x + 0 / 0);
+    print(x - 0 / 0);
+    print(x * (0 / 0 + 1));
+    print(5 + (0 / 0 - 1));
+}
+)";
+
+TEST(floatingPointMode, nanConstantsAreNotTrivialOperands) {
+    ASSERT_EQUALS(withoutNaNSigns(compileAndRun(nanConstantProgram, "3", withoutOptimizations())), std::string("nan\nnan\nnan\nnan\n"));
+    ASSERT_EQUALS(withoutNaNSigns(compileAndRun(nanConstantProgram, "3", withLevel(O1))), std::string("nan\nnan\nnan\nnan\n"));
+    ASSERT_EQUALS(withoutNaNSigns(compileAndRun(nanConstantProgram, "3", withLevel(O2))), std::string("nan\nnan\nnan\nnan\n"));
+    ASSERT_EQUALS(withoutNaNSigns(compileAndRun(nanConstantProgram, "3", withFastMath(withLevel(O3)))), std::string("nan\nnan\nnan\nnan\n"));
+}
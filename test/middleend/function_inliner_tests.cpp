@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @brief Tests for function inliner
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/function-inliner.h"
+
+static const char* const swappedArgumentsProgram = R"(
+func diff(a, b) {
+    return a - b;
+}
+
+func main() {
+    var a = read();
+    var b = read();
+    print(diff(b, a));
+    print(diff(b, 1));
+    print(diff(a + b, b));
+}
+)";
+
+TEST(functionInliner, argumentNamedAsOtherParameter) {
+    ASSERT_SAME_OUTPUT(swappedArgumentsProgram, "5 2", withOptimizer(std::make_shared<FunctionInliner>()), "-3\n1\n5\n");
+}
+
+TEST(functionInliner, expressionCallsAreInlined) {
+    const auto root = optimizeProgram(swappedArgumentsProgram, withOptimizer(std::make_shared<FunctionInliner>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var a = read();
+    var b = read();
+    print(b - a);
+    print(b - 1);
+    print(a + b - b);
+}
+)");
+}
+
+static const char* const statementsProgram = R"(
+func sumTo(n) {
+    var s = 0;
+    while (n > 0) {
+        s = s + n;
+        n = n - 1;
+    }
+    return s;
+}
+
+func report(x) {
+    if (x > 10) {
+        print(x);
+        return 1;
+    }
+    print(0 - x);
+}
+
+func main() {
+    var n = read();
+    var s = sumTo(n);
+    print(s);
+    report(s);
+    report(n);
+    print(n);
+}
+)";
+
+TEST(functionInliner, statementCallsAreInlined) {
+    ASSERT_SAME_OUTPUT(statementsProgram, "5", withOptimizer(std::make_shared<FunctionInliner>()), "15\n15\n-5\n5\n");
+
+    const auto root = optimizeProgram(statementsProgram, withOptimizer(std::make_shared<FunctionInliner>()));
+    // Locals and parameters are renamed, the result is assigned to the declared variable, return becomes else branch
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var n = read();
+    var s;
+    {
+        var n.1 = n;
+        var s.1 = 0;
+        while (n.1 > 0) {
+            s.1 = s.1 + n.1;
+            n.1 = n.1 - 1;
+        }
+        s = s.1;
+    }
+    print(s);
+    {
+        if (s > 10) {
+            {
+                print(s);
+            }
+        } else {
+            print(0 - s);
+        }
+    }
+    {
+        if (n > 10) {
+            {
+                print(n);
+            }
+        } else {
+            print(0 - n);
+        }
+    }
+    print(n);
+}
+)");
+}
+
+static const char* const recursiveProgram = R"(
+func fact(n) {
+    if (n <= 1) return 1;
+    return n * fact(n - 1);
+}
+
+func main() {
+    print(fact(read()));
+}
+)";
+
+TEST(functionInliner, recursiveFunctionsAreNotInlined) {
+    ASSERT_SAME_OUTPUT(recursiveProgram, "6", withOptimizer(std::make_shared<FunctionInliner>()), "720\n");
+
+    const auto root = optimizeProgram(recursiveProgram, withOptimizer(std::make_shared<FunctionInliner>()));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(recursiveProgram, withoutOptimizations())));
+}
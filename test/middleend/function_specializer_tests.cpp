@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Tests for function specializer
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/function-specializer.h"
+
+static const char* const constantArgumentsProgram = R"(
+func scale(x, mode) {
+    if (mode == 1) return x * 2;
+    return x * 3;
+}
+
+func pick(x, mode) {
+    if (mode > 1) {
+        return x + mode;
+    }
+    return x - 1;
+}
+
+func power(x, n) {
+    if (n <= 0) return 1;
+    return x * power(x, n - 1);
+}
+
+func main() {
+    var a = read();
+    print(scale(a, 1));
+    print(scale(a + 1, 1));
+    print(pick(a, 1));
+    print(pick(a, 2));
+    print(pick(a + 1, 2));
+    print(power(a, 3));
+}
+)";
+
+TEST(functionSpecializer, constantArgumentsArePropagated) {
+    ASSERT_SAME_OUTPUT(constantArgumentsProgram, "5", withOptimizer(std::make_shared<FunctionSpecializer>()), "10\n12\n4\n7\n8\n125\n");
+
+    // Parameter 'mode' of 'scale' is removed, calls of 'pick' are redirected to two copies, that replace unused 'pick',
+    // parameter 'n' of 'power' is changed by the recursive call
+    const auto root = optimizeProgram(constantArgumentsProgram, withOptimizer(std::make_shared<FunctionSpecializer>()));
+    ASSERT_EQUALS(printCode(root),
+R"(func scale(x) {
+    if (1 == 1) {
+        return x * 2;
+    }
+    return x * 3;
+}
+func pick_1(x) {
+    if (2 > 1) {
+        return x + 2;
+    }
+    return x - 1;
+}
+func pick_2(x) {
+    if (1 > 1) {
+        return x + 1;
+    }
+    return x - 1;
+}
+func power(x, n) {
+    if (n <= 0) {
+        return 1;
+    }
+    return x * power(x, n - 1);
+}
+func main() {
+    var a = read();
+    print(scale(a));
+    print(scale(a + 1));
+    print(pick_2(a));
+    print(pick_1(a));
+    print(pick_1(a + 1));
+    print(power(a, 3));
+}
+)");
+}
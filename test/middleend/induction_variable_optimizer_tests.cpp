@@ -0,0 +1,167 @@
+/**
+ * @file
+ * @brief Tests for scalar evolution and induction variable optimizer
+ */
+#include <cstring>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/induction-variable-optimizer.h"
+#include "../../src/middleend/loop-analysis.h"
+#include "../../src/middleend/scalar-evolution.h"
+
+static const char* const closedFormProgram = R"(
+func main() {
+    var n = read();
+    var s = 0;
+    var c = 0;
+    var i = 0;
+    while (i < 100) {
+        s = s + (4 * i + 1);
+        c = c - n;
+        i = i + 1;
+    }
+    print(s);
+    print(c);
+    print(i);
+}
+)";
+
+TEST(scalarEvolution, accumulatorIncrementIsAffine) {
+    const auto root = optimizeProgram(closedFormProgram, withoutOptimizations());
+    const auto loop = findNode(root, WHILE_NODE);
+    LoopCounter counter;
+    ASSERT_TRUE(findLoopCounter(loop, counter));
+
+    Accumulator accumulator;
+    ASSERT_TRUE(findAccumulator(loop, 0, counter, accumulator));
+    ASSERT_TRUE(strcmp(accumulator.name, "s") == 0);
+    ASSERT_TRUE(accumulator.increment.coefficient.isConstant() && accumulator.increment.offset.isConstant());
+    ASSERT_DOUBLE_EQUALS(accumulator.increment.coefficient.constant, 4);
+    ASSERT_DOUBLE_EQUALS(accumulator.increment.offset.constant, 1);
+
+    // Invariant, but not constant increment
+    ASSERT_TRUE(findAccumulator(loop, 1, counter, accumulator));
+    ASSERT_TRUE(accumulator.increment.coefficient.isZero());
+    ASSERT_TRUE(!accumulator.increment.offset.isConstant());
+
+    // Counter itself is not an accumulator
+    ASSERT_TRUE(!findAccumulator(loop, 2, counter, accumulator));
+}
+
+static const char* const integerClosedFormProgram = R"(
+func main() {
+    var s = 0;
+    var c = 5;
+    var i = 0;
+    while (i < 100) {
+        s = s + (4 * i + 1);
+        c = c - 3;
+        i = i + 1;
+    }
+    print(s);
+    print(c);
+    print(i);
+}
+)";
+
+TEST(inductionVariableOptimizer, loopIsReplacedWithFinalValues) {
+    ASSERT_SAME_OUTPUT(integerClosedFormProgram, "", withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_STRICT)), "19900\n-295\n100\n");
+
+    const auto root = optimizeProgram(integerClosedFormProgram, withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_STRICT)));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var s = 0;
+    var c = 5;
+    var i = 0;
+    s = 19900;
+    c = -295;
+    i = 100;
+    print(s);
+    print(c);
+    print(i);
+}
+)");
+}
+
+TEST(inductionVariableOptimizer, invariantIncrementsAreSummedInFastMode) {
+    const CompilationOptions fastOptions = withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_FAST));
+    ASSERT_SAME_OUTPUT(closedFormProgram, "3", fastOptions, "19900\n-300\n100\n");
+    ASSERT_EQUALS(printCode(findFunction(optimizeProgram(closedFormProgram, fastOptions), "main")),
+R"(func main() {
+    var n = read();
+    var s = 0;
+    var c = 0;
+    var i = 0;
+    s = 19900;
+    c = c + (0 - n) * 100;
+    i = 100;
+    print(s);
+    print(c);
+    print(i);
+}
+)");
+
+    // Increment c - n is not known to be an integer, so the strict mode keeps the loop
+    const CompilationOptions strictOptions = withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_STRICT));
+    ASSERT_EQUALS(printCode(optimizeProgram(closedFormProgram, strictOptions)), printCode(optimizeProgram(closedFormProgram, withoutOptimizations())));
+}
+
+static const char* const derivedVariableProgram = R"(
+func main() {
+    var n = read();
+    var x = 1;
+    var y = 0;
+    var i = 0;
+    while (i < n) {
+        x = x * (i * 4 + i * 2 + 1);
+        y = y + (i * 4 + i * 2 + 1);
+        i = i + 1;
+    }
+    print(x);
+    print(y);
+}
+)";
+
+TEST(inductionVariableOptimizer, derivedVariablesAreComputedByAdditions) {
+    ASSERT_SAME_OUTPUT(derivedVariableProgram, "4", withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_STRICT)), "1729\n40\n");
+    ASSERT_SAME_OUTPUT(derivedVariableProgram, "0", withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_STRICT)), "1\n0\n");
+
+    // Multiplications by the counter are replaced with the additions to the new variable
+    const auto root = optimizeProgram(derivedVariableProgram, withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_STRICT)));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var n = read();
+    var x = 1;
+    var y = 0;
+    var i = 0;
+    var iv.1 = i * 4 + i * 2 + 1;
+    while (i < n) {
+        x = x * iv.1;
+        y = y + iv.1;
+        i = i + 1;
+        iv.1 = iv.1 + 6;
+    }
+    print(x);
+    print(y);
+}
+)");
+}
+
+static const char* const fractionalCounterProgram = R"(
+func main() {
+    var s = 0;
+    var i = 0.1;
+    while (i < 10) {
+        s = s + 3 * i;
+        i = i + 1;
+    }
+    print(s);
+}
+)";
+
+TEST(inductionVariableOptimizer, inexactLoopsAreKeptInStrictMode) {
+    ASSERT_SAME_OUTPUT(fractionalCounterProgram, "", withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_STRICT)), "138\n");
+
+    const auto root = optimizeProgram(fractionalCounterProgram, withOptimizer(std::make_shared<InductionVariableOptimizer>(FP_STRICT)));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(fractionalCounterProgram, withoutOptimizations())));
+}
@@ -0,0 +1,128 @@
+/**
+ * @file
+ * @brief Tests for linear recursion eliminator
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/linear-recursion-eliminator.h"
+#include "../../src/middleend/tail-call-eliminator.h"
+
+static const char* const linearRecursionProgram = R"(
+func fact(n) {
+    if (n <= 1) return 1;
+    return n * fact(n - 1);
+}
+
+func sumTo(n) {
+    if (n <= 0) return 0;
+    return sumTo(n - 1) + n;
+}
+
+func main() {
+    var n = read();
+    print(fact(n));
+    print(sumTo(n));
+}
+)";
+
+TEST(linearRecursionEliminator, strictModeKeepsRecursion) {
+    const auto root = optimizeProgram(linearRecursionProgram, withOptimizer(std::make_shared<LinearRecursionEliminator>(FP_STRICT)));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(linearRecursionProgram, withoutOptimizations())));
+}
+
+TEST(linearRecursionEliminator, accumulatorMakesCallsTail) {
+    const auto options = withOptimizer(std::make_shared<LinearRecursionEliminator>(FP_FAST));
+    ASSERT_SAME_OUTPUT(linearRecursionProgram, "7", options, "5040\n28\n");
+
+    // Both functions become wrappers of the new accumulating functions
+    const auto root = optimizeProgram(linearRecursionProgram, options);
+    ASSERT_EQUALS(printCode(root),
+R"(func fact_1(n, acc.1) {
+    if (n <= 1) {
+        return acc.1 * 1;
+    }
+    return fact_1(n - 1, acc.1 * n);
+}
+func fact(n) {
+    return fact_1(n, 1);
+}
+func sumTo_1(n, acc.2) {
+    if (n <= 0) {
+        return acc.2 + 0;
+    }
+    return sumTo_1(n - 1, acc.2 + n);
+}
+func sumTo(n) {
+    return sumTo_1(n, 0);
+}
+func main() {
+    var n = read();
+    print(fact(n));
+    print(sumTo(n));
+}
+)");
+}
+
+TEST(linearRecursionEliminator, tailCallEliminatorMakesLoops) {
+    auto optimizer = std::make_shared<CompositeOptimizer>();
+    optimizer->addOptimizer(std::make_shared<LinearRecursionEliminator>(FP_FAST));
+    optimizer->addOptimizer(std::make_shared<TailCallEliminator>());
+    ASSERT_SAME_OUTPUT(linearRecursionProgram, "7", withOptimizer(optimizer), "5040\n28\n");
+
+    const auto root = optimizeProgram(linearRecursionProgram, withOptimizer(optimizer));
+    ASSERT_EQUALS(printCode(root),
+R"(func fact_1(n, acc.1) {
+    while (0 < 1) {
+        if (n <= 1) {
+            return acc.1 * 1;
+        }
+        {
+            acc.1 = acc.1 * n;
+            n = n - 1;
+        }
+    }
+}
+func fact(n) {
+    return fact_1(n, 1);
+}
+func sumTo_1(n, acc.2) {
+    while (0 < 1) {
+        if (n <= 0) {
+            return acc.2 + 0;
+        }
+        {
+            acc.2 = acc.2 + n;
+            n = n - 1;
+        }
+    }
+}
+func sumTo(n) {
+    return sumTo_1(n, 0);
+}
+func main() {
+    var n = read();
+    print(fact(n));
+    print(sumTo(n));
+}
+)");
+}
+
+static const char* const mixedCombinationProgram = R"(
+func mixed(n) {
+    if (n <= 0) return 1;
+    if (n > 3) return mixed(n - 1) + n;
+    return mixed(n - 1) * 2;
+}
+
+func main() {
+    print(mixed(read()));
+}
+)";
+
+TEST(linearRecursionEliminator, mixedCombinationsAreKept) {
+    const auto options = withOptimizer(std::make_shared<LinearRecursionEliminator>(FP_FAST));
+    ASSERT_SAME_OUTPUT(mixedCombinationProgram, "5", options, "17\n");
+
+    const auto root = optimizeProgram(mixedCombinationProgram, options);
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(mixedCombinationProgram, withoutOptimizations())));
+}
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @brief Tests for loop-invariant code motion
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/loop-invariant-code-motion.h"
+
+static const char* const invariantProgram = R"(
+func main() {
+    var n = read();
+    var d = read();
+    var i = 0;
+    var x = 0;
+    while (i < n * 2) {
+        x = x + sqrt(d) * i;
+        i = i + 1;
+    }
+    print(x);
+}
+)";
+
+TEST(loopInvariantCodeMotion, invariantExpressionsAreHoisted) {
+    ASSERT_SAME_OUTPUT(invariantProgram, "3 16", withOptimizer(std::make_shared<LoopInvariantCodeMotion>()), "60\n");
+    ASSERT_SAME_OUTPUT(invariantProgram, "0 16", withOptimizer(std::make_shared<LoopInvariantCodeMotion>()), "0\n");
+
+    const auto root = optimizeProgram(invariantProgram, withOptimizer(std::make_shared<LoopInvariantCodeMotion>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var n = read();
+    var d = read();
+    var i = 0;
+    var x = 0;
+    var invariant.1 = n * 2;
+    var invariant.2 = sqrt(d);
+    while (i < invariant.1) {
+        x = x + invariant.2 * i;
+        i = i + 1;
+    }
+    print(x);
+}
+)");
+}
+
+static const char* const variantProgram = R"(
+func main() {
+    var n = read();
+    var i = 0;
+    while (i < 3) {
+        print(n * 2 + read());
+        n = n + 1;
+        i = i + 1;
+    }
+}
+)";
+
+TEST(loopInvariantCodeMotion, changedVariablesAndReadsAreNotHoisted) {
+    ASSERT_SAME_OUTPUT(variantProgram, "1 10 20 30", withOptimizer(std::make_shared<LoopInvariantCodeMotion>()), "12\n24\n36\n");
+
+    const auto root = optimizeProgram(variantProgram, withOptimizer(std::make_shared<LoopInvariantCodeMotion>()));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(variantProgram, withoutOptimizations())));
+}
@@ -0,0 +1,197 @@
+/**
+ * @file
+ * @brief Tests for loop analysis and loop unroller
+ */
+#include <cstring>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/loop-analysis.h"
+#include "../../src/middleend/loop-unroller.h"
+
+static const char* const constantTripCountProgram = R"(
+func main() {
+    var x = read();
+    var i = 0;
+    while (i < 3) {
+        x = x + i;
+        i = i + 1;
+    }
+    print(x);
+    print(i);
+}
+)";
+
+TEST(loopAnalysis, counterIsFound) {
+    const auto root = optimizeProgram(constantTripCountProgram, withoutOptimizations());
+    LoopCounter counter;
+    ASSERT_TRUE(findLoopCounter(findNode(root, WHILE_NODE), counter));
+    ASSERT_TRUE(strcmp(counter.name, "i") == 0);
+    ASSERT_DOUBLE_EQUALS(counter.getStep(), 1);
+    ASSERT_EQUALS(counter.comparison, LESS);
+    ASSERT_TRUE(isMonotonicCounter(counter));
+}
+
+TEST(loopUnroller, loopWithConstantTripCountIsFullyUnrolled) {
+    ASSERT_SAME_OUTPUT(constantTripCountProgram, "10", withOptimizer(std::make_shared<LoopUnroller>()), "13\n3\n");
+
+    const auto root = optimizeProgram(constantTripCountProgram, withOptimizer(std::make_shared<LoopUnroller>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var x = read();
+    var i = 0;
+    {
+        {
+            x = x + i;
+            i = i + 1;
+        }
+        {
+            x = x + i;
+            i = i + 1;
+        }
+        {
+            x = x + i;
+            i = i + 1;
+        }
+    }
+    print(x);
+    print(i);
+}
+)");
+}
+
+static const char* const unknownTripCountProgram = R"(
+func main() {
+    var n = read();
+    var x = 0;
+    var i = 0;
+    while (i < n) {
+        x = x + i * i;
+        i = i + 1;
+    }
+    print(x);
+    var j = n;
+    while (j > 0) {
+        x = x - j;
+        j = j - 2;
+    }
+    print(x);
+    print(j);
+}
+)";
+
+TEST(loopUnroller, loopWithUnknownTripCountIsPartiallyUnrolled) {
+    // Trip counts, that are not divisible by the unroll factor, are handled by the remainder loop
+    for (const char* input : { "0", "1", "7", "8", "13" }) {
+        const std::string expected = compileAndRun(unknownTripCountProgram, input, withoutOptimizations());
+        ASSERT_EQUALS(compileAndRun(unknownTripCountProgram, input, withOptimizer(std::make_shared<LoopUnroller>())), expected);
+    }
+    ASSERT_EQUALS(compileAndRun(unknownTripCountProgram, "7", withoutOptimizations()), "91\n75\n-1\n");
+
+    const auto root = optimizeProgram(unknownTripCountProgram, withOptimizer(std::make_shared<LoopUnroller>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "main")),
+R"(func main() {
+    var n = read();
+    var x = 0;
+    var i = 0;
+    while (i + 7 < n) {
+        {
+            x = x + i * i;
+            i = i + 1;
+        }
+        {
+            x = x + i * i;
+            i = i + 1;
+        }
+        {
+            x = x + i * i;
+            i = i + 1;
+        }
+        {
+            x = x + i * i;
+            i = i + 1;
+        }
+        {
+            x = x + i * i;
+            i = i + 1;
+        }
+        {
+            x = x + i * i;
+            i = i + 1;
+        }
+        {
+            x = x + i * i;
+            i = i + 1;
+        }
+        {
+            x = x + i * i;
+            i = i + 1;
+        }
+    }
+    while (i < n) {
+        x = x + i * i;
+        i = i + 1;
+    }
+    print(x);
+    var j = n;
+    while (j - 14 > 0) {
+        {
+            x = x - j;
+            j = j - 2;
+        }
+        {
+            x = x - j;
+            j = j - 2;
+        }
+        {
+            x = x - j;
+            j = j - 2;
+        }
+        {
+            x = x - j;
+            j = j - 2;
+        }
+        {
+            x = x - j;
+            j = j - 2;
+        }
+        {
+            x = x - j;
+            j = j - 2;
+        }
+        {
+            x = x - j;
+            j = j - 2;
+        }
+        {
+            x = x - j;
+            j = j - 2;
+        }
+    }
+    while (j > 0) {
+        x = x - j;
+        j = j - 2;
+    }
+    print(x);
+    print(j);
+}
+)");
+}
+
+static const char* const notCounterProgram = R"(
+func main() {
+    var i = read();
+    while (i < 100) {
+        i = i * 2;
+    }
+    print(i);
+}
+)";
+
+TEST(loopUnroller, loopWithoutCounterIsKept) {
+    ASSERT_SAME_OUTPUT(notCounterProgram, "3", withOptimizer(std::make_shared<LoopUnroller>()), "192\n");
+
+    const auto root = optimizeProgram(notCounterProgram, withOptimizer(std::make_shared<LoopUnroller>()));
+    LoopCounter counter;
+    ASSERT_TRUE(!findLoopCounter(findNode(root, WHILE_NODE), counter));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(notCounterProgram, withoutOptimizations())));
+}
@@ -0,0 +1,110 @@
+/**
+ * @file
+ * @brief Tests for optimization levels and pass pipelines
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+
+static const char* const mixedProgram = R"(
+func square(x) {
+    return x * x;
+}
+
+func sumSquares(n) {
+    var sum = 0;
+    var i = 0;
+    while (i < n) {
+        sum = sum + square(i) + 2 * 3;
+        i = i + 1;
+    }
+    return sum;
+}
+
+func countDown(n, acc) {
+    if (n <= 0) return acc;
+    return countDown(n - 1, acc + -(-n));
+}
+
+func main() {
+    var n = read();
+    var unused = n * 2;
+    print(sumSquares(n));
+    print(sumSquares(4));
+    print(countDown(n, 0));
+    if (0 > 1) print(100);
+}
+)";
+
+static const char* const mixedProgramOutput = "258\n38\n45\n";
+
+TEST(passPipeline, allLevelsKeepOutput) {
+    ASSERT_SAME_OUTPUT(mixedProgram, "9", withLevel(O1), mixedProgramOutput);
+    ASSERT_SAME_OUTPUT(mixedProgram, "9", withLevel(O2), mixedProgramOutput);
+    ASSERT_SAME_OUTPUT(mixedProgram, "9", withLevel(O3), mixedProgramOutput);
+}
+
+TEST(passPipeline, eachPassAloneKeepsOutput) {
+    for (const char* name : getPassNames()) {
+        ASSERT_SAME_OUTPUT(mixedProgram, "9", withPasses(name), mixedProgramOutput);
+    }
+}
+
+TEST(passPipeline, levelsApplyTheirPasses) {
+    // O1 only simplifies expressions and removes unreachable code, calls are kept
+    ASSERT_EQUALS(printCode(optimizeProgram(mixedProgram, withLevel(O1))),
+R"(func square(x) {
+    return x * x;
+}
+func sumSquares(n) {
+    var sum = 0;
+    var i = 0;
+    while (i < n) {
+        sum = sum + square(i) + 6;
+        i = i + 1;
+    }
+    return sum;
+}
+func countDown(n, acc) {
+    if (n <= 0) {
+        return acc;
+    }
+    return countDown(n - 1, acc + n);
+}
+func main() {
+    var n = read();
+    print(sumSquares(n));
+    print(sumSquares(4));
+    print(countDown(n, 0));
+}
+)");
+
+    // O2 inlines 'square' and replaces tail recursion of 'countDown' with the loop
+    const auto full = optimizeProgram(mixedProgram, withLevel(O2));
+    ASSERT_EQUALS(countCalls(full, "square"), 0);
+    ASSERT_EQUALS(printCode(findFunction(full, "countDown")),
+R"(func countDown(n, acc) {
+    while (0 < 1) {
+        if (n <= 0) {
+            return acc;
+        }
+        {
+            acc = acc + n;
+            n = n - 1;
+        }
+    }
+}
+)");
+}
+
+TEST(passPipeline, passNamesAreParsed) {
+    const PipelineOptions options = { FP_STRICT, nullptr };
+    ASSERT_TRUE(buildPipeline("", options) != nullptr);
+    ASSERT_TRUE(buildPipeline("dead-code-eliminator", options) != nullptr);
+    ASSERT_TRUE(buildPipeline("function-inliner,dead-code-eliminator,function-inliner", options) != nullptr);
+    ASSERT_TRUE(buildPipeline("function-inliner,no-such-pass", options) == nullptr);
+    ASSERT_TRUE(buildPipeline("function-inliner,", options) != nullptr);
+
+    for (const char* name : getPassNames()) {
+        ASSERT_TRUE(buildPipeline(name, options) != nullptr);
+    }
+}
@@ -0,0 +1,378 @@
+/**
+ * @file
+ * @brief Tests for profile collection by the profiling interpreter
+ *
+ * Profile is collected by the compiler's interpreter instead of the stack machine, so these tests check, that the
+ * interpreter prints the same as the compiled program and that the collected counts are the ones, the compiled program
+ * computes itself.
+ */
+#include <cassert>
+#include <cstdio>
+#include <unistd.h>
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/branch-layout-optimizer.h"
+#include "../../src/middleend/function-inliner.h"
+#include "../../src/middleend/profile.h"
+
+/**
+ * Collects profile of the program with the given input.
+ * @return output of the profiled program, then "profile" line and the lines printed by printCounts for the collected profile.
+ */
+static std::string runProfiled(const char* code, const char* input, const std::function<void(const Profile&)>& printCounts) {
+    const auto root = optimizeProgram(code, withoutOptimizations());
+    return runWithInput([&root, &printCounts]() {
+        const auto profile = collectProfile(root);
+        if (profile == nullptr) return 1;
+
+        printf("profile\n");
+        printCounts(*profile);
+        return 0;
+    }, input);
+}
+
+// Function returns the number of its own calls
+static const char* const callsProgram = R"(
+func calls(n) {
+    if (n <= 2) return 1;
+    return 1 + calls(n - 1) + calls(n - 2);
+}
+
+func main() {
+    print(calls(read()));
+}
+)";
+
+TEST(profile, callsNumberMatchesCompiledProgram) {
+    const std::string output = compileAndRun(callsProgram, "10", withoutOptimizations());
+    ASSERT_EQUALS(output, std::string("109\n"));
+
+    const auto root = optimizeProgram(callsProgram, withoutOptimizations());
+    const auto branchStatement = findNode(root, IF_NODE);
+    const std::string profiledOutput = runProfiled(callsProgram, "10", [&branchStatement](const Profile& profile) {
+        BranchProfile branch = { LESS, 0, 0 };
+        printf("%zu\n", profile.getFunction("calls")->callsNumber);
+        if (profile.getBranch(branchStatement.get(), branch)) printf("%zu %zu\n", branch.takenNumber, branch.notTakenNumber);
+    });
+    // Each call, that isn't a leaf, makes two more calls
+    ASSERT_EQUALS(profiledOutput, output + "profile\n109\n55 54\n");
+}
+
+// Program prints the trip count of the loop and the number of times the branch is taken
+static const char* const loopProgram = R"(
+func main() {
+    var n = read();
+    var i = 0;
+    var taken = 0;
+    while (i < n) {
+        if (i > 2) taken = taken + 1;
+        i = i + 1;
+    }
+    print(i);
+    print(taken);
+}
+)";
+
+TEST(profile, branchAndLoopCountsMatchCompiledProgram) {
+    const std::string output = compileAndRun(loopProgram, "10", withoutOptimizations());
+    ASSERT_EQUALS(output, std::string("10\n7\n"));
+
+    const auto root = optimizeProgram(loopProgram, withoutOptimizations());
+    const auto branchStatement = findNode(root, IF_NODE);
+    const TokenOrigin loopPos = findNode(root, WHILE_NODE)->getOriginPos();
+    const std::string profiledOutput = runProfiled(loopProgram, "10", [&branchStatement, loopPos](const Profile& profile) {
+        BranchProfile branch = { LESS, 0, 0 };
+        const LoopProfile* loop = profile.getLoop(loopPos);
+        printf("%zu %zu\n", loop->getExecutionsNumber(), loop->tripCountHistogram[LoopProfile::getBucket(10)]);
+        if (profile.getBranch(branchStatement.get(), branch)) printf("%zu %zu\n", branch.takenNumber, branch.notTakenNumber);
+    });
+    ASSERT_EQUALS(profiledOutput, output + "profile\n1 1\n7 3\n");
+}
+
+static const char* const readingProgram = R"(
+func main() {
+    var x = read();
+    while (x > 0) {
+        print(x * 3 / 7);
+        x = read();
+    }
+    print(0 - 0);
+    print(1 / 0);
+    print(sqrt(2));
+}
+)";
+
+TEST(profile, interpreterPrintsSameAsCompiledProgram) {
+    const std::string output = compileAndRun(readingProgram, "5 0.5 1e20 0", withoutOptimizations());
+    const std::string profiledOutput = runProfiled(readingProgram, "5 0.5 1e20 0", [](const Profile&) { });
+    ASSERT_EQUALS(profiledOutput, output + "profile\n");
+}
+
+/**
+ * Collects profile of the program with the given input, like '--profile-generate' does.
+ * Profile is collected in the child process (see runWithInput), so it's passed back through the profile file.
+ * @return profile or nullptr, if it wasn't collected.
+ */
+static std::shared_ptr<const Profile> generateProfile(const char* code, const char* input) {
+    char profileFileName[] = "/tmp/compiler-test-XXXXXX";
+    const int profileFile = mkstemp(profileFileName);
+    assert(profileFile >= 0);
+    close(profileFile);
+
+    const auto root = optimizeProgram(code, withoutOptimizations());
+    runWithInput([&root, &profileFileName]() {
+        const auto profile = collectProfile(root);
+        FILE* file = fopen(profileFileName, "w");
+        if (profile == nullptr || file == nullptr) return 1;
+        profile->dump(file);
+        return fclose(file);
+    }, input);
+
+    auto profile = std::make_shared<Profile>();
+    FILE* file = fopen(profileFileName, "r");
+    const bool isLoaded = file != nullptr && profile->load(file);
+    if (file != nullptr) fclose(file);
+    remove(profileFileName);
+    return isLoaded ? profile : nullptr;
+}
+
+static const char* const skewedBranchProgram = R"(
+func main() {
+    var x = read();
+    var sum = 0;
+    while (x > 0) {
+        if (x < 100) {
+            sum = sum + x;
+        } else {
+            sum = sum - x * 2;
+        }
+        x = read();
+    }
+    print(sum);
+}
+)";
+
+static const char* const skewedBranchInput = "1 2 3 4 5 6 7 500 8 9 0";
+
+TEST(profile, hotBranchIsMovedToElse) {
+    const auto profile = generateProfile(skewedBranchProgram, skewedBranchInput);
+    ASSERT_TRUE(profile != nullptr);
+    const auto options = withOptimizer(std::make_shared<BranchLayoutOptimizer>(profile));
+    ASSERT_SAME_OUTPUT(skewedBranchProgram, skewedBranchInput, options, "-955\n");
+
+    // The hot branch (sum + x) doesn't jump over the cold one
+    ASSERT_EQUALS(printCode(findFunction(optimizeProgram(skewedBranchProgram, options), "main")),
+R"(func main() {
+    var x = read();
+    var sum = 0;
+    while (x > 0) {
+        if (x >= 100) {
+            sum = sum - x * 2;
+        } else {
+            sum = sum + x;
+        }
+        x = read();
+    }
+    print(sum);
+}
+)");
+}
+
+// Both branches are hot: the first one is unrolled, the second one is inlined
+static const char* const duplicatedBranchProgram = R"(
+func weigh(x) {
+    if (x < 100) {
+        return x;
+    } else {
+        return 0 - x * 2;
+    }
+}
+
+func main() {
+    var x = read();
+    var sum = 0;
+    var i = 0;
+    while (i < 2) {
+        if (x < 100) {
+            sum = sum + x;
+        } else {
+            sum = sum - x;
+        }
+        i = i + 1;
+    }
+    while (x > 0) {
+        sum = sum + weigh(x);
+        x = read();
+    }
+    print(sum);
+}
+)";
+
+TEST(profile, copiesOfBranchesKeepTheirCounts) {
+    const auto profile = generateProfile(duplicatedBranchProgram, skewedBranchInput);
+    ASSERT_TRUE(profile != nullptr);
+    const auto options = withProfile(withPasses("function-inliner,loop-unroller,branch-layout-optimizer"), profile);
+    ASSERT_SAME_OUTPUT(duplicatedBranchProgram, skewedBranchInput, options, "-953\n");
+
+    // Every copy of the hot branch is moved to else
+    const std::string optimizedCode = printCode(findFunction(optimizeProgram(duplicatedBranchProgram, options), "main"));
+    ASSERT_EQUALS(optimizedCode,
+R"(func main() {
+    var x = read();
+    var sum = 0;
+    var i = 0;
+    {
+        {
+            if (x >= 100) {
+                sum = sum - x;
+            } else {
+                sum = sum + x;
+            }
+            i = i + 1;
+        }
+        {
+            if (x >= 100) {
+                sum = sum - x;
+            } else {
+                sum = sum + x;
+            }
+            i = i + 1;
+        }
+    }
+    while (x > 0) {
+        var result.1;
+        {
+            if (x >= 100) {
+                {
+                    result.1 = 0 - x * 2;
+                }
+            } else {
+                {
+                    result.1 = x;
+                }
+            }
+        }
+        sum = sum + result.1;
+        x = read();
+    }
+    print(sum);
+}
+)");
+
+    // Branches, that were moved before the duplication, are copied with the negated conditions and aren't moved back
+    const auto earlyLayoutOptions = withProfile(withPasses("branch-layout-optimizer,function-inliner,loop-unroller,branch-layout-optimizer"), profile);
+    ASSERT_EQUALS(printCode(findFunction(optimizeProgram(duplicatedBranchProgram, earlyLayoutOptions), "main")), optimizedCode);
+}
+
+static const char* const coldCallProgram = R"(
+func report(x) {
+    print(x);
+    return x * 2;
+}
+
+func main() {
+    var x = read();
+    if (x < 0) {
+        print(report(x));
+        print(report(x - 1));
+    }
+    print(x);
+}
+)";
+
+TEST(profile, neverCalledFunctionsAreNotInlined) {
+    const auto profile = generateProfile(coldCallProgram, "1");
+    ASSERT_TRUE(profile != nullptr);
+    ASSERT_TRUE(profile->isColdFunction("report"));
+    const auto options = withOptimizer(std::make_shared<FunctionInliner>(profile));
+    ASSERT_SAME_OUTPUT(coldCallProgram, "-1", options, "-1\n-2\n-2\n-4\n-1\n");
+
+    ASSERT_EQUALS(printCode(findFunction(optimizeProgram(coldCallProgram, withOptimizer(std::make_shared<FunctionInliner>())), "main")),
+R"(func main() {
+    var x = read();
+    if (x < 0) {
+        var result.1;
+        {
+            print(x);
+            result.1 = x * 2;
+        }
+        print(result.1);
+        var result.2;
+        {
+            var x.1 = x - 1;
+            print(x.1);
+            result.2 = x.1 * 2;
+        }
+        print(result.2);
+    }
+    print(x);
+}
+)");
+    ASSERT_EQUALS(printCode(findFunction(optimizeProgram(coldCallProgram, options), "main")),
+R"(func main() {
+    var x = read();
+    if (x < 0) {
+        print(report(x));
+        print(report(x - 1));
+    }
+    print(x);
+}
+)");
+}
+
+static const char* const repeatedCallsProgram = R"(
+func fib(n) {
+    if (n <= 2) return 1;
+    return fib(n - 1) + fib(n - 2);
+}
+
+func sumTo(n) {
+    if (n <= 0) return 0;
+    return n + sumTo(n - 1);
+}
+
+func main() {
+    var n = read();
+    print(fib(n));
+    print(sumTo(n));
+}
+)";
+
+TEST(profile, onlyRepeatedlyCalledFunctionsAreMemoized) {
+    const auto profile = generateProfile(repeatedCallsProgram, "15");
+    ASSERT_TRUE(profile != nullptr);
+    ASSERT_TRUE(profile->isMemoizationProfitable("fib"));
+    ASSERT_TRUE(!profile->isMemoizationProfitable("sumTo"));
+    ASSERT_SAME_OUTPUT(repeatedCallsProgram, "15", withProfile(withoutOptimizations(), profile), "610\n120\n");
+
+    // Each call of fib repeats the previous ones, while sumTo is called with the new arguments, so only fib is memoized
+    const size_t lookupsNumber = countInstructions(compileProgram(repeatedCallsProgram, withProfile(withoutOptimizations(), profile)), IR_POP_REG, DX);
+    const size_t allLookupsNumber = countInstructions(compileProgram(repeatedCallsProgram, withMemoization(withoutOptimizations())), IR_POP_REG, DX);
+    ASSERT_TRUE(lookupsNumber > 0);
+    ASSERT_EQUALS(lookupsNumber * 2, allLookupsNumber);
+}
+
+static const char* const deepCallProgram = R"(
+func fib(n) {
+    if (n <= 2) return 1;
+    return fib(n - 1) + fib(n - 2);
+}
+
+func fill(value, depth) {
+    if (depth <= 0) return value;
+    return fill(value, depth - 1);
+}
+
+func main() {
+    print(fib(read()));
+    print(fill(20, read()));
+    print(fib(20));
+}
+)";
+
+TEST(profile, memoizedFunctionsKeepTablesAfterDeepCalls) {
+    const auto profile = generateProfile(deepCallProgram, "15 63");
+    ASSERT_TRUE(profile != nullptr);
+    ASSERT_TRUE(profile->isMemoizationProfitable("fib"));
+    ASSERT_SAME_OUTPUT(deepCallProgram, "15 63", withProfile(withoutOptimizations(), profile), "610\n20\n6765\n");
+}
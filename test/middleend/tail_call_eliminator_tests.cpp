@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @brief Tests for tail call eliminator
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/tail-call-eliminator.h"
+
+static const char* const tailCallsProgram = R"(
+func sumDown(n, acc) {
+    if (n <= 0) return acc;
+    return sumDown(n - 1, acc + n);
+}
+
+func rotate(a, b, k) {
+    if (k <= 0) {
+        print(a);
+        return b;
+    }
+    print(k);
+    return rotate(b, a, k - 1);
+}
+
+func main() {
+    print(sumDown(read(), 0));
+    print(rotate(1, 2, 3));
+}
+)";
+
+TEST(tailCallEliminator, selfTailCallsBecomeLoops) {
+    ASSERT_SAME_OUTPUT(tailCallsProgram, "100", withOptimizer(std::make_shared<TailCallEliminator>()), "5050\n3\n2\n1\n2\n1\n");
+
+    const auto root = optimizeProgram(tailCallsProgram, withOptimizer(std::make_shared<TailCallEliminator>()));
+    ASSERT_EQUALS(printCode(findFunction(root, "sumDown")),
+R"(func sumDown(n, acc) {
+    while (0 < 1) {
+        if (n <= 0) {
+            return acc;
+        }
+        {
+            acc = acc + n;
+            n = n - 1;
+        }
+    }
+}
+)");
+    // Arguments are evaluated before the parameters are assigned, so swapped parameters get the old values
+    ASSERT_EQUALS(printCode(findFunction(root, "rotate")),
+R"(func rotate(a, b, k) {
+    while (0 < 1) {
+        if (k <= 0) {
+            print(a);
+            return b;
+        }
+        print(k);
+        {
+            var b.1 = a;
+            var a.1 = b;
+            k = k - 1;
+            b = b.1;
+            a = a.1;
+        }
+    }
+}
+)");
+}
+
+static const char* const notTailCallProgram = R"(
+func fact(n) {
+    if (n <= 1) return 1;
+    return n * fact(n - 1);
+}
+
+func main() {
+    print(fact(read()));
+}
+)";
+
+TEST(tailCallEliminator, notTailCallsAreKept) {
+    ASSERT_SAME_OUTPUT(notTailCallProgram, "5", withOptimizer(std::make_shared<TailCallEliminator>()), "120\n");
+
+    const auto root = optimizeProgram(notTailCallProgram, withOptimizer(std::make_shared<TailCallEliminator>()));
+    ASSERT_EQUALS(printCode(root), printCode(optimizeProgram(notTailCallProgram, withoutOptimizations())));
+}
@@ -0,0 +1,187 @@
+/**
+ * @file
+ * @brief Tests for value range analysis and value range optimizer
+ */
+#include "../testlib.h"
+#include "../program-runner.h"
+#include "../../src/middleend/value-range-analysis.h"
+
+static const char* const redundantChecksProgram = R"(
+func describe(a) {
+    if (a == 0) {
+        return 0;
+    }
+    if (a != 0) {
+        print(1 / a);
+    }
+    return 1;
+}
+
+func main() {
+    var n = read();
+    var i = 0;
+    var positive = 0;
+    while (i < n) {
+        if (i >= 0) positive = positive + 1;
+        i = i + 1;
+    }
+    var j = 5;
+    while (j < 0) {
+        j = j + 1;
+    }
+    print(positive);
+    print(j);
+    describe(0);
+    describe(4);
+}
+)";
+
+TEST(valueRangeOptimizer, redundantConditionsAreRemoved) {
+    ASSERT_SAME_OUTPUT(redundantChecksProgram, "3", withPasses("value-range-optimizer"), "3\n5\n0.25\n");
+    ASSERT_SAME_OUTPUT(redundantChecksProgram, "3", withLevel(O2), "3\n5\n0.25\n");
+
+    // Only 'a == 0' check and 'i < n' loop are left
+    ASSERT_EQUALS(printCode(optimizeProgram(redundantChecksProgram, withPasses("value-range-optimizer"))),
+R"(func describe(a) {
+    if (a == 0) {
+        return 0;
+    }
+    {
+        print(1 / a);
+    }
+    return 1;
+}
+func main() {
+    var n = read();
+    var i = 0;
+    var positive = 0;
+    while (i < n) {
+        {
+            positive = positive + 1;
+        }
+        i = i + 1;
+    }
+    var j = 5;
+    print(positive);
+    print(j);
+    describe(0);
+    describe(4);
+}
+)");
+}
+
+static const char* const specialValuesProgram = R"(
+func main() {
+    var x = read();
+    var y = x * 0;
+    if (y == 0) print(1);
+    if (y != y) print(2);
+    var z = x;
+    if (z < 0) z = 0 - z;
+    if (z >= 0) print(3);
+    if (z < 0) print(4);
+}
+)";
+
+TEST(valueRangeOptimizer, NaNAndInfinitiesAreTracked) {
+    // x * 0 is zero or NaN (for infinite x), z isn't negative or NaN, and any condition with NaN is true,
+    // so only `y != y` and the second 'z < 0' are left
+    ASSERT_EQUALS(printCode(optimizeProgram(specialValuesProgram, withPasses("value-range-optimizer"))),
+R"(func main() {
+    var x = read();
+    var y = x * 0;
+    {
+        print(1);
+    }
+    if (y != y) {
+        print(2);
+    }
+    var z = x;
+    if (z < 0) {
+        z = 0 - z;
+    }
+    {
+        print(3);
+    }
+    if (z < 0) {
+        print(4);
+    }
+}
+)");
+    ASSERT_SAME_OUTPUT(specialValuesProgram, "7", withPasses("value-range-optimizer"), "1\n3\n");
+    ASSERT_SAME_OUTPUT(specialValuesProgram, "nan", withPasses("value-range-optimizer"), "1\n2\n3\n4\n");
+    ASSERT_SAME_OUTPUT(specialValuesProgram, "-inf", withPasses("value-range-optimizer"), "1\n2\n3\n");
+}
+
+static const char* const closeValuesProgram = R"(
+func main() {
+    var x = read();
+    var zero = 0;
+    if (zero == 0.0000000001) print(1);
+    if (zero < 0.0000000001) print(2);
+    if (zero > 0.0000000001) print(3);
+    if (x < 0) x = 0;
+    if (x >= 0) print(4);
+    if (x < 0) print(5);
+}
+)";
+
+TEST(valueRangeOptimizer, closeValuesAreEqualOnlyForEqualityComparisons) {
+    // 0 is equal to 1e-10 with COMPARE_EPS precision, but it's less than 1e-10 too. NaN x is replaced by 0, so x is at least 0
+    ASSERT_EQUALS(printCode(findFunction(optimizeProgram(closeValuesProgram, withPasses("value-range-optimizer")), "main")),
+R"(func main() {
+    var x = read();
+    var zero = 0;
+    {
+        print(1);
+    }
+    {
+        print(2);
+    }
+    if (x < 0) {
+        x = 0;
+    }
+    {
+        print(4);
+    }
+}
+)");
+    ASSERT_SAME_OUTPUT(closeValuesProgram, "-1", withPasses("value-range-optimizer"), "1\n2\n4\n");
+    ASSERT_SAME_OUTPUT(closeValuesProgram, "nan", withPasses("value-range-optimizer"), "1\n2\n4\n");
+
+    // Dead code eliminator and peephole optimizer evaluate the constant conditions by the same rules
+    ASSERT_SAME_OUTPUT(closeValuesProgram, "-1", withLevel(O2), "1\n2\n4\n");
+    ASSERT_SAME_OUTPUT(closeValuesProgram, "nan", withLevel(O2), "1\n2\n4\n");
+}
+
+static const char* const loopProgram = R"(
+func main() {
+    var n = read();
+    var i = 2;
+    var step = 3;
+    if (n > 10) step = 4;
+    while (i < n) {
+        i = i + step;
+    }
+    print(i);
+}
+)";
+
+TEST(valueRangeAnalysis, rangesBeforeLoop) {
+    const auto root = optimizeProgram(loopProgram, withoutOptimizations());
+    const auto loop = findNode(root, WHILE_NODE);
+    const ValueRangeAnalysis analysis(findNode(root, FUNCTION_DEFINITION_NODE));
+
+    double value = 0;
+    ASSERT_TRUE(analysis.getRangeBeforeLoop(loop.get(), "i").isConstant(value));
+    ASSERT_DOUBLE_EQUALS(value, 2);
+
+    const ValueRange step = analysis.getRangeBeforeLoop(loop.get(), "step");
+    ASSERT_TRUE(!step.isConstant(value));
+    ASSERT_DOUBLE_EQUALS(step.min, 3);
+    ASSERT_DOUBLE_EQUALS(step.max, 4);
+    ASSERT_TRUE(!step.mayBeNaN);
+
+    const ConditionOutcome outcome = analysis.getConditionOutcome(loop.get());
+    ASSERT_TRUE(outcome.canBeTrue && outcome.canBeFalse);
+}
@@ -0,0 +1,347 @@
+/**
+ * @file
+ * @brief Implementation of helpers for the end-to-end tests
+ */
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <wait.h>
+#include "program-runner.h"
+#include "../src/backend/bytecode-writer.h"
+#include "../src/backend/codegen.h"
+#include "../src/backend/frame-access-lowering.h"
+#include "../src/backend/peephole-optimizer.h"
+#include "../src/backend/register-allocator.h"
+#include "../src/frontend/recursive_parser.h"
+#include "../src/middleend/effect-analysis.h"
+#include "../src/stack-machine/src/stack-machine.h"
+
+CompilationOptions withoutOptimizations() {
+    return CompilationOptions();
+}
+
+CompilationOptions withLevel(OptimizationLevel level) {
+    CompilationOptions options;
+    options.optimizationLevel = level;
+    return options;
+}
+
+CompilationOptions withPasses(const char* passNames) {
+    CompilationOptions options;
+    options.passNames = passNames;
+    return options;
+}
+
+CompilationOptions withOptimizer(const std::shared_ptr<Optimizer>& optimizer) {
+    CompilationOptions options;
+    options.optimizer = optimizer;
+    return options;
+}
+
+CompilationOptions withMemoization(CompilationOptions options) {
+    options.memoize = true;
+    return options;
+}
+
+CompilationOptions withProfile(CompilationOptions options, const std::shared_ptr<const Profile>& profile) {
+    options.profile = profile;
+    return options;
+}
+
+std::shared_ptr<ASTNode> optimizeProgram(const char* code, const CompilationOptions& options) {
+    std::vector<char> text(code, code + strlen(code) + 1);
+    std::shared_ptr<ASTNode> root = buildASTRecursively(text.data());
+    if (options.optimizer != nullptr) return options.optimizer->optimize(root);
+
+    const PipelineOptions pipelineOptions = { options.fpMode, options.profile };
+    const auto optimizer = (options.passNames != nullptr) ? buildPipeline(options.passNames, pipelineOptions) :
+                                                            buildPipeline(options.optimizationLevel, pipelineOptions);
+    assert(optimizer != nullptr);
+    return optimizer->optimize(root);
+}
+
+IRProgram compileProgram(const char* code, const CompilationOptions& options) {
+    const std::shared_ptr<ASTNode> root = optimizeProgram(code, options);
+
+    std::vector<const char*> memoizedFunctions;
+    if (options.memoize || options.profile != nullptr) {
+        for (const char* name : EffectAnalysis(root).getMemoizableFunctions()) {
+            if (options.profile == nullptr || options.profile->isMemoizationProfitable(name)) memoizedFunctions.push_back(name);
+        }
+    }
+    IRProgram program = codegen(root, memoizedFunctions, options.optimizationLevel != O0);
+    if (options.optimizationLevel != O0) {
+        allocateRegisters(program);
+        PeepholeOptimizer().optimize(program);
+    }
+    lowerFrameAccesses(program);
+    return program;
+}
+
+static std::string makeTemporaryFile() {
+    char fileName[] = "/tmp/compiler-test-XXXXXX";
+    const int file = mkstemp(fileName);
+    assert(file >= 0);
+    close(file);
+    return fileName;
+}
+
+std::string runWithInput(const std::function<int()>& action, const char* input) {
+    FILE* inputFile = tmpfile();
+    FILE* outputFile = tmpfile();
+    assert(inputFile != nullptr && outputFile != nullptr);
+    fputs(input, inputFile);
+    fflush(inputFile);
+    rewind(inputFile);
+
+    // Buffered output of the tests would be written twice otherwise
+    fflush(stdout);
+    const pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        dup2(fileno(inputFile), STDIN_FILENO);
+        dup2(fileno(outputFile), STDOUT_FILENO);
+        const int exitCode = action();
+        fflush(stdout);
+        _exit(exitCode & 0xFF);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    std::string output;
+    rewind(outputFile);
+    for (int c = fgetc(outputFile); c != EOF; c = fgetc(outputFile)) {
+        output.push_back((char) c);
+    }
+    const int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    if (exitCode != 0) output += "exit code " + std::to_string(exitCode) + "\n";
+
+    fclose(inputFile);
+    fclose(outputFile);
+    return output;
+}
+
+std::string compileAndRun(const char* code, const char* input, const CompilationOptions& options) {
+    const IRProgram program = compileProgram(code, options);
+    const std::string bytecodeFileName = makeTemporaryFile();
+
+    const int writingExitCode = writeBytecode(program, bytecodeFileName.c_str());
+    const std::string output = (writingExitCode != 0) ? "exit code " + std::to_string(writingExitCode) + "\n" :
+                               runWithInput([&bytecodeFileName]() { return run(bytecodeFileName.c_str()); }, input);
+    remove(bytecodeFileName.c_str());
+    return output;
+}
+
+size_t countInstructions(const IRProgram& program, IROpcode opcode) {
+    size_t count = 0;
+    for (const Instruction& instruction : program.getInstructions()) {
+        if (instruction.opcode == opcode) ++count;
+    }
+    return count;
+}
+
+size_t countInstructions(const IRProgram& program, IROpcode opcode, Register reg) {
+    size_t count = 0;
+    for (const Instruction& instruction : program.getInstructions()) {
+        if (instruction.opcode == opcode && instruction.reg == reg) ++count;
+    }
+    return count;
+}
+
+size_t countNodes(const std::shared_ptr<ASTNode>& node, NodeType type) {
+    size_t count = node->getType() == type ? 1 : 0;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        count += countNodes(node->getChildren()[i], type);
+    }
+    return count;
+}
+
+std::shared_ptr<ASTNode> findNode(const std::shared_ptr<ASTNode>& node, NodeType type) {
+    if (node->getType() == type) return node;
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        auto found = findNode(node->getChildren()[i], type);
+        if (found != nullptr) return found;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<ASTNode> findFunction(const std::shared_ptr<ASTNode>& root, const char* functionName) {
+    const size_t childrenNumber = root->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        const auto& child = root->getChildren()[i];
+        if (child->getType() != FUNCTION_DEFINITION_NODE) continue;
+        const auto function = dynamic_cast<const FunctionDefinitionNode*>(child.get());
+        if (strcmp(function->getFunctionName()->getName(), functionName) == 0) return child;
+    }
+    return nullptr;
+}
+
+size_t countCalls(const std::shared_ptr<ASTNode>& node, const char* functionName) {
+    size_t count = 0;
+    if (node->getType() == FUNCTION_CALL_NODE) {
+        const auto call = dynamic_cast<const FunctionCallNode*>(node.get());
+        if (strcmp(call->getFunctionName()->getName(), functionName) == 0) ++count;
+    }
+    const size_t childrenNumber = node->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        count += countCalls(node->getChildren()[i], functionName);
+    }
+    return count;
+}
+
+namespace {
+
+class CodePrinter {
+
+private:
+    std::map<std::string, std::string> printedNames;
+    std::map<std::string, size_t> generatedNamesNumber;
+
+public:
+    std::string printStatement(const std::shared_ptr<ASTNode>& node, size_t indent);
+
+private:
+    std::string printName(const char* name);
+    std::string printExpression(const std::shared_ptr<ASTNode>& node);
+    std::string printOperand(const std::shared_ptr<ASTNode>& operand, const OperatorToken* parent, bool isRightOperand);
+    std::string printList(const std::shared_ptr<ASTNode>& list);
+};
+
+std::string indentation(size_t indent) {
+    return std::string(indent * 4, ' ');
+}
+
+std::string CodePrinter::printName(const char* name) {
+    // Variables are renamed as "x.N", functions are renamed as "f_N"
+    const char* suffix = strrchr(name, '.');
+    if (suffix == nullptr) suffix = strrchr(name, '_');
+    if (suffix == nullptr || suffix[1] == '\0' || strspn(suffix + 1, "0123456789") != strlen(suffix + 1)) return name;
+
+    auto printed = printedNames.find(name);
+    if (printed == printedNames.end()) {
+        const std::string baseName(name, suffix + 1);
+        const size_t number = ++generatedNamesNumber[baseName];
+        printed = printedNames.emplace(name, baseName + std::to_string(number)).first;
+    }
+    return printed->second;
+}
+
+std::string CodePrinter::printList(const std::shared_ptr<ASTNode>& list) {
+    std::string code;
+    const size_t childrenNumber = list->getChildrenNumber();
+    for (size_t i = 0; i < childrenNumber; ++i) {
+        if (i != 0) code += ", ";
+        code += printExpression(list->getChildren()[i]);
+    }
+    return code;
+}
+
+std::string CodePrinter::printOperand(const std::shared_ptr<ASTNode>& operand, const OperatorToken* parent, bool isRightOperand) {
+    const std::string code = printExpression(operand);
+    if (operand->getType() == CONSTANT_VALUE_NODE) {
+        // Negative constant is told apart from the negation of the positive one
+        const bool isNegative = std::signbit(dynamic_cast<const ConstantValueNode*>(operand.get())->getValue());
+        return isNegative ? "(" + code + ")" : code;
+    }
+    if (operand->getType() != OPERATOR_NODE) return code;
+
+    const auto token = dynamic_cast<const OperatorNode*>(operand.get())->getToken();
+    if (token->getArity() == 1) return code;
+    if (parent->getArity() == 1 || token->getPrecedence() < parent->getPrecedence() ||
+        (isRightOperand && token->getPrecedence() == parent->getPrecedence())) {
+        return "(" + code + ")";
+    }
+    return code;
+}
+
+std::string CodePrinter::printExpression(const std::shared_ptr<ASTNode>& node) {
+    const auto children = node->getChildren();
+    switch (node->getType()) {
+        case CONSTANT_VALUE_NODE: {
+            char value[32];
+            snprintf(value, sizeof(value), "%lg", dynamic_cast<const ConstantValueNode*>(node.get())->getValue());
+            return value;
+        }
+        case VARIABLE_NODE:
+            return printName(dynamic_cast<const VariableNode*>(node.get())->getName());
+        case VALUE_NODE:
+            return printName(dynamic_cast<const ValueNode*>(node.get())->getName());
+        case OPERATOR_NODE: {
+            const auto& token = dynamic_cast<const OperatorNode*>(node.get())->getToken();
+            if (token->getArity() == 1) return token->getSymbol() + printOperand(children[0], token.get(), false);
+            return printOperand(children[0], token.get(), false) + " " + token->getSymbol() + " " +
+                   printOperand(children[1], token.get(), true);
+        }
+        case ASSIGNMENT_OPERATOR_NODE:
+            return printExpression(children[0]) + " = " + printExpression(children[1]);
+        case COMPARISON_OPERATOR_NODE: {
+            const auto& token = dynamic_cast<const ComparisonOperatorNode*>(node.get())->getToken();
+            return printExpression(children[0]) + " " + token->getSymbol() + " " + printExpression(children[1]);
+        }
+        case FUNCTION_CALL_NODE: {
+            const auto call = dynamic_cast<const FunctionCallNode*>(node.get());
+            return printName(call->getFunctionName()->getName()) + "(" + printList(children[0]) + ")";
+        }
+        default:
+            assert(!"Node is not an expression");
+            return "";
+    }
+}
+
+std::string CodePrinter::printStatement(const std::shared_ptr<ASTNode>& node, size_t indent) {
+    const auto children = node->getChildren();
+    switch (node->getType()) {
+        case STATEMENTS_NODE: {
+            std::string code;
+            for (size_t i = 0; i < node->getChildrenNumber(); ++i) {
+                if (i != 0) code += "\n" + indentation(indent);
+                code += printStatement(children[i], indent);
+            }
+            return code;
+        }
+        case BLOCK_NODE: {
+            std::string code = "{\n";
+            const auto& statements = children[0];
+            for (size_t i = 0; i < statements->getChildrenNumber(); ++i) {
+                code += indentation(indent + 1) + printStatement(statements->getChildren()[i], indent + 1) + "\n";
+            }
+            return code + indentation(indent) + "}";
+        }
+        case IF_NODE:
+            return "if (" + printExpression(children[0]) + ") " + printStatement(children[1], indent);
+        case IF_ELSE_NODE:
+            return "if (" + printExpression(children[0]) + ") " + printStatement(children[1], indent) + " else " +
+                   printStatement(children[2], indent);
+        case WHILE_NODE:
+            return "while (" + printExpression(children[0]) + ") " + printStatement(children[1], indent);
+        case VARIABLE_DECLARATION_NODE:
+            if (node->getChildrenNumber() == 1) return "var " + printExpression(children[0]) + ";";
+            return "var " + printExpression(children[0]) + " = " + printExpression(children[1]) + ";";
+        case VALUE_DECLARATION_NODE:
+            return "val " + printExpression(children[0]) + " = " + printExpression(children[1]) + ";";
+        case RETURN_STATEMENT_NODE:
+            return "return " + printExpression(children[0]) + ";";
+        case FUNCTION_DEFINITION_NODE: {
+            const auto function = dynamic_cast<const FunctionDefinitionNode*>(node.get());
+            return "func " + printName(function->getFunctionName()->getName()) + "(" + printList(children[0]) + ") " +
+                   printStatement(children[1], indent);
+        }
+        default:
+            return printExpression(node) + ";";
+    }
+}
+
+}
+
+std::string printCode(const std::shared_ptr<ASTNode>& node) {
+    return CodePrinter().printStatement(node, 0) + "\n";
+}
@@ -0,0 +1,110 @@
+/**
+ * @file
+ * @brief Helpers for the end-to-end tests: compilation of the program text and running it on the stack machine
+ *
+ * Programs are compiled the same way as the compiler executable does: AST is optimized by the pipeline of the given level
+ * (or by the given passes or optimizer), then IR is generated (memoizing pure functions, if it's enabled), registers are
+ * allocated and IR is optimized by the peephole optimizer (except -O0), written as bytecode and run with the given input.
+ * Output of the program is compared as the text, so any difference in the printed values is caught.
+ * Optimized AST can be checked by printing it back as the code.
+ */
+#ifndef TESTS_PROGRAM_RUNNER_H
+#define TESTS_PROGRAM_RUNNER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include "../src/backend/ir.h"
+#include "../src/frontend/ast.h"
+#include "../src/middleend/ast-optimizers.h"
+#include "../src/middleend/pass-pipeline.h"
+#include "../src/middleend/profile.h"
+
+struct CompilationOptions {
+    OptimizationLevel optimizationLevel = O0;
+    const char* passNames = nullptr; // Passes to run instead of the optimization level pipeline (see buildPipeline)
+    std::shared_ptr<Optimizer> optimizer = nullptr; // Optimizer to run instead of the pipeline, e.g. the pass with non-default options
+    bool memoize = false;
+    FloatingPointMode fpMode = FP_STRICT;
+    std::shared_ptr<const Profile> profile = nullptr; // Profile to choose memoized functions by, like '--profile-use'
+};
+
+CompilationOptions withoutOptimizations();
+CompilationOptions withLevel(OptimizationLevel level);
+CompilationOptions withPasses(const char* passNames);
+CompilationOptions withOptimizer(const std::shared_ptr<Optimizer>& optimizer);
+CompilationOptions withMemoization(CompilationOptions options);
+CompilationOptions withProfile(CompilationOptions options, const std::shared_ptr<const Profile>& profile);
+
+/**
+ * Parses the program and optimizes its AST.
+ */
+std::shared_ptr<ASTNode> optimizeProgram(const char* code, const CompilationOptions& options);
+
+/**
+ * Compiles the program to IR, that would be written as bytecode (frame accesses are already lowered).
+ */
+IRProgram compileProgram(const char* code, const CompilationOptions& options);
+
+/**
+ * Runs the action in the child process with the given standard input.
+ * @return everything the action wrote to the standard output, followed by "exit code N" line, if it's not 0.
+ */
+std::string runWithInput(const std::function<int()>& action, const char* input);
+
+/**
+ * Compiles the program and runs it on the stack machine.
+ * @return output of the program (see runWithInput).
+ */
+std::string compileAndRun(const char* code, const char* input, const CompilationOptions& options);
+
+/**
+ * Counts the instructions of IR with the given opcode.
+ */
+size_t countInstructions(const IRProgram& program, IROpcode opcode);
+
+/**
+ * Counts the instructions of IR with the given opcode and register.
+ */
+size_t countInstructions(const IRProgram& program, IROpcode opcode, Register reg);
+
+/**
+ * Counts the AST nodes of the given type.
+ */
+size_t countNodes(const std::shared_ptr<ASTNode>& node, NodeType type);
+
+/**
+ * Finds the first AST node of the given type (in the order of the depth-first traversal).
+ * @return node or nullptr, if there is no such node.
+ */
+std::shared_ptr<ASTNode> findNode(const std::shared_ptr<ASTNode>& node, NodeType type);
+
+/**
+ * Finds definition of the function with the given name.
+ * @return node or nullptr, if there is no such function.
+ */
+std::shared_ptr<ASTNode> findFunction(const std::shared_ptr<ASTNode>& root, const char* functionName);
+
+/**
+ * Counts calls of the function with the given name in the AST.
+ */
+size_t countCalls(const std::shared_ptr<ASTNode>& node, const char* functionName);
+
+/**
+ * Prints AST back as the code: one statement per line, nested statements are indented by 4 spaces,
+ * operators are parenthesized only when it's needed (negative constant operands are always parenthesized).
+ * Unique suffixes of the generated names (like "x.42" or "f_42") are replaced by their order in the printed code
+ * ("x.1" or "f_1"), so the result doesn't depend on other tests.
+ */
+std::string printCode(const std::shared_ptr<ASTNode>& node);
+
+/**
+ * Asserts if the program prints the same with the given options, as without optimizations, and the output is the expected one.
+ */
+#define ASSERT_SAME_OUTPUT(code, input, options, expectedOutput) do {                                                  \
+    const std::string referenceOutput = compileAndRun(code, input, withoutOptimizations());                            \
+    ASSERT_EQUALS(referenceOutput, std::string(expectedOutput));                                                       \
+    ASSERT_EQUALS(compileAndRun(code, input, options), referenceOutput);                                               \
+} while (0)
+
+#endif // TESTS_PROGRAM_RUNNER_H